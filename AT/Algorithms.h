@@ -0,0 +1,706 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Assertion.h>
+#include <AT/MemoryOperations.h>
+#include <AT/Span.h>
+#include <AT/Types.h>
+
+namespace AT {
+
+//
+// The comparison function used by the algorithms when none is explicitly provided.
+// Any user-provided comparison function must implement a strict weak ordering, exactly as this one does.
+//
+template<typename T>
+struct DefaultLessThan {
+    NODISCARD ALWAYS_INLINE constexpr bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+namespace Detail {
+
+// NOTE: Ranges smaller than this threshold are sorted using insertion sort.
+constexpr usize sort_insertion_threshold = 24;
+// NOTE: Ranges bigger than this threshold use the pseudomedian of nine as the pivot, instead of the median of three.
+constexpr usize sort_ninther_threshold = 128;
+// NOTE: The maximum number of element moves that a partial insertion sort is allowed to perform before giving up.
+constexpr usize sort_partial_insertion_limit = 8;
+// NOTE: Ranges smaller than this threshold are sorted using insertion sort by the stable merge sort.
+constexpr usize stable_sort_insertion_threshold = 32;
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void insertion_sort(T* begin, T* end, LessThanFunction& less_than)
+{
+    if (begin == end) {
+        return;
+    }
+
+    for (T* current = begin + 1; current != end; ++current) {
+        T* sift = current;
+        T* sift_previous = current - 1;
+
+        if (less_than(*sift, *sift_previous)) {
+            T temporary = move(*sift);
+            do {
+                *sift-- = move(*sift_previous);
+            } while (sift != begin && less_than(temporary, *--sift_previous));
+            *sift = move(temporary);
+        }
+    }
+}
+
+//
+// Same as insertion_sort(), but it assumes that the element that is located right before 'begin' is less
+// than or equal to all elements in the range. This removes the bound check from the inner loop.
+//
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void unguarded_insertion_sort(T* begin, T* end, LessThanFunction& less_than)
+{
+    if (begin == end) {
+        return;
+    }
+
+    for (T* current = begin + 1; current != end; ++current) {
+        T* sift = current;
+        T* sift_previous = current - 1;
+
+        if (less_than(*sift, *sift_previous)) {
+            T temporary = move(*sift);
+            do {
+                *sift-- = move(*sift_previous);
+            } while (less_than(temporary, *--sift_previous));
+            *sift = move(temporary);
+        }
+    }
+}
+
+//
+// Attempts to sort the range using insertion sort, but gives up if more than 'sort_partial_insertion_limit'
+// elements have to be moved. Returns true only if the range is now sorted.
+//
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE bool partial_insertion_sort(T* begin, T* end, LessThanFunction& less_than)
+{
+    if (begin == end) {
+        return true;
+    }
+
+    usize moved_element_count = 0;
+    for (T* current = begin + 1; current != end; ++current) {
+        T* sift = current;
+        T* sift_previous = current - 1;
+
+        if (less_than(*sift, *sift_previous)) {
+            T temporary = move(*sift);
+            do {
+                *sift-- = move(*sift_previous);
+            } while (sift != begin && less_than(temporary, *--sift_previous));
+            *sift = move(temporary);
+            moved_element_count += static_cast<usize>(current - sift);
+        }
+
+        if (moved_element_count > sort_partial_insertion_limit) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void sort_two(T* a, T* b, LessThanFunction& less_than)
+{
+    if (less_than(*b, *a)) {
+        swap(*a, *b);
+    }
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void sort_three(T* a, T* b, T* c, LessThanFunction& less_than)
+{
+    sort_two(a, b, less_than);
+    sort_two(b, c, less_than);
+    sort_two(a, b, less_than);
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void heap_sift_down(T* elements, usize root_index, usize count, LessThanFunction& less_than)
+{
+    T root = move(elements[root_index]);
+    while (true) {
+        usize child_index = 2 * root_index + 1;
+        if (child_index >= count) {
+            break;
+        }
+        if (child_index + 1 < count && less_than(elements[child_index], elements[child_index + 1])) {
+            ++child_index;
+        }
+        if (!less_than(root, elements[child_index])) {
+            break;
+        }
+
+        elements[root_index] = move(elements[child_index]);
+        root_index = child_index;
+    }
+    elements[root_index] = move(root);
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void make_heap(T* elements, usize count, LessThanFunction& less_than)
+{
+    for (usize index = count / 2; index > 0; --index) {
+        heap_sift_down(elements, index - 1, count, less_than);
+    }
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void sort_heap(T* elements, usize count, LessThanFunction& less_than)
+{
+    for (usize heap_count = count; heap_count > 1; --heap_count) {
+        swap(elements[0], elements[heap_count - 1]);
+        heap_sift_down(elements, 0, heap_count - 1, less_than);
+    }
+}
+
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void heap_sort(T* begin, T* end, LessThanFunction& less_than)
+{
+    const usize count = static_cast<usize>(end - begin);
+    make_heap(begin, count, less_than);
+    sort_heap(begin, count, less_than);
+}
+
+//
+// Partitions the range around the pivot located at 'begin'. Elements equal to the pivot end up in the right partition.
+// Returns the final position of the pivot and whether or not the range was already partitioned.
+// Requires that the range contains an element that is not less than the pivot, which is guaranteed by the median selection.
+//
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE T* partition_right(T* begin, T* end, LessThanFunction& less_than, bool& out_was_already_partitioned)
+{
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    // Find the first element that is not less than the pivot.
+    while (less_than(*++first, pivot)) {}
+
+    // Find the last element that is less than the pivot. If no element has been moved over by the previous loop
+    // there is no guarantee that such an element exists, so the bound must be explicitly checked.
+    if (first - 1 == begin) {
+        while (first < last && !less_than(*--last, pivot)) {}
+    }
+    else {
+        while (!less_than(*--last, pivot)) {}
+    }
+
+    out_was_already_partitioned = (first >= last);
+
+    while (first < last) {
+        swap(*first, *last);
+        while (less_than(*++first, pivot)) {}
+        while (!less_than(*--last, pivot)) {}
+    }
+
+    T* pivot_position = first - 1;
+    *begin = move(*pivot_position);
+    *pivot_position = move(pivot);
+    return pivot_position;
+}
+
+//
+// Partitions the range around the pivot located at 'begin'. Elements equal to the pivot end up in the left partition.
+// Used when the pivot is known to be equal to an element located before the range, which means that all elements equal
+// to the pivot are already in their final position and don't have to be sorted again.
+//
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE T* partition_left(T* begin, T* end, LessThanFunction& less_than)
+{
+    T pivot = move(*begin);
+    T* first = begin;
+    T* last = end;
+
+    while (less_than(pivot, *--last)) {}
+
+    if (last + 1 == end) {
+        while (first < last && !less_than(pivot, *++first)) {}
+    }
+    else {
+        while (!less_than(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        swap(*first, *last);
+        while (less_than(pivot, *--last)) {}
+        while (!less_than(pivot, *++first)) {}
+    }
+
+    T* pivot_position = last;
+    *begin = move(*pivot_position);
+    *pivot_position = move(pivot);
+    return pivot_position;
+}
+
+//
+// Moves the median of the range to 'begin', in order to be used as a pivot by the partitioning functions.
+// The element located at 'end - 1' is guaranteed to not be less than the pivot.
+//
+template<typename T, typename LessThanFunction>
+ALWAYS_INLINE void select_pivot(T* begin, T* end, LessThanFunction& less_than)
+{
+    const usize count = static_cast<usize>(end - begin);
+    const usize half_count = count / 2;
+
+    if (count > sort_ninther_threshold) {
+        sort_three(begin, begin + half_count, end - 1, less_than);
+        sort_three(begin + 1, begin + (half_count - 1), end - 2, less_than);
+        sort_three(begin + 2, begin + (half_count + 1), end - 3, less_than);
+        sort_three(begin + (half_count - 1), begin + half_count, begin + (half_count + 1), less_than);
+        swap(*begin, *(begin + half_count));
+    }
+    else {
+        sort_three(begin + half_count, begin, end - 1, less_than);
+    }
+}
+
+//
+// Implementation of the pattern-defeating quicksort algorithm, as described by Orson Peters.
+// https://arxiv.org/abs/2106.05123
+//
+template<typename T, typename LessThanFunction>
+void pattern_defeating_quick_sort(T* begin, T* end, LessThanFunction& less_than, usize bad_partitions_allowed, bool is_leftmost)
+{
+    while (true) {
+        const usize count = static_cast<usize>(end - begin);
+        if (count < sort_insertion_threshold) {
+            if (is_leftmost) {
+                insertion_sort(begin, end, less_than);
+            }
+            else {
+                unguarded_insertion_sort(begin, end, less_than);
+            }
+            return;
+        }
+
+        select_pivot(begin, end, less_than);
+
+        // If the pivot is equal to the element located right before the range (which is the pivot of a previous
+        // partitioning step), all elements equal to it can be skipped. This makes the algorithm linear on inputs
+        // that contain many duplicates.
+        if (!is_leftmost && !less_than(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, less_than) + 1;
+            continue;
+        }
+
+        bool was_already_partitioned;
+        T* pivot_position = partition_right(begin, end, less_than, was_already_partitioned);
+
+        const usize left_count = static_cast<usize>(pivot_position - begin);
+        const usize right_count = static_cast<usize>(end - (pivot_position + 1));
+
+        if (left_count < count / 8 || right_count < count / 8) {
+            // The partition is highly unbalanced. If too many bad partitions happened, switch to heap sort in order
+            // to guarantee O(n log n) worst-case complexity.
+            if (--bad_partitions_allowed == 0) {
+                heap_sort(begin, end, less_than);
+                return;
+            }
+
+            // Break the patterns that might have caused the bad partition by shuffling some elements around.
+            if (left_count >= sort_insertion_threshold) {
+                swap(*begin, *(begin + left_count / 4));
+                swap(*(pivot_position - 1), *(pivot_position - left_count / 4));
+
+                if (left_count > sort_ninther_threshold) {
+                    swap(*(begin + 1), *(begin + (left_count / 4 + 1)));
+                    swap(*(begin + 2), *(begin + (left_count / 4 + 2)));
+                    swap(*(pivot_position - 2), *(pivot_position - (left_count / 4 + 1)));
+                    swap(*(pivot_position - 3), *(pivot_position - (left_count / 4 + 2)));
+                }
+            }
+
+            if (right_count >= sort_insertion_threshold) {
+                swap(*(pivot_position + 1), *(pivot_position + (1 + right_count / 4)));
+                swap(*(end - 1), *(end - right_count / 4));
+
+                if (right_count > sort_ninther_threshold) {
+                    swap(*(pivot_position + 2), *(pivot_position + (2 + right_count / 4)));
+                    swap(*(pivot_position + 3), *(pivot_position + (3 + right_count / 4)));
+                    swap(*(end - 2), *(end - (1 + right_count / 4)));
+                    swap(*(end - 3), *(end - (2 + right_count / 4)));
+                }
+            }
+        }
+        else if (was_already_partitioned) {
+            // The range might already be sorted, so try to finish it using insertion sort.
+            if (partial_insertion_sort(begin, pivot_position, less_than) && partial_insertion_sort(pivot_position + 1, end, less_than)) {
+                return;
+            }
+        }
+
+        // Recurse into the left partition and iterate over the right one.
+        pattern_defeating_quick_sort(begin, pivot_position, less_than, bad_partitions_allowed, is_leftmost);
+        begin = pivot_position + 1;
+        is_leftmost = false;
+    }
+}
+
+template<typename T, typename LessThanFunction>
+void merge_sort(T* begin, T* end, T* buffer, LessThanFunction& less_than)
+{
+    const usize count = static_cast<usize>(end - begin);
+    if (count <= stable_sort_insertion_threshold) {
+        // NOTE: The insertion sort is stable, as elements are only moved over strictly greater ones.
+        insertion_sort(begin, end, less_than);
+        return;
+    }
+
+    T* middle = begin + count / 2;
+    merge_sort(begin, middle, buffer, less_than);
+    merge_sort(middle, end, buffer, less_than);
+
+    if (!less_than(*middle, *(middle - 1))) {
+        // The two halves are already in order, so no merging is required.
+        return;
+    }
+
+    // Move the left half into the buffer and merge it with the right half directly into the range.
+    const usize left_count = static_cast<usize>(middle - begin);
+    for (usize index = 0; index < left_count; ++index) {
+        new (buffer + index) T(move(begin[index]));
+    }
+
+    T* left = buffer;
+    T* left_end = buffer + left_count;
+    T* right = middle;
+    T* destination = begin;
+
+    while (left != left_end && right != end) {
+        // NOTE: On equality the element from the left half is taken first, which guarantees stability.
+        if (less_than(*right, *left)) {
+            *destination++ = move(*right++);
+        }
+        else {
+            *destination++ = move(*left++);
+        }
+    }
+
+    while (left != left_end) {
+        *destination++ = move(*left++);
+    }
+
+    for (usize index = 0; index < left_count; ++index) {
+        buffer[index].~T();
+    }
+}
+
+template<typename T, typename LessThanFunction>
+void introselect(T* begin, T* end, T* nth, LessThanFunction& less_than)
+{
+    usize bad_partitions_allowed = 0;
+    for (usize count = static_cast<usize>(end - begin); count > 1; count /= 2) {
+        ++bad_partitions_allowed;
+    }
+    bad_partitions_allowed *= 2;
+
+    while (static_cast<usize>(end - begin) >= sort_insertion_threshold) {
+        if (bad_partitions_allowed-- == 0) {
+            // Too many unbalanced partitions occurred. Fallback to heap selection in order to guarantee
+            // O(n log n) worst-case complexity.
+            const usize count = static_cast<usize>(end - begin);
+            const usize selected_count = static_cast<usize>(nth - begin) + 1;
+            make_heap(begin, selected_count, less_than);
+            for (usize index = selected_count; index < count; ++index) {
+                if (less_than(begin[index], begin[0])) {
+                    swap(begin[index], begin[0]);
+                    heap_sift_down(begin, 0, selected_count, less_than);
+                }
+            }
+            // The root of the max-heap is the nth element.
+            swap(begin[0], *nth);
+            return;
+        }
+
+        select_pivot(begin, end, less_than);
+        bool was_already_partitioned;
+        T* pivot_position = partition_right(begin, end, less_than, was_already_partitioned);
+
+        if (pivot_position == nth) {
+            return;
+        }
+        if (nth < pivot_position) {
+            end = pivot_position;
+        }
+        else {
+            begin = pivot_position + 1;
+        }
+    }
+
+    insertion_sort(begin, end, less_than);
+}
+
+template<typename T>
+NODISCARD ALWAYS_INLINE T* allocate_algorithm_buffer(usize count)
+{
+    void* memory_block = ::operator new(count * sizeof(T));
+    AT_ASSERT(memory_block);
+    return static_cast<T*>(memory_block);
+}
+
+template<typename T>
+ALWAYS_INLINE void release_algorithm_buffer(T* buffer, usize count)
+{
+    // NOTE: The standard operator delete doesn't need the size of the memory block.
+    //       However, in future implementations we might switch to a custom memory allocator,
+    //       so having this crucial information available out-of-the-box is really handy.
+    (void)count;
+    ::operator delete(buffer);
+}
+
+template<typename KeyType>
+NODISCARD ALWAYS_INLINE constexpr auto radix_key_as_unsigned(KeyType key)
+{
+    if constexpr (is_signed_integral<KeyType>) {
+        // NOTE: Flipping the sign bit maps the signed range onto the unsigned range while preserving the ordering.
+        using UnsignedKeyType = std::make_unsigned_t<KeyType>;
+        constexpr UnsignedKeyType sign_bit = static_cast<UnsignedKeyType>(1) << (8 * sizeof(KeyType) - 1);
+        return static_cast<UnsignedKeyType>(static_cast<UnsignedKeyType>(key) ^ sign_bit);
+    }
+    else {
+        return key;
+    }
+}
+
+} // namespace Detail
+
+//
+// Sorts the elements of the span, using the pattern-defeating quicksort algorithm.
+// The sort is not stable and is performed in-place. The complexity is O(n log n) in the worst case, while sorted,
+// reverse sorted or inputs that contain many duplicates are sorted in linear time.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<T>>
+ALWAYS_INLINE void sort(Span<T> span, LessThanFunction less_than = {})
+{
+    if (span.count() < 2) {
+        return;
+    }
+
+    usize bad_partitions_allowed = 0;
+    for (usize count = span.count(); count > 1; count /= 2) {
+        ++bad_partitions_allowed;
+    }
+
+    Detail::pattern_defeating_quick_sort(span.elements(), span.elements() + span.count(), less_than, bad_partitions_allowed, true);
+}
+
+//
+// Sorts the elements of the span, preserving the relative order of the elements that are equal, using merge sort.
+// A temporary buffer that can store half of the elements is allocated from the heap.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<T>>
+ALWAYS_INLINE void stable_sort(Span<T> span, LessThanFunction less_than = {})
+{
+    if (span.count() <= Detail::stable_sort_insertion_threshold) {
+        Detail::insertion_sort(span.elements(), span.elements() + span.count(), less_than);
+        return;
+    }
+
+    const usize buffer_count = span.count() / 2;
+    T* buffer = Detail::allocate_algorithm_buffer<T>(buffer_count);
+    Detail::merge_sort(span.elements(), span.elements() + span.count(), buffer, less_than);
+    Detail::release_algorithm_buffer(buffer, buffer_count);
+}
+
+//
+// Sorts the elements of the span using the LSD radix sort algorithm, by the integral key returned by the given function.
+// The sort is stable and requires O(n) extra memory, which is allocated from the heap. Digits (bytes) that are
+// identical for all keys are detected upfront and their passes are skipped.
+// The elements must be trivially copyable, as they are copied between the span and the buffer without being constructed.
+//
+template<typename T, typename KeyFunction>
+void radix_sort_by_key(Span<T> span, KeyFunction key_of)
+{
+    using KeyType = RemoveConst<RemoveReference<decltype(key_of(span.first()))>>;
+    static_assert(is_integral<KeyType>, "The radix sort key must be an integral type!");
+    static_assert(std::is_trivially_copyable_v<T>, "The radix sort can only be used with trivially copyable types!");
+
+    constexpr usize digit_count = sizeof(KeyType);
+    constexpr usize bucket_count = 256;
+
+    const usize count = span.count();
+    if (count < 2) {
+        return;
+    }
+
+    // Compute the histograms of all digits in a single pass.
+    usize histograms[digit_count][bucket_count] = {};
+    for (usize index = 0; index < count; ++index) {
+        const auto key = Detail::radix_key_as_unsigned(key_of(span.elements()[index]));
+        for (usize digit_index = 0; digit_index < digit_count; ++digit_index) {
+            ++histograms[digit_index][(key >> (8 * digit_index)) & 0xFF];
+        }
+    }
+
+    T* buffer = Detail::allocate_algorithm_buffer<T>(count);
+    T* source = span.elements();
+    T* destination = buffer;
+
+    for (usize digit_index = 0; digit_index < digit_count; ++digit_index) {
+        usize* histogram = histograms[digit_index];
+
+        const auto first_key = Detail::radix_key_as_unsigned(key_of(source[0]));
+        if (histogram[(first_key >> (8 * digit_index)) & 0xFF] == count) {
+            // All keys share the same digit, so this pass wouldn't change the order of the elements.
+            continue;
+        }
+
+        // Transform the histogram into the offsets of each bucket.
+        usize offset = 0;
+        for (usize bucket_index = 0; bucket_index < bucket_count; ++bucket_index) {
+            const usize bucket_size = histogram[bucket_index];
+            histogram[bucket_index] = offset;
+            offset += bucket_size;
+        }
+
+        for (usize index = 0; index < count; ++index) {
+            const auto key = Detail::radix_key_as_unsigned(key_of(source[index]));
+            destination[histogram[(key >> (8 * digit_index)) & 0xFF]++] = source[index];
+        }
+
+        swap(source, destination);
+    }
+
+    if (source != span.elements()) {
+        for (usize index = 0; index < count; ++index) {
+            span.elements()[index] = source[index];
+        }
+    }
+
+    Detail::release_algorithm_buffer(buffer, count);
+}
+
+//
+// Sorts the integers of the span using the LSD radix sort algorithm.
+//
+template<typename T>
+requires (is_integral<T>)
+ALWAYS_INLINE void radix_sort(Span<T> span)
+{
+    radix_sort_by_key(span, [](T value) { return value; });
+}
+
+//
+// Rearranges the elements of the span such that the first 'sorted_count' elements are the smallest ones in the range,
+// sorted in ascending order. The order of the remaining elements is unspecified.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<T>>
+void partial_sort(Span<T> span, usize sorted_count, LessThanFunction less_than = {})
+{
+    AT_ASSERT(sorted_count <= span.count());
+    if (sorted_count == 0) {
+        return;
+    }
+
+    T* elements = span.elements();
+    Detail::make_heap(elements, sorted_count, less_than);
+
+    for (usize index = sorted_count; index < span.count(); ++index) {
+        if (less_than(elements[index], elements[0])) {
+            swap(elements[index], elements[0]);
+            Detail::heap_sift_down(elements, 0, sorted_count, less_than);
+        }
+    }
+
+    Detail::sort_heap(elements, sorted_count, less_than);
+}
+
+//
+// Rearranges the elements of the span such that the element at 'nth_index' is the element that would be in that
+// position if the whole span was sorted. All elements before it are less than or equal to it and all elements
+// after it are greater than or equal to it. The average complexity is O(n).
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<T>>
+ALWAYS_INLINE void nth_element(Span<T> span, usize nth_index, LessThanFunction less_than = {})
+{
+    AT_ASSERT(nth_index < span.count());
+    Detail::introselect(span.elements(), span.elements() + span.count(), span.elements() + nth_index, less_than);
+}
+
+//
+// Returns the index of the first element in the sorted span that is not less than the given value.
+// If no such element exists, the number of elements in the span is returned.
+// The search is branchless, as the loop has a trip count that only depends on the number of elements and the
+// conditional step compiles to a conditional move. This avoids the branch mispredictions of the classic binary search.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<RemoveConst<T>>>
+NODISCARD ALWAYS_INLINE usize lower_bound(Span<T> span, const RemoveConst<T>& value, LessThanFunction less_than = {})
+{
+    const T* base = span.elements();
+    usize count = span.count();
+    if (count == 0) {
+        return 0;
+    }
+
+    while (count > 1) {
+        const usize half_count = count / 2;
+        base = less_than(base[half_count], value) ? base + half_count : base;
+        count -= half_count;
+    }
+
+    return static_cast<usize>(base - span.elements()) + less_than(*base, value);
+}
+
+//
+// Returns the index of the first element in the sorted span that is greater than the given value.
+// If no such element exists, the number of elements in the span is returned.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<RemoveConst<T>>>
+NODISCARD ALWAYS_INLINE usize upper_bound(Span<T> span, const RemoveConst<T>& value, LessThanFunction less_than = {})
+{
+    const T* base = span.elements();
+    usize count = span.count();
+    if (count == 0) {
+        return 0;
+    }
+
+    while (count > 1) {
+        const usize half_count = count / 2;
+        base = !less_than(value, base[half_count]) ? base + half_count : base;
+        count -= half_count;
+    }
+
+    return static_cast<usize>(base - span.elements()) + !less_than(value, *base);
+}
+
+//
+// Returns the index of an element in the sorted span that is equal to the given value, or 'invalid_size' if
+// no such element exists.
+//
+template<typename T, typename LessThanFunction = DefaultLessThan<RemoveConst<T>>>
+NODISCARD ALWAYS_INLINE usize binary_search(Span<T> span, const RemoveConst<T>& value, LessThanFunction less_than = {})
+{
+    const usize index = lower_bound(span, value, less_than);
+    if (index == span.count() || less_than(value, span.elements()[index])) {
+        return invalid_size;
+    }
+    return index;
+}
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::binary_search;
+using AT::DefaultLessThan;
+using AT::lower_bound;
+using AT::nth_element;
+using AT::partial_sort;
+using AT::radix_sort;
+using AT::radix_sort_by_key;
+using AT::sort;
+using AT::stable_sort;
+using AT::upper_bound;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/Ascii.h>
+
+#if AT_ARCH_X86_64
+    #include <immintrin.h>
+#endif // AT_ARCH_X86_64
+
+namespace AT {
+
+//
+// The case mapping is vectorized using SSE2, which is always available on x86-64. A byte is a letter of the given case
+// if it is in the range [first_letter, first_letter + 25], which is checked using a single signed comparison: the
+// byte is offset such that the first letter becomes the smallest signed value (-128), so the bytes in the range are
+// exactly the ones smaller than -128 + 26. The case is then changed by flipping the 0x20 bit of the matching bytes.
+// Strings shorter than a block are mapped using the scalar loop. Otherwise, the last (partial) block is mapped by
+// loading the last 16 bytes of the string, which overlap already mapped bytes. Mapping a byte twice is harmless,
+// as letters that already have the target case are not matched again.
+//
+
+#if AT_ARCH_X86_64
+
+NODISCARD ALWAYS_INLINE static __m128i flip_case_of_letters(__m128i block, char first_letter)
+{
+    const __m128i offset_block = _mm_add_epi8(block, _mm_set1_epi8(static_cast<char>(-128 - first_letter)));
+    const __m128i is_letter = _mm_cmplt_epi8(offset_block, _mm_set1_epi8(-128 + 26));
+    return _mm_xor_si128(block, _mm_and_si128(is_letter, _mm_set1_epi8(0x20)));
+}
+
+#endif // AT_ARCH_X86_64
+
+// Flips the case of every letter in the range [first_letter, first_letter + 25].
+static void flip_case_of_letters(ReadonlyByteSpan source, WriteonlyByteSpan destination, char first_letter)
+{
+    const usize byte_count = source.count();
+    AT_ASSERT(destination.count() >= byte_count);
+    const ReadonlyBytes source_bytes = source.elements();
+    const WriteonlyBytes destination_bytes = destination.elements();
+
+    usize offset = 0;
+#if AT_ARCH_X86_64
+    if (byte_count >= 16) {
+        for (; offset + 16 <= byte_count; offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source_bytes + offset));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination_bytes + offset), flip_case_of_letters(block, first_letter));
+        }
+
+        if (offset < byte_count) {
+            // NOTE: When the conversion is done in place, the overlapping bytes were already mapped, which is harmless.
+            //       Otherwise, the source bytes are mapped again, producing the same result.
+            const usize block_offset = byte_count - 16;
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source_bytes + block_offset));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination_bytes + block_offset), flip_case_of_letters(block, first_letter));
+        }
+        return;
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        const u8 byte = source_bytes[offset];
+        const bool is_letter = static_cast<u8>(byte - first_letter) < 26;
+        destination_bytes[offset] = is_letter ? static_cast<u8>(byte ^ 0x20) : byte;
+    }
+}
+
+void ASCII::to_lowercase(ReadonlyByteSpan source, WriteonlyByteSpan destination)
+{
+    flip_case_of_letters(source, destination, 'A');
+}
+
+void ASCII::to_uppercase(ReadonlyByteSpan source, WriteonlyByteSpan destination)
+{
+    flip_case_of_letters(source, destination, 'a');
+}
+
+bool ASCII::equals_ignoring_case(ReadonlyByteSpan lhs, ReadonlyByteSpan rhs)
+{
+    if (lhs.count() != rhs.count()) {
+        return false;
+    }
+
+    const usize byte_count = lhs.count();
+    usize offset = 0;
+#if AT_ARCH_X86_64
+    // NOTE: Both blocks are converted to lowercase before being compared, so the comparison is exact.
+    for (; offset + 16 <= byte_count; offset += 16) {
+        const __m128i lhs_block = flip_case_of_letters(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs.elements() + offset)), 'A');
+        const __m128i rhs_block = flip_case_of_letters(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs.elements() + offset)), 'A');
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        if (to_lowercase(static_cast<char>(lhs[offset])) != to_lowercase(static_cast<char>(rhs[offset]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace AT
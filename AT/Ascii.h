@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Span.h>
+
+namespace AT {
+
+//
+// Case mapping and comparison functions that only consider the ASCII letters. Every other byte (including the bytes
+// of multibyte UTF-8 sequences, which are never ASCII) is left untouched, so the functions are safe to use on UTF-8.
+//
+class ASCII {
+public:
+    NODISCARD ALWAYS_INLINE static constexpr bool is_uppercase(char character) { return 'A' <= character && character <= 'Z'; }
+    NODISCARD ALWAYS_INLINE static constexpr bool is_lowercase(char character) { return 'a' <= character && character <= 'z'; }
+
+    NODISCARD ALWAYS_INLINE static constexpr char to_lowercase(char character)
+    {
+        return is_uppercase(character) ? static_cast<char>(character | 0x20) : character;
+    }
+
+    NODISCARD ALWAYS_INLINE static constexpr char to_uppercase(char character)
+    {
+        return is_lowercase(character) ? static_cast<char>(character & ~0x20) : character;
+    }
+
+public:
+    //
+    // Writes the bytes of the source, with the ASCII letters converted to lowercase (or uppercase), to the destination.
+    // The destination must be at least as big as the source. The two buffers can be the same, so the conversion can be
+    // done in place, but they must not partially overlap.
+    //
+    AT_API static void to_lowercase(ReadonlyByteSpan source, WriteonlyByteSpan destination);
+    AT_API static void to_uppercase(ReadonlyByteSpan source, WriteonlyByteSpan destination);
+
+    // Checks if the two byte sequences are equal, considering that an uppercase ASCII letter is equal to its lowercase.
+    NODISCARD AT_API static bool equals_ignoring_case(ReadonlyByteSpan lhs, ReadonlyByteSpan rhs);
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::ASCII;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,996 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Algorithms.h>
+#include <AT/Assertion.h>
+#include <AT/MemoryOperations.h>
+#include <AT/Optional.h>
+#include <AT/Span.h>
+#include <AT/Types.h>
+#include <AT/Vector.h>
+
+#if AT_ARCH_X86_64
+    #include <emmintrin.h>
+#endif // AT_ARCH_X86_64
+
+namespace AT {
+
+namespace Detail {
+
+#if AT_ARCH_X86_64
+
+// NOTE: SSE2 is part of the x86-64 baseline, so these functions don't require any runtime dispatching.
+//       The keys are compared as signed integers, so for unsigned keys the sign bit must be flipped beforehand.
+NODISCARD ALWAYS_INLINE usize btree_count_less_than_32(const u32* keys, usize key_count, u32 key, u32 sign_flip)
+{
+    const __m128i flip = _mm_set1_epi32(static_cast<int>(sign_flip));
+    const __m128i needle = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(key)), flip);
+    __m128i counters = _mm_setzero_si128();
+
+    usize index = 0;
+    for (; index + 4 <= key_count; index += 4) {
+        const __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + index)), flip);
+        // Each lane of the mask is either 0 or -1, so subtracting it increments the lane counter.
+        counters = _mm_sub_epi32(counters, _mm_cmplt_epi32(block, needle));
+    }
+
+    counters = _mm_add_epi32(counters, _mm_shuffle_epi32(counters, 0x4E));
+    counters = _mm_add_epi32(counters, _mm_shuffle_epi32(counters, 0xB1));
+    usize count = static_cast<usize>(_mm_cvtsi128_si32(counters));
+
+    for (; index < key_count; ++index) {
+        count += (static_cast<i32>(keys[index] ^ sign_flip) < static_cast<i32>(key ^ sign_flip)) ? 1 : 0;
+    }
+    return count;
+}
+
+NODISCARD ALWAYS_INLINE usize btree_count_less_than_64(const u64* keys, usize key_count, u64 key, u64 sign_flip)
+{
+    // NOTE: SSE2 has no 64-bit comparison instruction, so it is emulated using 32-bit comparisons. The high halves are
+    //       compared as signed integers and the low halves as unsigned integers (by flipping their sign bits).
+    const __m128i flip = _mm_set_epi32(static_cast<int>(sign_flip >> 32), 0, static_cast<int>(sign_flip >> 32), 0);
+    const __m128i low_flip = _mm_set_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000));
+    const __m128i needle = _mm_xor_si128(_mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(key)), flip), low_flip);
+    __m128i counters = _mm_setzero_si128();
+
+    usize index = 0;
+    for (; index + 2 <= key_count; index += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + index));
+        block = _mm_xor_si128(_mm_xor_si128(block, flip), low_flip);
+
+        const __m128i greater = _mm_cmpgt_epi32(needle, block);
+        const __m128i equal = _mm_cmpeq_epi32(needle, block);
+        // The high lane holds the comparison result of the high halves, combined with the result of the low halves.
+        const __m128i less = _mm_or_si128(greater, _mm_and_si128(equal, _mm_slli_epi64(greater, 32)));
+        // Broadcast the high 32-bit lane result to the whole 64-bit lane.
+        counters = _mm_sub_epi64(counters, _mm_shuffle_epi32(less, 0xF5));
+    }
+
+    counters = _mm_add_epi64(counters, _mm_unpackhi_epi64(counters, counters));
+    usize count = static_cast<usize>(_mm_cvtsi128_si64(counters));
+
+    for (; index < key_count; ++index) {
+        count += (static_cast<i64>(keys[index] ^ sign_flip) < static_cast<i64>(key ^ sign_flip)) ? 1 : 0;
+    }
+    return count;
+}
+
+#endif // AT_ARCH_X86_64
+
+//
+// Computes the number of keys in the (sorted) node that are less than the given key, which is equivalent to the
+// index of the lower bound. For 32-bit and 64-bit integral keys all node keys are compared at once using SIMD
+// instructions, as a linear scan of a few cache lines is faster than a binary search with unpredictable branches.
+//
+template<typename KeyType>
+NODISCARD ALWAYS_INLINE usize btree_count_less_than(const KeyType* keys, usize key_count, const KeyType& key)
+{
+    if constexpr (is_integral<KeyType>) {
+#if AT_ARCH_X86_64
+        if constexpr (sizeof(KeyType) == sizeof(u32)) {
+            constexpr u32 sign_flip = is_unsigned_integral<KeyType> ? 0x80000000 : 0;
+            return btree_count_less_than_32(reinterpret_cast<const u32*>(keys), key_count, static_cast<u32>(key), sign_flip);
+        }
+        if constexpr (sizeof(KeyType) == sizeof(u64)) {
+            constexpr u64 sign_flip = is_unsigned_integral<KeyType> ? 0x8000000000000000 : 0;
+            return btree_count_less_than_64(reinterpret_cast<const u64*>(keys), key_count, static_cast<u64>(key), sign_flip);
+        }
+#endif // AT_ARCH_X86_64
+
+        // NOTE: This loop has no data-dependent branches, so it can be easily vectorized by the compiler.
+        usize count = 0;
+        for (usize index = 0; index < key_count; ++index) {
+            count += (keys[index] < key) ? 1 : 0;
+        }
+        return count;
+    }
+    else {
+        return AT::lower_bound(Span<const KeyType>(keys, key_count), key);
+    }
+}
+
+} // namespace Detail
+
+enum class BTreeMapAddResult {
+    InsertedNewKey,
+    KeyAlreadyExists,
+};
+
+enum class BTreeMapRemoveResult {
+    RemovedExistingKey,
+    KeyDoesNotExist,
+};
+
+//
+// Ordered associative container, implemented as a B+ tree.
+// All entries are stored in the leaf nodes, which are linked together, so ordered iteration and range scans never have
+// to walk up the tree. The keys of each node are stored contiguously, at the beginning of the node (which is aligned to
+// a cache line), and a node is only a few cache lines big. Compared to a binary search tree this massively reduces the
+// number of cache misses and memory allocations, as each node stores tens of entries.
+// The key type must provide the less-than operator, which must implement a strict weak ordering, and must be copyable
+// as the internal nodes store copies of the keys as separators.
+//
+template<typename KeyType, typename ValueType>
+requires (!is_reference<KeyType>)
+class BTreeMap {
+    AT_MAKE_NONCOPYABLE(BTreeMap);
+
+public:
+    // NOTE: The maximum number of keys a node can store is chosen such that the keys occupy about four cache lines.
+    static constexpr usize node_key_bytes = 4 * cache_line_size;
+    static constexpr usize node_capacity = (node_key_bytes / sizeof(KeyType) < 4) ? 4 : (node_key_bytes / sizeof(KeyType));
+    static constexpr usize node_minimum_count = node_capacity / 2;
+
+    // NOTE: The tree depth is logarithmic, so this is more than enough for any number of entries that fits in memory.
+    static constexpr usize max_tree_depth = 48;
+
+private:
+    struct alignas(cache_line_size) Node {
+        alignas(KeyType) u8 key_storage[node_capacity * sizeof(KeyType)];
+        u32 key_count;
+        bool is_leaf;
+
+        ALWAYS_INLINE KeyType* keys() { return reinterpret_cast<KeyType*>(key_storage); }
+        ALWAYS_INLINE const KeyType* keys() const { return reinterpret_cast<const KeyType*>(key_storage); }
+    };
+
+    struct LeafNode : public Node {
+        LeafNode* previous;
+        LeafNode* next;
+        alignas(ValueType) u8 value_storage[node_capacity * sizeof(ValueType)];
+
+        ALWAYS_INLINE ValueType* values() { return reinterpret_cast<ValueType*>(value_storage); }
+        ALWAYS_INLINE const ValueType* values() const { return reinterpret_cast<const ValueType*>(value_storage); }
+    };
+
+    struct InternalNode : public Node {
+        // NOTE: The child located at index 'i' stores the keys that are in the (keys[i - 1], keys[i]] interval.
+        Node* children[node_capacity + 1];
+    };
+
+    struct PathEntry {
+        InternalNode* node;
+        usize child_index;
+    };
+
+public:
+    template<typename IteratorValueType>
+    class IteratorBase {
+        friend class BTreeMap;
+
+    public:
+        struct KeyValuePair {
+            ALWAYS_INLINE KeyValuePair(const KeyType& in_key, IteratorValueType& in_value)
+                : key(in_key)
+                , value(in_value)
+            {}
+
+            const KeyType& key;
+            IteratorValueType& value;
+        };
+
+    public:
+        NODISCARD ALWAYS_INLINE bool operator==(const IteratorBase& other) const { return m_leaf == other.m_leaf && m_index == other.m_index; }
+        NODISCARD ALWAYS_INLINE bool operator!=(const IteratorBase& other) const { return !(*this == other); }
+
+        NODISCARD ALWAYS_INLINE const KeyType& key() const { return m_leaf->keys()[m_index]; }
+        NODISCARD ALWAYS_INLINE IteratorValueType& value() const { return m_leaf->values()[m_index]; }
+        NODISCARD ALWAYS_INLINE KeyValuePair operator*() const { return KeyValuePair(key(), value()); }
+
+        ALWAYS_INLINE IteratorBase& operator++()
+        {
+            if (++m_index == m_leaf->key_count) {
+                m_leaf = m_leaf->next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        ALWAYS_INLINE IteratorBase operator++(int)
+        {
+            IteratorBase current = *this;
+            ++(*this);
+            return current;
+        }
+
+    private:
+        ALWAYS_INLINE IteratorBase(LeafNode* leaf, usize index)
+            : m_leaf(leaf)
+            , m_index(index)
+        {
+            // NOTE: An iterator always points towards a valid entry or is the end iterator (null leaf).
+            if (m_leaf && m_index == m_leaf->key_count) {
+                m_leaf = m_leaf->next;
+                m_index = 0;
+            }
+        }
+
+    private:
+        LeafNode* m_leaf;
+        usize m_index;
+    };
+
+    using Iterator = IteratorBase<ValueType>;
+    using ConstIterator = IteratorBase<const ValueType>;
+
+    template<typename RangeIterator>
+    class RangeView {
+    public:
+        ALWAYS_INLINE RangeView(RangeIterator begin_iterator, RangeIterator end_iterator)
+            : m_begin(begin_iterator)
+            , m_end(end_iterator)
+        {}
+
+        NODISCARD ALWAYS_INLINE bool is_empty() const { return m_begin == m_end; }
+
+        NODISCARD ALWAYS_INLINE RangeIterator begin() const { return m_begin; }
+        NODISCARD ALWAYS_INLINE RangeIterator end() const { return m_end; }
+
+    private:
+        RangeIterator m_begin;
+        RangeIterator m_end;
+    };
+
+    using Range = RangeView<Iterator>;
+    using ConstRange = RangeView<ConstIterator>;
+
+public:
+    //
+    // Creates a map from two parallel sequences of keys and values. The keys must be sorted in strictly ascending order.
+    // The tree is built bottom-up, level by level, which is much faster than adding the entries one by one and produces
+    // nodes that are (almost) completely filled.
+    //
+    NODISCARD static BTreeMap create_from_sorted(Span<const KeyType> keys, Span<const ValueType> values)
+    {
+        AT_ASSERT(keys.count() == values.count());
+
+        BTreeMap map;
+        const usize entry_count = keys.count();
+        if (entry_count == 0) {
+            return map;
+        }
+
+        // NOTE: For each node of the current level, the index of its maximum key is tracked, as the separators of the
+        //       parent level are exactly these keys.
+        const usize leaf_count = (entry_count + node_capacity - 1) / node_capacity;
+        Vector<Node*> level_nodes = Vector<Node*>::create_with_initial_capacity(leaf_count);
+        Vector<usize> level_max_key_indices = Vector<usize>::create_with_initial_capacity(leaf_count);
+
+        LeafNode* previous_leaf = nullptr;
+        usize entry_index = 0;
+        for (usize leaf_index = 0; leaf_index < leaf_count; ++leaf_index) {
+            // Distribute the entries evenly, so all leaves satisfy the minimum occupancy.
+            const usize leaf_entry_count = (entry_count / leaf_count) + (leaf_index < entry_count % leaf_count ? 1 : 0);
+
+            LeafNode* leaf = allocate_leaf_node();
+            for (usize index = 0; index < leaf_entry_count; ++index, ++entry_index) {
+                AT_ASSERT(entry_index == 0 || keys.elements()[entry_index - 1] < keys.elements()[entry_index]);
+                new (leaf->keys() + index) KeyType(keys.elements()[entry_index]);
+                new (leaf->values() + index) ValueType(values.elements()[entry_index]);
+            }
+            leaf->key_count = static_cast<u32>(leaf_entry_count);
+
+            leaf->previous = previous_leaf;
+            if (previous_leaf) {
+                previous_leaf->next = leaf;
+            }
+            else {
+                map.m_first_leaf = leaf;
+            }
+            previous_leaf = leaf;
+
+            level_nodes.add(leaf);
+            level_max_key_indices.add(entry_index - 1);
+        }
+
+        while (level_nodes.count() > 1) {
+            const usize child_count = level_nodes.count();
+            const usize parent_count = (child_count + node_capacity) / (node_capacity + 1);
+
+            Vector<Node*> parent_nodes = Vector<Node*>::create_with_initial_capacity(parent_count);
+            Vector<usize> parent_max_key_indices = Vector<usize>::create_with_initial_capacity(parent_count);
+
+            usize child_index = 0;
+            for (usize parent_index = 0; parent_index < parent_count; ++parent_index) {
+                const usize parent_child_count = (child_count / parent_count) + (parent_index < child_count % parent_count ? 1 : 0);
+
+                InternalNode* parent = allocate_internal_node();
+                for (usize index = 0; index < parent_child_count; ++index, ++child_index) {
+                    parent->children[index] = level_nodes[child_index];
+                    if (index + 1 < parent_child_count) {
+                        new (parent->keys() + index) KeyType(keys.elements()[level_max_key_indices[child_index]]);
+                    }
+                }
+                parent->key_count = static_cast<u32>(parent_child_count - 1);
+
+                parent_nodes.add(parent);
+                parent_max_key_indices.add(level_max_key_indices[child_index - 1]);
+            }
+
+            level_nodes = move(parent_nodes);
+            level_max_key_indices = move(parent_max_key_indices);
+        }
+
+        map.m_root = level_nodes[0];
+        map.m_count = entry_count;
+        return map;
+    }
+
+public:
+    ALWAYS_INLINE BTreeMap()
+        : m_root(nullptr)
+        , m_first_leaf(nullptr)
+        , m_count(0)
+    {}
+
+    ALWAYS_INLINE BTreeMap(BTreeMap&& other) noexcept
+        : m_root(other.m_root)
+        , m_first_leaf(other.m_first_leaf)
+        , m_count(other.m_count)
+    {
+        other.m_root = nullptr;
+        other.m_first_leaf = nullptr;
+        other.m_count = 0;
+    }
+
+    ALWAYS_INLINE BTreeMap& operator=(BTreeMap&& other) noexcept
+    {
+        clear();
+
+        m_root = other.m_root;
+        m_first_leaf = other.m_first_leaf;
+        m_count = other.m_count;
+
+        other.m_root = nullptr;
+        other.m_first_leaf = nullptr;
+        other.m_count = 0;
+
+        return *this;
+    }
+
+    ALWAYS_INLINE ~BTreeMap() { clear(); }
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_count; }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_count == 0); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return (m_count > 0); }
+
+public:
+    NODISCARD ALWAYS_INLINE Iterator find(const KeyType& key)
+    {
+        usize index;
+        LeafNode* leaf = find_leaf(key, index);
+        if (!leaf || index == leaf->key_count || key < leaf->keys()[index]) {
+            return end();
+        }
+        return Iterator(leaf, index);
+    }
+
+    NODISCARD ALWAYS_INLINE ConstIterator find(const KeyType& key) const
+    {
+        usize index;
+        LeafNode* leaf = find_leaf(key, index);
+        if (!leaf || index == leaf->key_count || key < leaf->keys()[index]) {
+            return end();
+        }
+        return ConstIterator(leaf, index);
+    }
+
+    NODISCARD ALWAYS_INLINE bool contains(const KeyType& key) const { return find(key) != end(); }
+
+    NODISCARD ALWAYS_INLINE Optional<ValueType&> get_if_exists(const KeyType& key)
+    {
+        Iterator iterator = find(key);
+        if (iterator != end()) {
+            return iterator.value();
+        }
+        return {};
+    }
+
+    NODISCARD ALWAYS_INLINE Optional<const ValueType&> get_if_exists(const KeyType& key) const
+    {
+        ConstIterator iterator = find(key);
+        if (iterator != end()) {
+            return iterator.value();
+        }
+        return {};
+    }
+
+    NODISCARD ALWAYS_INLINE ValueType& at(const KeyType& key)
+    {
+        auto optional_value = get_if_exists(key);
+        AT_ASSERT(optional_value.has_value());
+        return *optional_value;
+    }
+
+    NODISCARD ALWAYS_INLINE const ValueType& at(const KeyType& key) const
+    {
+        auto optional_value = get_if_exists(key);
+        AT_ASSERT(optional_value.has_value());
+        return *optional_value;
+    }
+
+    // Returns an iterator towards the first entry whose key is not less than the given key.
+    NODISCARD ALWAYS_INLINE Iterator lower_bound(const KeyType& key)
+    {
+        usize index;
+        LeafNode* leaf = find_leaf(key, index);
+        return Iterator(leaf, index);
+    }
+
+    NODISCARD ALWAYS_INLINE ConstIterator lower_bound(const KeyType& key) const
+    {
+        usize index;
+        LeafNode* leaf = find_leaf(key, index);
+        return ConstIterator(leaf, index);
+    }
+
+    // Returns an iterator towards the first entry whose key is greater than the given key.
+    NODISCARD ALWAYS_INLINE Iterator upper_bound(const KeyType& key)
+    {
+        Iterator iterator = lower_bound(key);
+        if (iterator != end() && !(key < iterator.key())) {
+            ++iterator;
+        }
+        return iterator;
+    }
+
+    NODISCARD ALWAYS_INLINE ConstIterator upper_bound(const KeyType& key) const
+    {
+        ConstIterator iterator = lower_bound(key);
+        if (iterator != end() && !(key < iterator.key())) {
+            ++iterator;
+        }
+        return iterator;
+    }
+
+    //
+    // Returns the entries whose keys are in the [lower_key, upper_key) interval, in ascending key order.
+    //
+    NODISCARD ALWAYS_INLINE Range range(const KeyType& lower_key, const KeyType& upper_key)
+    {
+        if (!(lower_key < upper_key)) {
+            return Range(end(), end());
+        }
+        return Range(lower_bound(lower_key), lower_bound(upper_key));
+    }
+
+    NODISCARD ALWAYS_INLINE ConstRange range(const KeyType& lower_key, const KeyType& upper_key) const
+    {
+        if (!(lower_key < upper_key)) {
+            return ConstRange(end(), end());
+        }
+        return ConstRange(lower_bound(lower_key), lower_bound(upper_key));
+    }
+
+public:
+    ALWAYS_INLINE void add(const KeyType& key, const ValueType& value)
+    {
+        bool was_inserted;
+        find_or_insert(key, was_inserted, value);
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    ALWAYS_INLINE void add(const KeyType& key, ValueType&& value)
+    {
+        bool was_inserted;
+        find_or_insert(key, was_inserted, move(value));
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    ALWAYS_INLINE void add(KeyType&& key, const ValueType& value)
+    {
+        bool was_inserted;
+        find_or_insert(move(key), was_inserted, value);
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    ALWAYS_INLINE void add(KeyType&& key, ValueType&& value)
+    {
+        bool was_inserted;
+        find_or_insert(move(key), was_inserted, move(value));
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    template<typename... Args>
+    ALWAYS_INLINE void emplace(const KeyType& key, Args&&... args)
+    {
+        bool was_inserted;
+        find_or_insert(key, was_inserted, forward<Args>(args)...);
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    template<typename... Args>
+    ALWAYS_INLINE void emplace(KeyType&& key, Args&&... args)
+    {
+        bool was_inserted;
+        find_or_insert(move(key), was_inserted, forward<Args>(args)...);
+        AT_ASSERT(was_inserted); // Key already exists.
+    }
+
+    ALWAYS_INLINE BTreeMapAddResult add_if_not_existing(const KeyType& key, const ValueType& value)
+    {
+        bool was_inserted;
+        find_or_insert(key, was_inserted, value);
+        return was_inserted ? BTreeMapAddResult::InsertedNewKey : BTreeMapAddResult::KeyAlreadyExists;
+    }
+
+    ALWAYS_INLINE ValueType& get_or_add(const KeyType& key)
+    {
+        bool was_inserted;
+        return find_or_insert(key, was_inserted);
+    }
+
+    ALWAYS_INLINE ValueType& operator[](const KeyType& key) { return get_or_add(key); }
+
+    ALWAYS_INLINE void remove(const KeyType& key)
+    {
+        MAYBE_UNUSED const BTreeMapRemoveResult result = remove_if_exists(key);
+        AT_ASSERT(result == BTreeMapRemoveResult::RemovedExistingKey);
+    }
+
+    BTreeMapRemoveResult remove_if_exists(const KeyType& key)
+    {
+        if (!m_root) {
+            return BTreeMapRemoveResult::KeyDoesNotExist;
+        }
+
+        PathEntry path[max_tree_depth];
+        usize path_length = 0;
+        LeafNode* leaf = descend_to_leaf(key, path, path_length);
+
+        const usize index = Detail::btree_count_less_than(leaf->keys(), leaf->key_count, key);
+        if (index == leaf->key_count || key < leaf->keys()[index]) {
+            return BTreeMapRemoveResult::KeyDoesNotExist;
+        }
+
+        leaf->keys()[index].~KeyType();
+        leaf->values()[index].~ValueType();
+        shift_elements_left(leaf->keys(), leaf->key_count, index);
+        shift_elements_left(leaf->values(), leaf->key_count, index);
+        --leaf->key_count;
+        --m_count;
+
+        // Restore the minimum occupancy invariant, from the leaf towards the root.
+        Node* node = leaf;
+        while (path_length > 0 && node->key_count < node_minimum_count) {
+            const PathEntry& parent_entry = path[--path_length];
+            if (node->is_leaf) {
+                rebalance_leaf(parent_entry.node, parent_entry.child_index);
+            }
+            else {
+                rebalance_internal(parent_entry.node, parent_entry.child_index);
+            }
+            node = parent_entry.node;
+        }
+
+        if (!m_root->is_leaf && m_root->key_count == 0) {
+            // The root has a single child, so the tree height can be reduced.
+            InternalNode* old_root = static_cast<InternalNode*>(m_root);
+            m_root = old_root->children[0];
+            release_internal_node(old_root);
+        }
+        else if (m_root->is_leaf && m_root->key_count == 0) {
+            release_leaf_node(static_cast<LeafNode*>(m_root));
+            m_root = nullptr;
+            m_first_leaf = nullptr;
+        }
+
+        return BTreeMapRemoveResult::RemovedExistingKey;
+    }
+
+    void clear()
+    {
+        if (m_root) {
+            destroy_subtree(m_root);
+        }
+
+        m_root = nullptr;
+        m_first_leaf = nullptr;
+        m_count = 0;
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE Iterator begin() { return Iterator(m_first_leaf, 0); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return Iterator(nullptr, 0); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return ConstIterator(m_first_leaf, 0); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return ConstIterator(nullptr, 0); }
+
+private:
+    NODISCARD ALWAYS_INLINE static LeafNode* allocate_leaf_node()
+    {
+        // NOTE: The nodes are over-aligned, so the aligned variant of the global operator new is invoked.
+        LeafNode* leaf = new LeafNode;
+        leaf->key_count = 0;
+        leaf->is_leaf = true;
+        leaf->previous = nullptr;
+        leaf->next = nullptr;
+        return leaf;
+    }
+
+    NODISCARD ALWAYS_INLINE static InternalNode* allocate_internal_node()
+    {
+        InternalNode* internal = new InternalNode;
+        internal->key_count = 0;
+        internal->is_leaf = false;
+        return internal;
+    }
+
+    ALWAYS_INLINE static void release_leaf_node(LeafNode* leaf) { delete leaf; }
+    ALWAYS_INLINE static void release_internal_node(InternalNode* internal) { delete internal; }
+
+    // Moves the elements located after the given index one position to the right. The slot at the index is left uninitialized.
+    template<typename T>
+    ALWAYS_INLINE static void shift_elements_right(T* elements, usize count, usize index)
+    {
+        for (usize offset = count; offset > index; --offset) {
+            new (elements + offset) T(move(elements[offset - 1]));
+            elements[offset - 1].~T();
+        }
+    }
+
+    // Moves the elements located after the given (already destroyed) index one position to the left.
+    template<typename T>
+    ALWAYS_INLINE static void shift_elements_left(T* elements, usize count, usize index)
+    {
+        for (usize offset = index; offset + 1 < count; ++offset) {
+            new (elements + offset) T(move(elements[offset + 1]));
+            elements[offset + 1].~T();
+        }
+    }
+
+    // Moves 'count' elements from the source to the (uninitialized) destination, leaving the source uninitialized.
+    template<typename T>
+    ALWAYS_INLINE static void relocate_elements(T* destination, T* source, usize count)
+    {
+        for (usize offset = 0; offset < count; ++offset) {
+            new (destination + offset) T(move(source[offset]));
+            source[offset].~T();
+        }
+    }
+
+    static void destroy_subtree(Node* node)
+    {
+        for (usize index = 0; index < node->key_count; ++index) {
+            node->keys()[index].~KeyType();
+        }
+
+        if (node->is_leaf) {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            for (usize index = 0; index < leaf->key_count; ++index) {
+                leaf->values()[index].~ValueType();
+            }
+            release_leaf_node(leaf);
+        }
+        else {
+            InternalNode* internal = static_cast<InternalNode*>(node);
+            for (usize index = 0; index <= internal->key_count; ++index) {
+                destroy_subtree(internal->children[index]);
+            }
+            release_internal_node(internal);
+        }
+    }
+
+private:
+    NODISCARD ALWAYS_INLINE LeafNode* find_leaf(const KeyType& key, usize& out_index) const
+    {
+        out_index = 0;
+        if (!m_root) {
+            return nullptr;
+        }
+
+        Node* node = m_root;
+        while (!node->is_leaf) {
+            InternalNode* internal = static_cast<InternalNode*>(node);
+            node = internal->children[Detail::btree_count_less_than(internal->keys(), internal->key_count, key)];
+        }
+
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        out_index = Detail::btree_count_less_than(leaf->keys(), leaf->key_count, key);
+        return leaf;
+    }
+
+    NODISCARD ALWAYS_INLINE LeafNode* descend_to_leaf(const KeyType& key, PathEntry* path, usize& path_length) const
+    {
+        Node* node = m_root;
+        while (!node->is_leaf) {
+            InternalNode* internal = static_cast<InternalNode*>(node);
+            const usize child_index = Detail::btree_count_less_than(internal->keys(), internal->key_count, key);
+
+            AT_ASSERT(path_length < max_tree_depth);
+            path[path_length++] = { internal, child_index };
+            node = internal->children[child_index];
+        }
+        return static_cast<LeafNode*>(node);
+    }
+
+    template<typename KeyArgument, typename... ValueArguments>
+    ValueType& find_or_insert(KeyArgument&& key, bool& out_was_inserted, ValueArguments&&... value_arguments)
+    {
+        if (!m_root) {
+            LeafNode* leaf = allocate_leaf_node();
+            m_root = leaf;
+            m_first_leaf = leaf;
+        }
+
+        PathEntry path[max_tree_depth];
+        usize path_length = 0;
+        LeafNode* leaf = descend_to_leaf(key, path, path_length);
+
+        usize index = Detail::btree_count_less_than(leaf->keys(), leaf->key_count, key);
+        if (index < leaf->key_count && !(key < leaf->keys()[index])) {
+            out_was_inserted = false;
+            return leaf->values()[index];
+        }
+
+        out_was_inserted = true;
+        ++m_count;
+
+        if (leaf->key_count < node_capacity) {
+            return insert_into_leaf(leaf, index, forward<KeyArgument>(key), forward<ValueArguments>(value_arguments)...);
+        }
+
+        // The leaf is full, so split it in two halves and insert the entry in the corresponding one.
+        LeafNode* right_leaf = allocate_leaf_node();
+        const usize left_count = node_capacity / 2;
+        relocate_elements(right_leaf->keys(), leaf->keys() + left_count, node_capacity - left_count);
+        relocate_elements(right_leaf->values(), leaf->values() + left_count, node_capacity - left_count);
+        leaf->key_count = static_cast<u32>(left_count);
+        right_leaf->key_count = static_cast<u32>(node_capacity - left_count);
+
+        right_leaf->previous = leaf;
+        right_leaf->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->previous = right_leaf;
+        }
+        leaf->next = right_leaf;
+
+        ValueType* value;
+        if (index <= left_count) {
+            value = &insert_into_leaf(leaf, index, forward<KeyArgument>(key), forward<ValueArguments>(value_arguments)...);
+        }
+        else {
+            value = &insert_into_leaf(right_leaf, index - left_count, forward<KeyArgument>(key), forward<ValueArguments>(value_arguments)...);
+        }
+
+        // NOTE: The separator of a node is always the greatest key that is stored in its subtree.
+        insert_separator_into_parents(path, path_length, leaf->keys()[leaf->key_count - 1], right_leaf);
+        return *value;
+    }
+
+    template<typename KeyArgument, typename... ValueArguments>
+    ALWAYS_INLINE ValueType& insert_into_leaf(LeafNode* leaf, usize index, KeyArgument&& key, ValueArguments&&... value_arguments)
+    {
+        shift_elements_right(leaf->keys(), leaf->key_count, index);
+        shift_elements_right(leaf->values(), leaf->key_count, index);
+        new (leaf->keys() + index) KeyType(forward<KeyArgument>(key));
+        new (leaf->values() + index) ValueType(forward<ValueArguments>(value_arguments)...);
+        ++leaf->key_count;
+        return leaf->values()[index];
+    }
+
+    ALWAYS_INLINE static void insert_into_internal(InternalNode* internal, usize index, KeyType&& separator, Node* right_child)
+    {
+        shift_elements_right(internal->keys(), internal->key_count, index);
+        new (internal->keys() + index) KeyType(move(separator));
+
+        for (usize offset = internal->key_count + 1; offset > index + 1; --offset) {
+            internal->children[offset] = internal->children[offset - 1];
+        }
+        internal->children[index + 1] = right_child;
+        ++internal->key_count;
+    }
+
+    void insert_separator_into_parents(PathEntry* path, usize path_length, const KeyType& left_max_key, Node* right_node)
+    {
+        Optional<KeyType> separator = left_max_key;
+
+        while (path_length > 0) {
+            const PathEntry& parent_entry = path[--path_length];
+            InternalNode* parent = parent_entry.node;
+
+            if (parent->key_count < node_capacity) {
+                insert_into_internal(parent, parent_entry.child_index, separator.release_value(), right_node);
+                return;
+            }
+
+            // The parent is full, so split it. The middle key is moved up to the next level as the new separator.
+            InternalNode* right_parent = allocate_internal_node();
+            const usize middle_index = node_capacity / 2;
+
+            relocate_elements(right_parent->keys(), parent->keys() + middle_index + 1, node_capacity - middle_index - 1);
+            for (usize index = middle_index + 1; index <= node_capacity; ++index) {
+                right_parent->children[index - middle_index - 1] = parent->children[index];
+            }
+            right_parent->key_count = static_cast<u32>(node_capacity - middle_index - 1);
+
+            Optional<KeyType> promoted_key = move(parent->keys()[middle_index]);
+            parent->keys()[middle_index].~KeyType();
+            parent->key_count = static_cast<u32>(middle_index);
+
+            if (parent_entry.child_index <= middle_index) {
+                insert_into_internal(parent, parent_entry.child_index, separator.release_value(), right_node);
+            }
+            else {
+                insert_into_internal(right_parent, parent_entry.child_index - middle_index - 1, separator.release_value(), right_node);
+            }
+
+            separator = promoted_key.release_value();
+            right_node = right_parent;
+        }
+
+        // The root has been split, so the tree grows by one level.
+        InternalNode* new_root = allocate_internal_node();
+        new (new_root->keys()) KeyType(separator.release_value());
+        new_root->children[0] = m_root;
+        new_root->children[1] = right_node;
+        new_root->key_count = 1;
+        m_root = new_root;
+    }
+
+    ALWAYS_INLINE static void remove_from_internal(InternalNode* internal, usize key_index, usize child_index)
+    {
+        internal->keys()[key_index].~KeyType();
+        shift_elements_left(internal->keys(), internal->key_count, key_index);
+
+        for (usize offset = child_index; offset < internal->key_count; ++offset) {
+            internal->children[offset] = internal->children[offset + 1];
+        }
+        --internal->key_count;
+    }
+
+    void rebalance_leaf(InternalNode* parent, usize child_index)
+    {
+        LeafNode* child = static_cast<LeafNode*>(parent->children[child_index]);
+        LeafNode* left = (child_index > 0) ? static_cast<LeafNode*>(parent->children[child_index - 1]) : nullptr;
+        LeafNode* right = (child_index < parent->key_count) ? static_cast<LeafNode*>(parent->children[child_index + 1]) : nullptr;
+
+        if (left && left->key_count > node_minimum_count) {
+            // Borrow the greatest entry of the left sibling.
+            shift_elements_right(child->keys(), child->key_count, 0);
+            shift_elements_right(child->values(), child->key_count, 0);
+            relocate_elements(child->keys(), left->keys() + left->key_count - 1, 1);
+            relocate_elements(child->values(), left->values() + left->key_count - 1, 1);
+            --left->key_count;
+            ++child->key_count;
+
+            parent->keys()[child_index - 1] = left->keys()[left->key_count - 1];
+            return;
+        }
+
+        if (right && right->key_count > node_minimum_count) {
+            // Borrow the smallest entry of the right sibling.
+            relocate_elements(child->keys() + child->key_count, right->keys(), 1);
+            relocate_elements(child->values() + child->key_count, right->values(), 1);
+            shift_elements_left(right->keys(), right->key_count, 0);
+            shift_elements_left(right->values(), right->key_count, 0);
+            --right->key_count;
+            ++child->key_count;
+
+            parent->keys()[child_index] = child->keys()[child->key_count - 1];
+            return;
+        }
+
+        // None of the siblings can lend an entry, so merge the child with one of them.
+        if (left) {
+            merge_leaves(left, child);
+            remove_from_internal(parent, child_index - 1, child_index);
+        }
+        else {
+            AT_ASSERT(right);
+            merge_leaves(child, right);
+            remove_from_internal(parent, child_index, child_index + 1);
+        }
+    }
+
+    // Moves all entries of the right leaf into the left one and releases the right leaf.
+    void merge_leaves(LeafNode* left, LeafNode* right)
+    {
+        relocate_elements(left->keys() + left->key_count, right->keys(), right->key_count);
+        relocate_elements(left->values() + left->key_count, right->values(), right->key_count);
+        left->key_count += right->key_count;
+
+        left->next = right->next;
+        if (right->next) {
+            right->next->previous = left;
+        }
+        release_leaf_node(right);
+    }
+
+    void rebalance_internal(InternalNode* parent, usize child_index)
+    {
+        InternalNode* child = static_cast<InternalNode*>(parent->children[child_index]);
+        InternalNode* left = (child_index > 0) ? static_cast<InternalNode*>(parent->children[child_index - 1]) : nullptr;
+        InternalNode* right = (child_index < parent->key_count) ? static_cast<InternalNode*>(parent->children[child_index + 1]) : nullptr;
+
+        if (left && left->key_count > node_minimum_count) {
+            // Rotate the greatest child of the left sibling through the parent.
+            shift_elements_right(child->keys(), child->key_count, 0);
+            relocate_elements(child->keys(), parent->keys() + child_index - 1, 1);
+            for (usize offset = child->key_count + 1; offset > 0; --offset) {
+                child->children[offset] = child->children[offset - 1];
+            }
+            child->children[0] = left->children[left->key_count];
+            ++child->key_count;
+
+            relocate_elements(parent->keys() + child_index - 1, left->keys() + left->key_count - 1, 1);
+            --left->key_count;
+            return;
+        }
+
+        if (right && right->key_count > node_minimum_count) {
+            // Rotate the smallest child of the right sibling through the parent.
+            relocate_elements(child->keys() + child->key_count, parent->keys() + child_index, 1);
+            child->children[child->key_count + 1] = right->children[0];
+            ++child->key_count;
+
+            relocate_elements(parent->keys() + child_index, right->keys(), 1);
+            shift_elements_left(right->keys(), right->key_count, 0);
+            for (usize offset = 0; offset < right->key_count; ++offset) {
+                right->children[offset] = right->children[offset + 1];
+            }
+            --right->key_count;
+            return;
+        }
+
+        if (left) {
+            merge_internals(left, child, parent, child_index - 1);
+        }
+        else {
+            AT_ASSERT(right);
+            merge_internals(child, right, parent, child_index);
+        }
+    }
+
+    // Moves the separator and all keys and children of the right node into the left one and releases the right node.
+    void merge_internals(InternalNode* left, InternalNode* right, InternalNode* parent, usize separator_index)
+    {
+        new (left->keys() + left->key_count) KeyType(move(parent->keys()[separator_index]));
+        relocate_elements(left->keys() + left->key_count + 1, right->keys(), right->key_count);
+        for (usize offset = 0; offset <= right->key_count; ++offset) {
+            left->children[left->key_count + 1 + offset] = right->children[offset];
+        }
+        left->key_count += right->key_count + 1;
+
+        release_internal_node(right);
+        remove_from_internal(parent, separator_index, separator_index + 1);
+    }
+
+private:
+    Node* m_root;
+    LeafNode* m_first_leaf;
+    usize m_count;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::BTreeMap;
+using AT::BTreeMapAddResult;
+using AT::BTreeMapRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
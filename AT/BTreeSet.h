@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/BTreeMap.h>
+
+namespace AT {
+
+namespace Detail {
+
+struct BTreeSetEmptyValue {};
+
+} // namespace Detail
+
+enum class BTreeSetAddResult {
+    InsertedNewEntry,
+    EntryAlreadyExists,
+};
+
+enum class BTreeSetRemoveResult {
+    RemovedExistingEntry,
+    EntryDoesNotExist,
+};
+
+//
+// Ordered set of unique elements, implemented as a B+ tree. See BTreeMap for the details about the memory layout.
+// Unlike a FlatSet, insertions and removals are logarithmic, so it is suited for large sets that change frequently.
+//
+template<typename T>
+requires (!is_reference<T>)
+class BTreeSet {
+    AT_MAKE_NONCOPYABLE(BTreeSet);
+
+private:
+    using MapType = BTreeMap<T, Detail::BTreeSetEmptyValue>;
+
+public:
+    class ConstIterator {
+        friend class BTreeSet;
+
+    public:
+        NODISCARD ALWAYS_INLINE bool operator==(const ConstIterator& other) const { return m_iterator == other.m_iterator; }
+        NODISCARD ALWAYS_INLINE bool operator!=(const ConstIterator& other) const { return m_iterator != other.m_iterator; }
+
+        NODISCARD ALWAYS_INLINE const T& operator*() const { return m_iterator.key(); }
+        NODISCARD ALWAYS_INLINE const T* operator->() const { return &m_iterator.key(); }
+
+        ALWAYS_INLINE ConstIterator& operator++()
+        {
+            ++m_iterator;
+            return *this;
+        }
+
+        ALWAYS_INLINE ConstIterator operator++(int)
+        {
+            ConstIterator current = *this;
+            ++m_iterator;
+            return current;
+        }
+
+    private:
+        ALWAYS_INLINE explicit ConstIterator(typename MapType::ConstIterator iterator)
+            : m_iterator(iterator)
+        {}
+
+    private:
+        typename MapType::ConstIterator m_iterator;
+    };
+
+    using Range = typename MapType::template RangeView<ConstIterator>;
+
+public:
+    //
+    // Creates a set from a sequence of elements that must be sorted in strictly ascending order.
+    // The tree is built bottom-up, which is much faster than adding the elements one by one.
+    //
+    NODISCARD static BTreeSet create_from_sorted(Span<const T> elements)
+    {
+        // NOTE: The empty values have no state, so a single instance can be read for every element.
+        const Detail::BTreeSetEmptyValue empty_value;
+        Vector<Detail::BTreeSetEmptyValue> empty_values;
+        empty_values.ensure_fixed_capacity(elements.count());
+        for (usize index = 0; index < elements.count(); ++index) {
+            empty_values.add(empty_value);
+        }
+
+        BTreeSet set;
+        set.m_map = MapType::create_from_sorted(elements, Span<const Detail::BTreeSetEmptyValue>(empty_values.elements(), empty_values.count()));
+        return set;
+    }
+
+public:
+    BTreeSet() = default;
+    BTreeSet(BTreeSet&&) noexcept = default;
+    BTreeSet& operator=(BTreeSet&&) noexcept = default;
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_map.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_map.is_empty(); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return m_map.has_elements(); }
+
+public:
+    NODISCARD ALWAYS_INLINE ConstIterator find(const T& element) const { return ConstIterator(m_map.find(element)); }
+    NODISCARD ALWAYS_INLINE bool contains(const T& element) const { return m_map.contains(element); }
+
+    // Returns an iterator towards the first element that is not less than the given value.
+    NODISCARD ALWAYS_INLINE ConstIterator lower_bound(const T& value) const { return ConstIterator(m_map.lower_bound(value)); }
+    // Returns an iterator towards the first element that is greater than the given value.
+    NODISCARD ALWAYS_INLINE ConstIterator upper_bound(const T& value) const { return ConstIterator(m_map.upper_bound(value)); }
+
+    //
+    // Returns the elements that are in the [lower_value, upper_value) interval, in ascending order.
+    //
+    NODISCARD ALWAYS_INLINE Range range(const T& lower_value, const T& upper_value) const
+    {
+        const auto map_range = m_map.range(lower_value, upper_value);
+        return Range(ConstIterator(map_range.begin()), ConstIterator(map_range.end()));
+    }
+
+public:
+    ALWAYS_INLINE void add(const T& element) { m_map.add(element, {}); }
+    ALWAYS_INLINE void add(T&& element) { m_map.add(move(element), {}); }
+
+    ALWAYS_INLINE BTreeSetAddResult add_if_not_existing(const T& element)
+    {
+        const BTreeMapAddResult result = m_map.add_if_not_existing(element, {});
+        return (result == BTreeMapAddResult::InsertedNewKey) ? BTreeSetAddResult::InsertedNewEntry : BTreeSetAddResult::EntryAlreadyExists;
+    }
+
+    ALWAYS_INLINE void remove(const T& element) { m_map.remove(element); }
+
+    ALWAYS_INLINE BTreeSetRemoveResult remove_if_exists(const T& element)
+    {
+        const BTreeMapRemoveResult result = m_map.remove_if_exists(element);
+        return (result == BTreeMapRemoveResult::RemovedExistingKey) ? BTreeSetRemoveResult::RemovedExistingEntry
+                                                                     : BTreeSetRemoveResult::EntryDoesNotExist;
+    }
+
+    ALWAYS_INLINE void clear() { m_map.clear(); }
+
+public:
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return ConstIterator(m_map.begin()); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return ConstIterator(m_map.end()); }
+
+private:
+    MapType m_map;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::BTreeSet;
+using AT::BTreeSetAddResult;
+using AT::BTreeSetRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Assertion.h>
+#include <AT/Defines.h>
+#include <AT/Types.h>
+
+#if AT_COMPILER_MSVC
+    #include <intrin.h>
+#endif // AT_COMPILER_MSVC
+
+namespace AT {
+
+// Returns the index of the least significant set bit. The value must not be zero.
+NODISCARD ALWAYS_INLINE u32 count_trailing_zeros(u64 value)
+{
+    AT_ASSERT_DEBUG(value != 0);
+#if AT_COMPILER_MSVC
+    unsigned long bit_index;
+    _BitScanForward64(&bit_index, value);
+    return static_cast<u32>(bit_index);
+#else
+    return static_cast<u32>(__builtin_ctzll(value));
+#endif // AT_COMPILER_MSVC
+}
+
+// Returns the number of zero bits above the most significant set bit. The value must not be zero.
+NODISCARD ALWAYS_INLINE u32 count_leading_zeros(u64 value)
+{
+    AT_ASSERT_DEBUG(value != 0);
+#if AT_COMPILER_MSVC
+    unsigned long bit_index;
+    _BitScanReverse64(&bit_index, value);
+    return 63 - static_cast<u32>(bit_index);
+#else
+    return static_cast<u32>(__builtin_clzll(value));
+#endif // AT_COMPILER_MSVC
+}
+
+// Computes the full 128-bit product of two 64-bit integers. Returns the low half and stores the high half.
+NODISCARD ALWAYS_INLINE u64 multiply_u64(u64 lhs, u64 rhs, u64& out_high)
+{
+#if AT_COMPILER_MSVC
+    return _umul128(lhs, rhs, &out_high);
+#else
+    // NOTE: The 128-bit integer type is a compiler extension, which must be marked as such to compile in pedantic mode.
+    __extension__ typedef unsigned __int128 UnsignedInt128;
+    const UnsignedInt128 product = static_cast<UnsignedInt128>(lhs) * rhs;
+    out_high = static_cast<u64>(product >> 64);
+    return static_cast<u64>(product);
+#endif // AT_COMPILER_MSVC
+}
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::count_leading_zeros;
+using AT::count_trailing_zeros;
+using AT::multiply_u64;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/CPUFeatures.h>
+
+#if AT_ARCH_X86_64
+    #if AT_COMPILER_MSVC
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif // AT_COMPILER_MSVC
+#endif // AT_ARCH_X86_64
+
+namespace AT {
+
+#if AT_ARCH_X86_64
+
+static void execute_cpuid(u32 leaf, u32 subleaf, u32 out_registers[4])
+{
+    #if AT_COMPILER_MSVC
+    int registers[4] = {};
+    __cpuidex(registers, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (usize index = 0; index < 4; ++index) {
+        out_registers[index] = static_cast<u32>(registers[index]);
+    }
+    #else
+    __cpuid_count(leaf, subleaf, out_registers[0], out_registers[1], out_registers[2], out_registers[3]);
+    #endif // AT_COMPILER_MSVC
+}
+
+static u64 read_extended_control_register()
+{
+    #if AT_COMPILER_MSVC
+    return _xgetbv(0);
+    #else
+    u32 low_bits;
+    u32 high_bits;
+    __asm__ volatile("xgetbv" : "=a"(low_bits), "=d"(high_bits) : "c"(0));
+    return (static_cast<u64>(high_bits) << 32) | low_bits;
+    #endif // AT_COMPILER_MSVC
+}
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features = {};
+
+    u32 registers[4] = {};
+    execute_cpuid(0, 0, registers);
+    const u32 highest_leaf = registers[0];
+    if (highest_leaf < 1) {
+        return features;
+    }
+
+    // Register indices: 0 = EAX, 1 = EBX, 2 = ECX, 3 = EDX.
+    execute_cpuid(1, 0, registers);
+    const bool has_ssse3 = registers[2] & (1 << 9);
+    const bool has_sse4_1 = registers[2] & (1 << 19);
+    const bool has_sse4_2 = registers[2] & (1 << 20);
+    const bool has_osxsave = registers[2] & (1 << 27);
+    const bool has_avx = registers[2] & (1 << 28);
+    features.has_sse4_2 = has_ssse3 && has_sse4_1 && has_sse4_2;
+
+    // The operating system must save both the XMM and the YMM registers on a context switch.
+    const bool os_supports_avx = has_osxsave && has_avx && (read_extended_control_register() & 0x06) == 0x06;
+    if (os_supports_avx && highest_leaf >= 7) {
+        execute_cpuid(7, 0, registers);
+        features.has_avx2 = registers[1] & (1 << 5);
+    }
+
+    return features;
+}
+
+#else
+
+static CPUFeatures detect_cpu_features()
+{
+    return {};
+}
+
+#endif // AT_ARCH_X86_64
+
+const CPUFeatures& cpu_features()
+{
+    static const CPUFeatures s_features = detect_cpu_features();
+    return s_features;
+}
+
+} // namespace AT
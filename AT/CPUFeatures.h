@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Defines.h>
+#include <AT/Types.h>
+
+//
+// Function attributes that allow the compiler to emit instructions from the given instruction set extension in the
+// annotated function, even when the whole translation unit is compiled for the baseline architecture. Such functions
+// must only be called after checking that the CPU actually supports the extension (see cpu_features()).
+// MSVC always allows the intrinsics to be used, so no attribute is required.
+//
+#if AT_ARCH_X86_64 && (AT_COMPILER_CLANG || AT_COMPILER_GCC)
+    #define AT_TARGET_SSE4_2 __attribute__((target("sse4.2")))
+    #define AT_TARGET_AVX2   __attribute__((target("avx2")))
+#else
+    #define AT_TARGET_SSE4_2
+    #define AT_TARGET_AVX2
+#endif // AT_ARCH_X86_64 && (AT_COMPILER_CLANG || AT_COMPILER_GCC)
+
+namespace AT {
+
+struct CPUFeatures {
+    // NOTE: SSE4.2 implies the support for SSSE3 and SSE4.1 as well.
+    bool has_sse4_2;
+    // NOTE: Only reported if the operating system also preserves the upper halves of the YMM registers.
+    bool has_avx2;
+};
+
+//
+// Returns the instruction set extensions supported by the CPU that runs the program.
+// The features are detected only once, when this function is first called, and then cached.
+// On architectures other than x86-64 all features are reported as not supported.
+//
+NODISCARD AT_API const CPUFeatures& cpu_features();
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::cpu_features;
+using AT::CPUFeatures;
+#endif // AT_INCLUDE_GLOBALLY
@@ -71,6 +71,22 @@
     #error Unknown or unsupported compiler!
 #endif // Any supported compiler.
 
+#if defined(_M_X64) || defined(__x86_64__)
+    #define AT_ARCH_X86_64 1
+#endif // _M_X64 || __x86_64__
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+    #define AT_ARCH_ARM64 1
+#endif // _M_ARM64 || __aarch64__
+
+#ifndef AT_ARCH_X86_64
+    #define AT_ARCH_X86_64 0
+#endif // AT_ARCH_X86_64
+
+#ifndef AT_ARCH_ARM64
+    #define AT_ARCH_ARM64 0
+#endif // AT_ARCH_ARM64
+
 #define NODISCARD    [[nodiscard]]
 #define MAYBE_UNUSED [[maybe_unused]]
 #define LIKELY       [[likely]]
@@ -79,14 +95,17 @@
 
 #if AT_COMPILER_MSVC
     #define ALWAYS_INLINE __forceinline
+    #define NEVER_INLINE  __declspec(noinline)
     #define AT_FUNCTION   __FUNCSIG__
     #define AT_DEBUGBREAK __debugbreak()
 #elif AT_COMPILER_CLANG
     #define ALWAYS_INLINE __attribute__((always_inline)) inline
+    #define NEVER_INLINE  __attribute__((noinline))
     #define AT_FUNCTION   __PRETTY_FUNCTION__
     #define AT_DEBUGBREAK __builtin_trap()
 #elif AT_COMPILER_GCC
     #define ALWAYS_INLINE __attribute__((always_inline)) inline
+    #define NEVER_INLINE  __attribute__((noinline))
     #define AT_FUNCTION   __PRETTY_FUNCTION__
     #define AT_DEBUGBREAK __builtin_trap()
 #endif // Compiler switch.
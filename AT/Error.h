@@ -12,6 +12,23 @@
 
 namespace AT {
 
+//
+// Invokes the given macro for every error code (except 'Unknown'), in the order of their values. Used to generate both
+// the error code enumeration and the tables that map an error code to its name, so they can't get out of sync.
+//
+#define AT_ENUMERATE_ERROR_CODES(X) \
+    X(AlreadyInitialized)           \
+    X(BufferOverflow)               \
+    X(FileNotFound)                 \
+    X(FileOperationFailed)          \
+    X(IndexOutOfRange)              \
+    X(InvalidEncoding)              \
+    X(InvalidStringFormat)          \
+    X(KeyAlreadyExists)             \
+    X(KeyDoesNotExist)              \
+    X(NumberOutOfRange)             \
+    X(OutOfMemory)
+
 class Error {
     AT_MAKE_NONCOPYABLE(Error);
 
@@ -22,14 +39,9 @@ public:
     enum Code : u32 {
         Unknown = 0,
 
-        AlreadyInitialized,
-        BufferOverflow,
-        IndexOutOfRange,
-        InvalidEncoding,
-        InvalidStringFormat,
-        KeyAlreadyExists,
-        KeyDoesNotExist,
-        OutOfMemory,
+#define AT_ERROR_CODE(name) name,
+        AT_ENUMERATE_ERROR_CODES(AT_ERROR_CODE)
+#undef AT_ERROR_CODE
     };
 
     enum class Kind : u8 {
@@ -41,6 +53,33 @@ public:
 public:
     AT_API static Error from_error_code(Code error_code);
 
+public:
+    NODISCARD ALWAYS_INLINE Kind kind() const { return m_error_kind; }
+
+    NODISCARD ALWAYS_INLINE Code code() const
+    {
+        AT_ASSERT(m_error_kind == Kind::Code);
+        return m_error.code;
+    }
+
+    NODISCARD ALWAYS_INLINE const char* string_literal() const
+    {
+        AT_ASSERT(m_error_kind == Kind::StringLiteral);
+        return m_error.string_literal;
+    }
+
+    NODISCARD ALWAYS_INLINE const char* string_allocated_characters() const
+    {
+        AT_ASSERT(m_error_kind == Kind::StringAllocated);
+        return m_error.string_allocated.heap_buffer;
+    }
+
+    NODISCARD ALWAYS_INLINE usize string_allocated_byte_count() const
+    {
+        AT_ASSERT(m_error_kind == Kind::StringAllocated);
+        return m_error.string_allocated.byte_count;
+    }
+
 private:
     Error() = default;
     AT_API Error(Error&& other) noexcept;
@@ -101,6 +140,19 @@ public:
     NODISCARD ALWAYS_INLINE T&& release_value() { return move(m_value_storage); }
     NODISCARD ALWAYS_INLINE Error&& release_error() { return move(m_error_storage); }
 
+    // NOTE: Allow inspecting the value or the error without releasing them (for example, in order to format them).
+    NODISCARD ALWAYS_INLINE const T& value() const
+    {
+        AT_ASSERT(!m_is_error);
+        return m_value_storage;
+    }
+
+    NODISCARD ALWAYS_INLINE const Error& error() const
+    {
+        AT_ASSERT(m_is_error);
+        return m_error_storage;
+    }
+
 private:
     union {
         Error m_error_storage;
@@ -144,6 +196,18 @@ public:
     NODISCARD ALWAYS_INLINE T& release_value() { return *m_value_storage; }
     NODISCARD ALWAYS_INLINE Error&& release_error() { return move(m_error_storage); }
 
+    NODISCARD ALWAYS_INLINE const T& value() const
+    {
+        AT_ASSERT(!m_is_error);
+        return *m_value_storage;
+    }
+
+    NODISCARD ALWAYS_INLINE const Error& error() const
+    {
+        AT_ASSERT(m_is_error);
+        return m_error_storage;
+    }
+
 private:
     union {
         Error m_error_storage;
@@ -187,6 +251,12 @@ public:
     NODISCARD ALWAYS_INLINE bool is_error() const { return m_is_error; }
     NODISCARD ALWAYS_INLINE Error&& release_error() { return move(*reinterpret_cast<Error*>(m_error_storage)); }
 
+    NODISCARD ALWAYS_INLINE const Error& error() const
+    {
+        AT_ASSERT(m_is_error);
+        return *reinterpret_cast<const Error*>(m_error_storage);
+    }
+
 private:
     alignas(Error) u8 m_error_storage[sizeof(Error)];
     bool m_is_error;
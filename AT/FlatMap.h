@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Algorithms.h>
+#include <AT/Optional.h>
+#include <AT/Vector.h>
+
+namespace AT {
+
+namespace Detail {
+
+template<typename KeyType, typename ValueType>
+class FlatMapIterator {
+public:
+    struct KeyValuePair {
+        ALWAYS_INLINE KeyValuePair(const KeyType& in_key, ValueType& in_value)
+            : key(in_key)
+            , value(in_value)
+        {}
+
+        const KeyType& key;
+        ValueType& value;
+    };
+
+public:
+    ALWAYS_INLINE FlatMapIterator(const KeyType* key, ValueType* value)
+        : m_key(key)
+        , m_value(value)
+    {}
+
+    NODISCARD ALWAYS_INLINE bool operator==(const FlatMapIterator& other) const { return m_key == other.m_key; }
+    NODISCARD ALWAYS_INLINE bool operator!=(const FlatMapIterator& other) const { return m_key != other.m_key; }
+
+    NODISCARD ALWAYS_INLINE KeyValuePair operator*() const { return KeyValuePair(*m_key, *m_value); }
+
+    ALWAYS_INLINE FlatMapIterator& operator++()
+    {
+        ++m_key;
+        ++m_value;
+        return *this;
+    }
+
+    ALWAYS_INLINE FlatMapIterator operator++(int)
+    {
+        FlatMapIterator current = *this;
+        ++(*this);
+        return current;
+    }
+
+private:
+    const KeyType* m_key;
+    ValueType* m_value;
+};
+
+} // namespace Detail
+
+enum class FlatMapAddResult {
+    InsertedNewKey,
+    KeyAlreadyExists,
+};
+
+enum class FlatMapRemoveResult {
+    RemovedExistingKey,
+    KeyDoesNotExist,
+};
+
+//
+// Ordered associative container that stores the keys and the values in two separate vectors, sorted by key.
+// Lookups only touch the (densely packed) keys, using a branchless binary search, and the values are only accessed
+// once the key has been found. Compared to a HashMap there is no per-slot metadata and no load factor overhead, and
+// iteration is always performed in ascending key order. Insertions and removals are linear, as the following entries
+// have to be shifted, which makes this container ideal for small or read-mostly maps that are built once using
+// create_from_unsorted().
+// The key type must provide the less-than operator, which must implement a strict weak ordering.
+//
+template<typename KeyType, typename ValueType>
+requires (!is_reference<KeyType>)
+class FlatMap {
+public:
+    using Iterator = Detail::FlatMapIterator<KeyType, ValueType>;
+    using ConstIterator = Detail::FlatMapIterator<KeyType, const ValueType>;
+
+    //
+    // A contiguous sub-sequence of the map entries, sorted by key.
+    //
+    template<typename RangeValueType>
+    class RangeView {
+    public:
+        using RangeIterator = Detail::FlatMapIterator<KeyType, RangeValueType>;
+
+    public:
+        ALWAYS_INLINE RangeView(const KeyType* keys, RangeValueType* values, usize count)
+            : m_keys(keys)
+            , m_values(values)
+            , m_count(count)
+        {}
+
+        NODISCARD ALWAYS_INLINE usize count() const { return m_count; }
+        NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_count == 0); }
+
+        NODISCARD ALWAYS_INLINE Span<const KeyType> keys() const { return Span<const KeyType>(m_keys, m_count); }
+        NODISCARD ALWAYS_INLINE Span<RangeValueType> values() const { return Span<RangeValueType>(m_values, m_count); }
+
+        NODISCARD ALWAYS_INLINE RangeIterator begin() const { return RangeIterator(m_keys, m_values); }
+        NODISCARD ALWAYS_INLINE RangeIterator end() const { return RangeIterator(m_keys + m_count, m_values + m_count); }
+
+    private:
+        const KeyType* m_keys;
+        RangeValueType* m_values;
+        usize m_count;
+    };
+
+    using Range = RangeView<ValueType>;
+    using ConstRange = RangeView<const ValueType>;
+
+public:
+    //
+    // Creates a map from two parallel sequences of keys and values that can be in any order.
+    // The entries are sorted once and the duplicated keys are removed, which is much faster than adding them one by one.
+    // NOTE: If a key is present multiple times, only its first occurrence (and the associated value) will be added.
+    //
+    NODISCARD static FlatMap create_from_unsorted(Span<const KeyType> keys, Span<const ValueType> values)
+    {
+        AT_ASSERT(keys.count() == values.count());
+
+        // Sort the entry indices instead of the entries themselves, so the keys and values are moved only once.
+        Vector<usize> sorted_indices = Vector<usize>::create_with_initial_capacity(keys.count());
+        for (usize index = 0; index < keys.count(); ++index) {
+            sorted_indices.add(index);
+        }
+
+        // NOTE: Using a stable sort guarantees that the first occurrence of a duplicated key comes first.
+        const KeyType* key_elements = keys.elements();
+        AT::stable_sort(sorted_indices.span(), [key_elements](usize a, usize b) { return key_elements[a] < key_elements[b]; });
+
+        FlatMap map;
+        map.m_keys.ensure_fixed_capacity(keys.count());
+        map.m_values.ensure_fixed_capacity(keys.count());
+
+        for (const usize index : sorted_indices) {
+            if (map.m_keys.has_elements() && !(map.m_keys.last() < key_elements[index])) {
+                // The key is a duplicate of the previously added one.
+                continue;
+            }
+
+            map.m_keys.add(key_elements[index]);
+            map.m_values.add(values.elements()[index]);
+        }
+
+        map.shrink_to_fit();
+        return map;
+    }
+
+public:
+    FlatMap() = default;
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_keys.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_keys.is_empty(); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return m_keys.has_elements(); }
+
+    // NOTE: The keys are sorted in ascending order and the values are stored in the same order as their keys.
+    NODISCARD ALWAYS_INLINE Span<const KeyType> keys() const { return m_keys.span(); }
+    NODISCARD ALWAYS_INLINE Span<ValueType> values() { return m_values.span(); }
+    NODISCARD ALWAYS_INLINE Span<const ValueType> values() const { return m_values.span(); }
+
+public:
+    NODISCARD ALWAYS_INLINE Optional<usize> find(const KeyType& key) const
+    {
+        const usize index = AT::binary_search(m_keys.span(), key);
+        if (index == invalid_size) {
+            return {};
+        }
+        return index;
+    }
+
+    NODISCARD ALWAYS_INLINE bool contains(const KeyType& key) const { return find(key).has_value(); }
+
+    NODISCARD ALWAYS_INLINE Optional<ValueType&> get_if_exists(const KeyType& key)
+    {
+        const Optional<usize> index = find(key);
+        if (index.has_value()) {
+            return m_values[*index];
+        }
+        return {};
+    }
+
+    NODISCARD ALWAYS_INLINE Optional<const ValueType&> get_if_exists(const KeyType& key) const
+    {
+        const Optional<usize> index = find(key);
+        if (index.has_value()) {
+            return m_values[*index];
+        }
+        return {};
+    }
+
+    NODISCARD ALWAYS_INLINE ValueType& at(const KeyType& key)
+    {
+        auto optional_value = get_if_exists(key);
+        AT_ASSERT(optional_value.has_value());
+        return *optional_value;
+    }
+
+    NODISCARD ALWAYS_INLINE const ValueType& at(const KeyType& key) const
+    {
+        auto optional_value = get_if_exists(key);
+        AT_ASSERT(optional_value.has_value());
+        return *optional_value;
+    }
+
+    // Returns the index of the first key that is not less than the given key.
+    NODISCARD ALWAYS_INLINE usize lower_bound(const KeyType& key) const { return AT::lower_bound(m_keys.span(), key); }
+    // Returns the index of the first key that is greater than the given key.
+    NODISCARD ALWAYS_INLINE usize upper_bound(const KeyType& key) const { return AT::upper_bound(m_keys.span(), key); }
+
+    //
+    // Returns the entries whose keys are in the [lower_key, upper_key) interval, in ascending key order.
+    //
+    NODISCARD ALWAYS_INLINE Range range(const KeyType& lower_key, const KeyType& upper_key)
+    {
+        const usize first_index = lower_bound(lower_key);
+        const usize last_index = max_index(first_index, lower_bound(upper_key));
+        return Range(m_keys.elements() + first_index, m_values.elements() + first_index, last_index - first_index);
+    }
+
+    NODISCARD ALWAYS_INLINE ConstRange range(const KeyType& lower_key, const KeyType& upper_key) const
+    {
+        const usize first_index = lower_bound(lower_key);
+        const usize last_index = max_index(first_index, lower_bound(upper_key));
+        return ConstRange(m_keys.elements() + first_index, m_values.elements() + first_index, last_index - first_index);
+    }
+
+public:
+    ALWAYS_INLINE void add(const KeyType& key, const ValueType& value)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, key);
+        m_values.insert(index, value);
+    }
+
+    ALWAYS_INLINE void add(const KeyType& key, ValueType&& value)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, key);
+        m_values.insert(index, move(value));
+    }
+
+    ALWAYS_INLINE void add(KeyType&& key, const ValueType& value)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, move(key));
+        m_values.insert(index, value);
+    }
+
+    ALWAYS_INLINE void add(KeyType&& key, ValueType&& value)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, move(key));
+        m_values.insert(index, move(value));
+    }
+
+    template<typename... Args>
+    ALWAYS_INLINE void emplace(const KeyType& key, Args&&... args)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, key);
+        m_values.emplace_at(index, forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    ALWAYS_INLINE void emplace(KeyType&& key, Args&&... args)
+    {
+        const usize index = insertion_index_for_new_key(key);
+        m_keys.insert(index, move(key));
+        m_values.emplace_at(index, forward<Args>(args)...);
+    }
+
+    ALWAYS_INLINE FlatMapAddResult add_if_not_existing(const KeyType& key, const ValueType& value)
+    {
+        const usize index = lower_bound(key);
+        if (index < m_keys.count() && !(key < m_keys[index])) {
+            return FlatMapAddResult::KeyAlreadyExists;
+        }
+
+        m_keys.insert(index, key);
+        m_values.insert(index, value);
+        return FlatMapAddResult::InsertedNewKey;
+    }
+
+    ALWAYS_INLINE ValueType& get_or_add(const KeyType& key)
+    {
+        const usize index = lower_bound(key);
+        if (index < m_keys.count() && !(key < m_keys[index])) {
+            // NOTE: The key already exists, so no more action is needed.
+            return m_values[index];
+        }
+
+        m_keys.insert(index, key);
+        return m_values.emplace_at(index);
+    }
+
+    ALWAYS_INLINE ValueType& operator[](const KeyType& key) { return get_or_add(key); }
+
+    ALWAYS_INLINE void remove(const KeyType& key)
+    {
+        const Optional<usize> optional_index = find(key);
+        AT_ASSERT(optional_index.has_value());
+        m_keys.remove(*optional_index);
+        m_values.remove(*optional_index);
+    }
+
+    ALWAYS_INLINE FlatMapRemoveResult remove_if_exists(const KeyType& key)
+    {
+        const Optional<usize> optional_index = find(key);
+        if (!optional_index.has_value()) {
+            return FlatMapRemoveResult::KeyDoesNotExist;
+        }
+
+        m_keys.remove(*optional_index);
+        m_values.remove(*optional_index);
+        return FlatMapRemoveResult::RemovedExistingKey;
+    }
+
+public:
+    ALWAYS_INLINE void clear()
+    {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    ALWAYS_INLINE void clear_and_shrink()
+    {
+        m_keys.clear_and_shrink();
+        m_values.clear_and_shrink();
+    }
+
+    ALWAYS_INLINE void shrink_to_fit()
+    {
+        m_keys.shrink_to_fit();
+        m_values.shrink_to_fit();
+    }
+
+    ALWAYS_INLINE void ensure_capacity(usize required_capacity)
+    {
+        m_keys.ensure_capacity(required_capacity);
+        m_values.ensure_capacity(required_capacity);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE Iterator begin() { return Iterator(m_keys.begin(), m_values.begin()); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return Iterator(m_keys.end(), m_values.end()); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return ConstIterator(m_keys.begin(), m_values.begin()); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return ConstIterator(m_keys.end(), m_values.end()); }
+
+private:
+    NODISCARD ALWAYS_INLINE static usize max_index(usize a, usize b) { return (a > b) ? a : b; }
+
+    NODISCARD ALWAYS_INLINE usize insertion_index_for_new_key(const KeyType& key) const
+    {
+        const usize index = lower_bound(key);
+        AT_ASSERT(index == m_keys.count() || key < m_keys[index]); // Key already exists.
+        return index;
+    }
+
+private:
+    Vector<KeyType> m_keys;
+    Vector<ValueType> m_values;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::FlatMap;
+using AT::FlatMapAddResult;
+using AT::FlatMapRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
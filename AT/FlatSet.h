@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Algorithms.h>
+#include <AT/Optional.h>
+#include <AT/Vector.h>
+
+namespace AT {
+
+enum class FlatSetAddResult {
+    InsertedNewEntry,
+    EntryAlreadyExists,
+};
+
+enum class FlatSetRemoveResult {
+    RemovedExistingEntry,
+    EntryDoesNotExist,
+};
+
+//
+// Ordered set of unique elements, stored contiguously in a sorted vector.
+// Compared to a HashTable, it has no per-slot metadata and no load factor overhead, and the elements are always
+// iterated in ascending order. Lookups are branchless binary searches, while insertions and removals are linear,
+// as the following elements have to be shifted. It is therefore ideal for small or read-mostly sets, especially
+// when they are built once using create_from_unsorted().
+// The type of the elements must provide the less-than operator, which must implement a strict weak ordering.
+//
+template<typename T>
+requires (!is_reference<T>)
+class FlatSet {
+public:
+    using ConstIterator = const T*;
+
+public:
+    //
+    // Creates a set from a sequence of elements that can be in any order.
+    // The elements are sorted once and the duplicates are removed, which is much faster than adding them one by one.
+    //
+    NODISCARD static FlatSet create_from_unsorted(Span<const T> elements)
+    {
+        FlatSet set;
+        set.m_elements = Vector<T>::create_from_span(elements);
+        if (set.m_elements.count() < 2) {
+            return set;
+        }
+
+        AT::sort(set.m_elements.span());
+
+        T* sorted_elements = set.m_elements.elements();
+        usize unique_count = 1;
+        for (usize index = 1; index < set.m_elements.count(); ++index) {
+            if (sorted_elements[unique_count - 1] < sorted_elements[index]) {
+                if (index != unique_count) {
+                    sorted_elements[unique_count] = move(sorted_elements[index]);
+                }
+                ++unique_count;
+            }
+        }
+
+        set.m_elements.remove_last(set.m_elements.count() - unique_count);
+        set.m_elements.shrink_to_fit();
+        return set;
+    }
+
+public:
+    FlatSet() = default;
+
+    // NOTE: If the list contains the same element multiple times, only one occurrence will be added.
+    ALWAYS_INLINE FlatSet(std::initializer_list<T> init_list)
+        : FlatSet(create_from_unsorted(Span<const T>(init_list.begin(), init_list.size())))
+    {}
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_elements.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_elements.is_empty(); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return m_elements.has_elements(); }
+
+    // NOTE: The elements are sorted in ascending order.
+    NODISCARD ALWAYS_INLINE Span<const T> elements() const { return m_elements.span(); }
+
+    NODISCARD ALWAYS_INLINE const T& at(usize index) const { return m_elements.at(index); }
+    NODISCARD ALWAYS_INLINE const T& operator[](usize index) const { return at(index); }
+
+public:
+    NODISCARD ALWAYS_INLINE Optional<usize> find(const T& element) const
+    {
+        const usize index = AT::binary_search(m_elements.span(), element);
+        if (index == invalid_size) {
+            return {};
+        }
+        return index;
+    }
+
+    NODISCARD ALWAYS_INLINE bool contains(const T& element) const { return find(element).has_value(); }
+
+    // Returns the index of the first element that is not less than the given value.
+    NODISCARD ALWAYS_INLINE usize lower_bound(const T& value) const { return AT::lower_bound(m_elements.span(), value); }
+    // Returns the index of the first element that is greater than the given value.
+    NODISCARD ALWAYS_INLINE usize upper_bound(const T& value) const { return AT::upper_bound(m_elements.span(), value); }
+
+    //
+    // Returns the elements that are in the [lower_value, upper_value) interval, in ascending order.
+    //
+    NODISCARD ALWAYS_INLINE Span<const T> range(const T& lower_value, const T& upper_value) const
+    {
+        const usize first_index = lower_bound(lower_value);
+        const usize last_index = lower_bound(upper_value);
+        if (last_index <= first_index) {
+            return {};
+        }
+        return m_elements.slice(first_index, last_index - first_index);
+    }
+
+public:
+    ALWAYS_INLINE void add(const T& element)
+    {
+        MAYBE_UNUSED const FlatSetAddResult result = add_if_not_existing(element);
+        AT_ASSERT(result == FlatSetAddResult::InsertedNewEntry);
+    }
+
+    ALWAYS_INLINE void add(T&& element)
+    {
+        MAYBE_UNUSED const FlatSetAddResult result = add_if_not_existing(move(element));
+        AT_ASSERT(result == FlatSetAddResult::InsertedNewEntry);
+    }
+
+    ALWAYS_INLINE FlatSetAddResult add_if_not_existing(const T& element)
+    {
+        const usize index = lower_bound(element);
+        if (index < m_elements.count() && !(element < m_elements[index])) {
+            return FlatSetAddResult::EntryAlreadyExists;
+        }
+
+        m_elements.insert(index, element);
+        return FlatSetAddResult::InsertedNewEntry;
+    }
+
+    ALWAYS_INLINE FlatSetAddResult add_if_not_existing(T&& element)
+    {
+        const usize index = lower_bound(element);
+        if (index < m_elements.count() && !(element < m_elements[index])) {
+            return FlatSetAddResult::EntryAlreadyExists;
+        }
+
+        m_elements.insert(index, move(element));
+        return FlatSetAddResult::InsertedNewEntry;
+    }
+
+    ALWAYS_INLINE void remove(const T& element)
+    {
+        const Optional<usize> optional_index = find(element);
+        AT_ASSERT(optional_index.has_value());
+        m_elements.remove(*optional_index);
+    }
+
+    ALWAYS_INLINE FlatSetRemoveResult remove_if_exists(const T& element)
+    {
+        const Optional<usize> optional_index = find(element);
+        if (!optional_index.has_value()) {
+            return FlatSetRemoveResult::EntryDoesNotExist;
+        }
+
+        m_elements.remove(*optional_index);
+        return FlatSetRemoveResult::RemovedExistingEntry;
+    }
+
+public:
+    ALWAYS_INLINE void clear() { m_elements.clear(); }
+    ALWAYS_INLINE void clear_and_shrink() { m_elements.clear_and_shrink(); }
+    ALWAYS_INLINE void shrink_to_fit() { m_elements.shrink_to_fit(); }
+    ALWAYS_INLINE void ensure_capacity(usize required_capacity) { m_elements.ensure_capacity(required_capacity); }
+
+public:
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return m_elements.begin(); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return m_elements.end(); }
+
+private:
+    Vector<T> m_elements;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::FlatSet;
+using AT::FlatSetAddResult;
+using AT::FlatSetRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/FlyString.h>
+#include <AT/MemoryOperations.h>
+#include <AT/Mutex.h>
+
+namespace AT {
+
+//
+// Open-addressing hash table (with linear probing) that stores pointers to all interned strings.
+// The strings are never removed, so no tombstones are required. The table is guarded by a mutex, but the lock is only
+// taken when a FlyString is created from a string view, never when FlyStrings are copied, compared or hashed.
+//
+class FlyStringTable {
+public:
+    static constexpr usize initial_slot_count = 256;
+
+public:
+    FlyStringTable()
+        : m_slots(nullptr)
+        , m_slot_count(0)
+        , m_string_count(0)
+    {}
+
+    const Detail::FlyStringData* intern(StringView string_view)
+    {
+        const u64 hash = string_view.hash();
+        MutexLocker locker(m_mutex);
+
+        if (m_slots == nullptr) {
+            m_slot_count = initial_slot_count;
+            m_slots = allocate_slots(m_slot_count);
+        }
+
+        usize slot_index = find_slot(m_slots, m_slot_count, string_view, hash);
+        if (m_slots[slot_index] != nullptr) {
+            return m_slots[slot_index];
+        }
+
+        // Keep the load factor below 50%, so the probe sequences remain very short.
+        if (2 * (m_string_count + 1) > m_slot_count) {
+            grow();
+            slot_index = find_slot(m_slots, m_slot_count, string_view, hash);
+        }
+
+        const Detail::FlyStringData* data = allocate_data(string_view, hash);
+        m_slots[slot_index] = data;
+        ++m_string_count;
+        return data;
+    }
+
+    const Detail::FlyStringData* find(StringView string_view)
+    {
+        const u64 hash = string_view.hash();
+        MutexLocker locker(m_mutex);
+
+        if (m_slots == nullptr) {
+            return nullptr;
+        }
+        return m_slots[find_slot(m_slots, m_slot_count, string_view, hash)];
+    }
+
+    usize string_count()
+    {
+        MutexLocker locker(m_mutex);
+        return m_string_count;
+    }
+
+private:
+    NODISCARD static usize find_slot(const Detail::FlyStringData** slots, usize slot_count, StringView string_view, u64 hash)
+    {
+        const usize slot_mask = slot_count - 1;
+        usize slot_index = hash & slot_mask;
+
+        while (slots[slot_index] != nullptr) {
+            const Detail::FlyStringData* data = slots[slot_index];
+            if (data->hash == hash && StringView::unsafe_create_from_utf8(data->characters(), data->byte_count) == string_view) {
+                break;
+            }
+            slot_index = (slot_index + 1) & slot_mask;
+        }
+
+        return slot_index;
+    }
+
+    void grow()
+    {
+        const usize new_slot_count = 2 * m_slot_count;
+        const Detail::FlyStringData** new_slots = allocate_slots(new_slot_count);
+
+        for (usize index = 0; index < m_slot_count; ++index) {
+            const Detail::FlyStringData* data = m_slots[index];
+            if (data != nullptr) {
+                usize slot_index = data->hash & (new_slot_count - 1);
+                while (new_slots[slot_index] != nullptr) {
+                    slot_index = (slot_index + 1) & (new_slot_count - 1);
+                }
+                new_slots[slot_index] = data;
+            }
+        }
+
+        ::operator delete(m_slots);
+        m_slots = new_slots;
+        m_slot_count = new_slot_count;
+    }
+
+    NODISCARD static const Detail::FlyStringData** allocate_slots(usize slot_count)
+    {
+        // NOTE: In the future we might want to use a custom memory allocator for the interned strings and the table.
+        void* memory_block = ::operator new(slot_count * sizeof(const Detail::FlyStringData*));
+        AT_ASSERT(memory_block);
+        zero_memory(memory_block, slot_count * sizeof(const Detail::FlyStringData*));
+        return static_cast<const Detail::FlyStringData**>(memory_block);
+    }
+
+    NODISCARD static const Detail::FlyStringData* allocate_data(StringView string_view, u64 hash)
+    {
+        const usize byte_count = string_view.byte_span().count();
+        void* memory_block = ::operator new(sizeof(Detail::FlyStringData) + byte_count + 1);
+        AT_ASSERT(memory_block);
+
+        Detail::FlyStringData* data = new (memory_block) Detail::FlyStringData;
+        data->hash = hash;
+        data->byte_count = byte_count;
+
+        char* characters = reinterpret_cast<char*>(data + 1);
+        copy_memory_from_span(characters, string_view.byte_span());
+        characters[byte_count] = 0;
+        return data;
+    }
+
+private:
+    Mutex m_mutex;
+    const Detail::FlyStringData** m_slots;
+    usize m_slot_count;
+    usize m_string_count;
+};
+
+static FlyStringTable& fly_string_table()
+{
+    // NOTE: Constructed on first use, so FlyStrings can be safely created during static initialization.
+    static FlyStringTable s_table;
+    return s_table;
+}
+
+FlyString FlyString::create_from_utf8(const char* characters, usize byte_count)
+{
+    StringView view = StringView::create_from_utf8(characters, byte_count);
+    return FlyString(view);
+}
+
+FlyString FlyString::create_from_utf8(const char* null_terminated_characters)
+{
+    StringView view = StringView::create_from_utf8(null_terminated_characters);
+    return FlyString(view);
+}
+
+Optional<FlyString> FlyString::find_interned(StringView string_view)
+{
+    if (string_view.is_empty()) {
+        return FlyString();
+    }
+
+    const Detail::FlyStringData* data = fly_string_table().find(string_view);
+    if (data == nullptr) {
+        return {};
+    }
+    return FlyString(data);
+}
+
+usize FlyString::interned_string_count()
+{
+    return fly_string_table().string_count();
+}
+
+FlyString::FlyString(StringView string_view)
+    : m_data(nullptr)
+{
+    if (!string_view.is_empty()) {
+        m_data = fly_string_table().intern(string_view);
+    }
+}
+
+u64 FlyString::empty_string_hash()
+{
+    static const u64 s_empty_string_hash = StringView().hash();
+    return s_empty_string_hash;
+}
+
+} // namespace AT
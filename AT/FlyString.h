@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Optional.h>
+#include <AT/String.h>
+#include <AT/StringView.h>
+#include <AT/TypeTraits.h>
+
+namespace AT {
+
+namespace Detail {
+
+//
+// The interned representation of a FlyString. It is allocated in a single memory block, the null-terminated
+// characters being stored immediately after the header. Once interned, it is never modified or released.
+//
+struct FlyStringData {
+    u64 hash;
+    usize byte_count;
+
+    NODISCARD ALWAYS_INLINE const char* characters() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+} // namespace Detail
+
+//
+// Immutable, interned UTF-8 string.
+// All FlyStrings that hold the same characters point to the same interned data, so comparing two FlyStrings is a
+// pointer comparison and hashing one returns the hash that was computed when the string was interned. Copying a
+// FlyString copies a single pointer, as the interned strings are never released.
+// This makes it ideal for identifiers that are repeated and compared often, such as class names, keys or log categories.
+// The interning table is thread-safe, so FlyStrings can be created from any thread.
+//
+// NOTE: The interned strings are never released, so only long-lived identifiers should be interned. The constructors
+//       are explicit for this reason, so a transient string is never interned by an implicit conversion. To look up or
+//       compare a transient string, use find_interned() or compare it with the view directly, which never intern it.
+//
+class FlyString {
+public:
+    AT_API static FlyString create_from_utf8(const char* characters, usize byte_count);
+    AT_API static FlyString create_from_utf8(const char* null_terminated_characters);
+
+    // Returns the FlyString that holds the given characters, only if they were already interned. Never interns them.
+    NODISCARD AT_API static Optional<FlyString> find_interned(StringView string_view);
+
+    // Returns the number of unique strings that have been interned so far.
+    NODISCARD AT_API static usize interned_string_count();
+
+public:
+    ALWAYS_INLINE FlyString()
+        : m_data(nullptr)
+    {}
+
+    AT_API explicit FlyString(StringView string_view);
+    ALWAYS_INLINE explicit FlyString(const String& string)
+        : FlyString(string.view())
+    {}
+
+    FlyString(const FlyString&) = default;
+    FlyString& operator=(const FlyString&) = default;
+
+public:
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_data == nullptr); }
+
+    NODISCARD ALWAYS_INLINE StringView view() const
+    {
+        if (!m_data) {
+            return {};
+        }
+        return StringView::unsafe_create_from_utf8(m_data->characters(), m_data->byte_count);
+    }
+
+    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span() const { return view().byte_span(); }
+
+    // For compatiblity with C-style APIs.
+    NODISCARD ALWAYS_INLINE const char* c_str() const { return m_data ? m_data->characters() : ""; }
+
+    NODISCARD ALWAYS_INLINE u64 hash() const { return m_data ? m_data->hash : empty_string_hash(); }
+
+public:
+    // NOTE: Strings with the same characters are interned only once, so comparing the pointers is enough.
+    NODISCARD ALWAYS_INLINE bool operator==(const FlyString& other) const { return (m_data == other.m_data); }
+    NODISCARD ALWAYS_INLINE bool operator!=(const FlyString& other) const { return (m_data != other.m_data); }
+
+    NODISCARD ALWAYS_INLINE bool operator==(StringView string_view) const { return (view() == string_view); }
+    NODISCARD ALWAYS_INLINE bool operator!=(StringView string_view) const { return (view() != string_view); }
+
+private:
+    ALWAYS_INLINE explicit FlyString(const Detail::FlyStringData* data)
+        : m_data(data)
+    {}
+
+    NODISCARD AT_API static u64 empty_string_hash();
+
+private:
+    // NOTE: The empty string is never interned and is represented by a null pointer.
+    const Detail::FlyStringData* m_data;
+};
+
+template<>
+struct TypeTraits<FlyString> {
+    NODISCARD ALWAYS_INLINE static u64 hash(const FlyString& value) { return value.hash(); }
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::FlyString;
+#endif // AT_INCLUDE_GLOBALLY
@@ -4,44 +4,29 @@
  */
 
 #include <AT/Format.h>
+#include <AT/Utf8.h>
 
 #define AT_FORMAT_SPECIFIER_BEGIN_TOKEN '{'
 #define AT_FORMAT_SPECIFIER_END_TOKEN   '}'
 
 namespace AT {
 
-Optional<String> FormatBuilder::release_string()
+static void consume_until_format_specifier(FormatBuilder& builder, StringView& string_format)
 {
-    // NOTE: Creating a string from a vector of characters is very wasteful. In our current implementation,
-    //       there is always an unnecessary memory allocation. If the formatted string fits in a String
-    //       inline capacity then allocating the memory for the vector is not necessary. Otherwise, memory
-    //       is allocated for both the vector and the released string even though the vector memory is
-    //       freed right after.
-    // TODO: Replace the Vector container to something else that minimizes unnecessary memory allocations.
-    //       At the moment of writing this implementation, the concept of a StringBuilder doesn't exist.
-
-    auto formatted_view = StringView::unsafe_create_from_utf8(m_formatted_string_buffer.elements(), m_formatted_string_buffer.count());
-    String formatted_string = String(formatted_view);
-    m_formatted_string_buffer.clear_and_shrink();
-    return formatted_string;
-}
-
-FormatErrorCode FormatBuilder::consume_until_format_specifier()
-{
-    usize specifier_offset = m_string_format.find(AT_FORMAT_SPECIFIER_BEGIN_TOKEN);
+    usize specifier_offset = string_format.find(AT_FORMAT_SPECIFIER_BEGIN_TOKEN);
     if (specifier_offset == StringView::invalid_position) {
-        m_formatted_string_buffer.add_span(m_string_format.byte_span().as<const char>());
-        return FormatErrorCode::Success;
+        builder.push_literal(string_format);
+        string_format = {};
+        return;
     }
 
-    m_formatted_string_buffer.add_span(m_string_format.byte_span().slice(0, specifier_offset).as<const char>());
-    m_string_format = m_string_format.slice(specifier_offset);
-    return FormatErrorCode::Success;
+    builder.push_literal(string_format.slice(0, specifier_offset));
+    string_format = string_format.slice(specifier_offset);
 }
 
-Optional<FormatBuilder::Specifier> FormatBuilder::parse_specifier()
+static Optional<FormatBuilder::Specifier> parse_specifier(StringView& string_format)
 {
-    if (m_string_format.is_empty() || m_string_format.byte_span()[0] != AT_FORMAT_SPECIFIER_BEGIN_TOKEN) {
+    if (string_format.is_empty() || string_format.byte_span()[0] != AT_FORMAT_SPECIFIER_BEGIN_TOKEN) {
         // NOTE: This function is only called when there is an argument passed to the 'format()' function
         //       that hasn't been inserted in the formatted string yet. If this codepath is reached it
         //       means that more arguments were passed to the function than required.
@@ -49,74 +34,355 @@ Optional<FormatBuilder::Specifier> FormatBuilder::parse_specifier()
     }
 
     // Advance the format string to the next character, ignoring the AT_FORMAT_SPECIFIER_BEGIN_TOKEN.
-    m_string_format = m_string_format.slice(1);
+    string_format = string_format.slice(1);
 
-    usize specifier_count = m_string_format.find(AT_FORMAT_SPECIFIER_END_TOKEN);
+    usize specifier_count = string_format.find(AT_FORMAT_SPECIFIER_END_TOKEN);
     if (specifier_count == StringView::invalid_position) {
         // NOTE: Because the format specifier doesn't have an end token the
         //       string format is considered invalid.
         return {};
     }
 
-    const StringView specifier_string = m_string_format.slice(0, specifier_count);
-    m_string_format = m_string_format.slice(specifier_count + 1);
+    const ReadonlyByteSpan specifier_bytes = string_format.slice(0, specifier_count).byte_span();
+    string_format = string_format.slice(specifier_count + 1);
+
+    FormatBuilder::Specifier specifier;
+    if (!FormatBuilder::try_parse_specifier(reinterpret_cast<const char*>(specifier_bytes.elements()), specifier_bytes.count(), specifier)) {
+        return {};
+    }
+
+    return specifier;
+}
+
+FormatErrorCode vformat(FormatBuilder& builder, FormatStringView string_format, FormatArgs arguments)
+{
+    if (string_format.is_parsed()) {
+        // NOTE: The specifiers of pre-parsed format strings were already validated at compile time.
+        for (usize argument_index = 0; argument_index < arguments.count(); ++argument_index) {
+            builder.push_literal(string_format.literal(argument_index));
+            const FormatErrorCode error_code = arguments[argument_index].format(builder, string_format.specifier(argument_index));
+            if (error_code != FormatErrorCode::Success)
+                return error_code;
+        }
+
+        builder.push_literal(string_format.literal(arguments.count()));
+        return FormatErrorCode::Success;
+    }
+
+    StringView remaining_string_format = string_format.string();
+    for (const FormatArgument& argument : arguments) {
+        consume_until_format_specifier(builder, remaining_string_format);
+
+        Optional<FormatBuilder::Specifier> specifier = parse_specifier(remaining_string_format);
+        if (!specifier.has_value() || !argument.is_valid_specifier(specifier.value()))
+            return FormatErrorCode::InvalidSpecifier;
 
-    Optional<Specifier> specifier = FormatBuilder::parse_specifier(specifier_string);
-    if (specifier.has_value())
-        return specifier.value();
-    return {};
+        const FormatErrorCode error_code = argument.format(builder, specifier.value());
+        if (error_code != FormatErrorCode::Success)
+            return error_code;
+    }
+
+    consume_until_format_specifier(builder, remaining_string_format);
+    return FormatErrorCode::Success;
 }
 
-Optional<FormatBuilder::Specifier> FormatBuilder::parse_specifier(StringView specifier_string)
+Optional<String> vformat(FormatStringView string_format, FormatArgs arguments)
 {
-    if (!specifier_string.is_empty()) {
-        // NOTE: Currently, we don't support any string format specifier!
+    StringBuilder string_builder;
+    FormatBuilder builder = FormatBuilder(string_builder);
+    if (vformat(builder, string_format, move(arguments)) != FormatErrorCode::Success)
         return {};
+
+    // NOTE: If the formatted string doesn't fit inline, the string builder heap buffer is adopted by the string,
+    //       so no additional memory allocation or copy is performed.
+    return string_builder.build();
+}
+
+FormatErrorCode vformat_to(StringBuilder& string_builder, FormatStringView string_format, FormatArgs arguments)
+{
+    FormatBuilder builder = FormatBuilder(string_builder);
+    return vformat(builder, string_format, move(arguments));
+}
+
+Optional<FormatToResult> vformat_to(WriteonlyByteSpan destination, FormatStringView string_format, FormatArgs arguments)
+{
+    FormatBuilder builder = FormatBuilder(move(destination));
+    if (vformat(builder, string_format, move(arguments)) != FormatErrorCode::Success)
+        return {};
+
+    return FormatToResult { builder.byte_count(), builder.written_byte_count() };
+}
+
+Optional<usize> vformatted_size(FormatStringView string_format, FormatArgs arguments)
+{
+    FormatBuilder builder = FormatBuilder(WriteonlyByteSpan());
+    if (vformat(builder, string_format, move(arguments)) != FormatErrorCode::Success)
+        return {};
+
+    return builder.byte_count();
+}
+
+bool FormatArgument::is_valid_specifier(const FormatBuilder::Specifier& specifier) const
+{
+    switch (m_type) {
+        case Type::UnsignedInteger:
+        case Type::SignedInteger: return specifier.is_valid_for_integer();
+        case Type::F32:
+        case Type::F64: return specifier.is_valid_for_float();
+        case Type::String: return specifier.is_valid_for_string();
+        case Type::Custom: return m_custom.formatter->is_valid_specifier(specifier);
     }
 
-    return Specifier();
+    AT_ASSERT(false);
+    return false;
 }
 
-FormatErrorCode FormatBuilder::push_unsigned_integer(const Specifier&, u64 value)
+FormatErrorCode FormatArgument::format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier) const
 {
-    // NOTE: The longest integer representation (in binary) is no longer than 64 characters.
-    char buffer[64] = {};
-    u8 digit_count = 0;
+    switch (m_type) {
+        case Type::UnsignedInteger: return builder.push_unsigned_integer(specifier, m_unsigned_integer);
+        case Type::SignedInteger: return builder.push_signed_integer(specifier, m_signed_integer);
+        case Type::F32: return builder.push_float(specifier, m_f32);
+        case Type::F64: return builder.push_float(specifier, m_f64);
+        case Type::String:
+            return builder.push_string(specifier, StringView::unsafe_create_from_utf8(m_string.characters, m_string.byte_count));
+        case Type::Custom: return m_custom.formatter->format(builder, specifier, m_custom.value);
+    }
+
+    AT_ASSERT(false);
+    return FormatErrorCode::Unknown;
+}
+
+struct Padding {
+    usize before { 0 };
+    usize after { 0 };
+};
+
+static Padding compute_padding(const FormatBuilder::Specifier& specifier, usize padding_width, FormatBuilder::Specifier::Alignment default_alignment)
+{
+    using Alignment = FormatBuilder::Specifier::Alignment;
+    const Alignment alignment = (specifier.alignment != Alignment::Default) ? specifier.alignment : default_alignment;
 
-    if (value == 0) {
-        buffer[0] = '0';
-        digit_count = 1;
+    switch (alignment) {
+        case Alignment::Left: return { 0, padding_width };
+        case Alignment::Center: return { padding_width / 2, padding_width - padding_width / 2 };
+        default: return { padding_width, 0 };
     }
-    else {
-        for (u64 temp_value = value; temp_value > 0; temp_value /= 10) {
-            ++digit_count;
-        }
+}
 
-        for (u8 digit_index = 0; digit_index < digit_count; ++digit_index) {
-            u8 digit = value % 10;
-            buffer[digit_count - digit_index - 1] = '0' + digit;
-            value /= 10;
-        }
+static FloatNotation float_notation_from_type(FormatBuilder::Specifier::Type type)
+{
+    switch (type) {
+        case FormatBuilder::Specifier::Type::Fixed: return FloatNotation::Fixed;
+        case FormatBuilder::Specifier::Type::Scientific: return FloatNotation::Scientific;
+        default: return FloatNotation::General;
     }
+}
 
-    m_formatted_string_buffer.add_span({ buffer, digit_count });
+FormatErrorCode FormatBuilder::push_unsigned_integer(const Specifier& specifier, u64 value)
+{
+    push_integer(specifier, value, false);
     return FormatErrorCode::Success;
 }
 
 FormatErrorCode FormatBuilder::push_signed_integer(const Specifier& specifier, i64 value)
 {
-    if (value < 0) {
-        m_formatted_string_buffer.add('-');
-        value = -value;
+    // NOTE: Negating the value as an unsigned integer is well defined, even for the smallest signed integer.
+    const u64 magnitude = (value < 0) ? (0 - static_cast<u64>(value)) : static_cast<u64>(value);
+    push_integer(specifier, magnitude, value < 0);
+    return FormatErrorCode::Success;
+}
+
+FormatErrorCode FormatBuilder::push_string(const Specifier& specifier, StringView value)
+{
+    const ReadonlyByteSpan bytes = value.byte_span();
+    usize byte_count = bytes.count();
+    if (specifier.has_precision()) {
+        const usize truncated_byte_count = UTF8::byte_offset_of_codepoint(bytes, specifier.precision);
+        if (truncated_byte_count != invalid_size)
+            byte_count = truncated_byte_count;
     }
 
-    return push_unsigned_integer(specifier, static_cast<u64>(value));
+    Padding padding;
+    if (specifier.width > 0) {
+        // NOTE: The width is measured in codepoints, not in bytes.
+        const usize codepoint_count = UTF8::count_codepoints(bytes.slice(0, byte_count));
+        if (codepoint_count < specifier.width)
+            padding = compute_padding(specifier, specifier.width - codepoint_count, Specifier::Alignment::Left);
+    }
+
+    write_fill(specifier.fill, padding.before);
+    write(reinterpret_cast<const char*>(bytes.elements()), byte_count);
+    write_fill(specifier.fill, padding.after);
+    return FormatErrorCode::Success;
 }
 
-FormatErrorCode FormatBuilder::push_string(const Specifier&, StringView value)
+FormatErrorCode FormatBuilder::push_float(const Specifier& specifier, f64 value)
 {
-    m_formatted_string_buffer.add_span(value.byte_span().as<const char>());
+    char characters[NumberFormatting::max_float_width];
+    const usize byte_count = NumberFormatting::write_float(
+        { reinterpret_cast<WriteonlyBytes>(characters), sizeof(characters) },
+        value,
+        float_notation_from_type(specifier.type),
+        specifier.precision
+    );
+
+    // NOTE: Infinities and NaNs are never padded with zeros. Subtracting a finite number from itself gives zero.
+    const bool is_finite = (value - value) == 0;
+    push_number_characters(specifier, characters, byte_count, is_finite ? (characters[0] == '-' ? 1 : 0) : invalid_size);
+    return FormatErrorCode::Success;
+}
+
+FormatErrorCode FormatBuilder::push_float(const Specifier& specifier, f32 value)
+{
+    char characters[NumberFormatting::max_float_width];
+    const usize byte_count = NumberFormatting::write_float(
+        { reinterpret_cast<WriteonlyBytes>(characters), sizeof(characters) },
+        value,
+        float_notation_from_type(specifier.type),
+        specifier.precision
+    );
+
+    const bool is_finite = (value - value) == 0;
+    push_number_characters(specifier, characters, byte_count, is_finite ? (characters[0] == '-' ? 1 : 0) : invalid_size);
     return FormatErrorCode::Success;
 }
 
+void FormatBuilder::push_integer(const Specifier& specifier, u64 magnitude, bool is_negative)
+{
+    u32 radix = 10;
+    StringView prefix;
+    UppercaseDigits uppercase_digits = UppercaseDigits::No;
+
+    switch (specifier.type) {
+        case Specifier::Type::Binary:
+            radix = 2;
+            prefix = "0b"sv;
+            break;
+        case Specifier::Type::Octal:
+            radix = 8;
+            // NOTE: The octal prefix would be redundant for zero, as it is a zero digit itself.
+            prefix = (magnitude != 0) ? "0"sv : ""sv;
+            break;
+        case Specifier::Type::Hexadecimal:
+            radix = 16;
+            prefix = "0x"sv;
+            break;
+        case Specifier::Type::UppercaseHexadecimal:
+            radix = 16;
+            prefix = "0X"sv;
+            uppercase_digits = UppercaseDigits::Yes;
+            break;
+        default: break;
+    }
+
+    // NOTE: The longest prefix has two characters.
+    char characters[NumberFormatting::max_integer_width + 2];
+    usize byte_count = 0;
+    if (is_negative)
+        characters[byte_count++] = '-';
+    if (specifier.alternate_form) {
+        const ReadonlyByteSpan prefix_bytes = prefix.byte_span();
+        copy_memory(characters + byte_count, prefix_bytes.elements(), prefix_bytes.count());
+        byte_count += prefix_bytes.count();
+    }
+
+    // NOTE: The zeros that pad the integer are inserted between the sign (and the prefix) and the digits.
+    const usize zero_padding_offset = byte_count;
+    const usize digit_count = NumberFormatting::unsigned_integer_width(magnitude, radix);
+    NumberFormatting::write_unsigned_integer(characters + byte_count, digit_count, magnitude, radix, uppercase_digits);
+    byte_count += digit_count;
+
+    push_number_characters(specifier, characters, byte_count, zero_padding_offset);
+}
+
+// NOTE: The zeros that pad the number are inserted at the given offset. If the offset is 'invalid_size', the number is
+//       never padded with zeros, but with the fill character instead.
+void FormatBuilder::push_number_characters(const Specifier& specifier, const char* characters, usize byte_count, usize zero_padding_offset)
+{
+    usize zero_count = 0;
+    Padding padding;
+    if (byte_count < specifier.width) {
+        const bool is_zero_padded = specifier.zero_padding && specifier.alignment == Specifier::Alignment::Default;
+        if (is_zero_padded && zero_padding_offset != invalid_size)
+            zero_count = specifier.width - byte_count;
+        else
+            padding = compute_padding(specifier, specifier.width - byte_count, Specifier::Alignment::Right);
+    }
+
+    if (zero_count == 0) {
+        write_fill(specifier.fill, padding.before);
+        write(characters, byte_count);
+        write_fill(specifier.fill, padding.after);
+        return;
+    }
+
+    write(characters, zero_padding_offset);
+    write_fill('0', zero_count);
+    write(characters + zero_padding_offset, byte_count - zero_padding_offset);
+}
+
+void FormatBuilder::write(const char* characters, usize byte_count)
+{
+    if (m_string_builder) {
+        char* destination = m_string_builder->append_uninitialized(byte_count);
+        copy_memory(destination, characters, byte_count);
+        return;
+    }
+
+    write_to_fixed_buffer(characters, byte_count);
+}
+
+void FormatBuilder::write_fill(char fill, usize count)
+{
+    if (count == 0)
+        return;
+
+    if (m_string_builder) {
+        char* destination = m_string_builder->append_uninitialized(count);
+        set_memory(destination, static_cast<u8>(fill), count);
+        return;
+    }
+
+    const usize offset = m_byte_count;
+    m_byte_count += count;
+    if (m_is_truncated)
+        return;
+
+    if (m_byte_count > m_fixed_buffer_size) {
+        // NOTE: The fill character is ASCII, so the buffer can be filled completely.
+        set_memory(m_fixed_buffer + offset, static_cast<u8>(fill), m_fixed_buffer_size - offset);
+        m_written_byte_count = m_fixed_buffer_size;
+        m_is_truncated = true;
+        return;
+    }
+
+    set_memory(m_fixed_buffer + offset, static_cast<u8>(fill), count);
+}
+
+void FormatBuilder::write_to_fixed_buffer(const char* characters, usize byte_count)
+{
+    const usize offset = m_byte_count;
+    m_byte_count += byte_count;
+    if (m_is_truncated)
+        return;
+
+    if (m_byte_count > m_fixed_buffer_size) {
+        // NOTE: Nothing is written after the first truncation, as the buffer would no longer contain a prefix of the
+        //       formatted string otherwise. The codepoint that doesn't fit completely is also discarded, so the buffer
+        //       always contains valid UTF-8.
+        usize fitting_byte_count = m_fixed_buffer_size - offset;
+        while (fitting_byte_count > 0 && (static_cast<u8>(characters[fitting_byte_count]) & 0xC0) == 0x80) {
+            --fitting_byte_count;
+        }
+
+        copy_memory(m_fixed_buffer + offset, characters, fitting_byte_count);
+        m_written_byte_count = offset + fitting_byte_count;
+        m_is_truncated = true;
+        return;
+    }
+
+    copy_memory(m_fixed_buffer + offset, characters, byte_count);
+}
+
 } // namespace AT
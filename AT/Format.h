@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include <AT/Array.h>
+#include <AT/Error.h>
+#include <AT/HashMap.h>
 #include <AT/Optional.h>
 #include <AT/Span.h>
 #include <AT/String.h>
+#include <AT/StringBuilder.h>
 #include <AT/Types.h>
 #include <AT/Vector.h>
 
@@ -25,31 +29,263 @@ class FormatBuilder {
     AT_MAKE_NONMOVABLE(FormatBuilder);
 
 public:
-    struct Specifier {};
+    //
+    // The format specifier grammar, where every component is optional (so an empty specifier is also valid):
+    //     ':' [[fill] alignment] ['#'] ['0'] [width] ['.' precision] [type]
+    //
+    // The alignment is '<' (left), '>' (right) or '^' (center), and the fill character is any ASCII character except the
+    // braces (a space by default). Numbers are aligned to the right by default and strings to the left. The width is
+    // the minimum number of codepoints that are written. The '0' flag pads numbers with zeros, inserted after the sign
+    // and the radix prefix, and it is ignored when an alignment is given. The '#' flag writes the radix prefix of an
+    // integer ("0b", "0", "0x" or "0X").
+    //
+    // The precision is the number of digits of a floating-point number (see FloatNotation) or the maximum number of
+    // codepoints of a string, which is truncated when it is longer. Integers don't accept a precision.
+    //
+    // The type selects the presentation of the argument:
+    //     's'                     - A string. The default for strings and booleans.
+    //     'd', 'b', 'o', 'x', 'X' - An integer in decimal (the default), binary, octal or hexadecimal.
+    //     'g', 'f', 'e'           - A floating-point number in the general (the default), fixed or scientific notation.
+    //
+    // Examples: '{:>8}', '{:*^12}', '{:08x}', '{:#b}', '{:.3}', '{:10.2f}', '{:.5s}'.
+    //
+    struct Specifier {
+        enum class Alignment : u8 {
+            Default,
+            Left,
+            Right,
+            Center,
+        };
+
+        enum class Type : u8 {
+            Default,
+            String,
+            Decimal,
+            Binary,
+            Octal,
+            Hexadecimal,
+            UppercaseHexadecimal,
+            General,
+            Fixed,
+            Scientific,
+        };
+
+        static constexpr u32 no_precision = NumberFormatting::shortest_round_trip_precision;
+        static constexpr u32 max_width = 0xFFFF;
+
+        NODISCARD ALWAYS_INLINE constexpr bool has_precision() const { return (precision != no_precision); }
+
+        // NOTE: Used by the formatters that write a placeholder (such as "none") instead of their value.
+        NODISCARD ALWAYS_INLINE constexpr Specifier padding_only() const
+        {
+            Specifier specifier;
+            specifier.width = width;
+            specifier.fill = fill;
+            specifier.alignment = alignment;
+            return specifier;
+        }
+
+        // NOTE: Used by the built-in formatters to validate their specifiers, at compile time when possible.
+        NODISCARD constexpr bool is_valid_for_integer() const
+        {
+            const bool is_integer_type = type == Type::Default || type == Type::Decimal || type == Type::Binary || type == Type::Octal ||
+                                         type == Type::Hexadecimal || type == Type::UppercaseHexadecimal;
+            return is_integer_type && !has_precision();
+        }
+
+        NODISCARD constexpr bool is_valid_for_float() const
+        {
+            const bool is_float_type = type == Type::Default || type == Type::General || type == Type::Fixed || type == Type::Scientific;
+            return is_float_type && !alternate_form;
+        }
+
+        NODISCARD constexpr bool is_valid_for_string() const
+        {
+            const bool is_string_type = type == Type::Default || type == Type::String;
+            return is_string_type && !alternate_form && !zero_padding;
+        }
+
+        // NOTE: The members are packed in 8 bytes, as a pre-parsed format string stores one specifier per argument.
+        u32 precision { no_precision };
+        u16 width { 0 };
+        char fill { ' ' };
+        Alignment alignment : 2 { Alignment::Default };
+        Type type : 4 { Type::Default };
+        bool alternate_form : 1 { false };
+        bool zero_padding : 1 { false };
+    };
+    static_assert(sizeof(Specifier) == 8);
 
 public:
-    ALWAYS_INLINE FormatBuilder(StringView string_format)
-        : m_string_format(string_format)
+    // Appends the formatted characters to the string builder, which grows as required.
+    ALWAYS_INLINE explicit FormatBuilder(StringBuilder& string_builder)
+        : m_string_builder(&string_builder)
+    {}
+
+    //
+    // Writes the formatted characters to the fixed buffer. The characters that don't fit are not written, but they are
+    // still counted, so the buffer can be sized exactly when formatting is repeated. An empty buffer only counts them.
+    //
+    ALWAYS_INLINE explicit FormatBuilder(WriteonlyByteSpan fixed_buffer)
+        : m_fixed_buffer(reinterpret_cast<char*>(fixed_buffer.elements()))
+        , m_fixed_buffer_size(fixed_buffer.count())
     {}
 
 public:
-    NODISCARD AT_API Optional<String> release_string();
+    // NOTE: Only used when formatting to a fixed buffer. The byte count includes the characters that didn't fit.
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
+    NODISCARD ALWAYS_INLINE usize written_byte_count() const { return m_is_truncated ? m_written_byte_count : m_byte_count; }
+    NODISCARD ALWAYS_INLINE bool is_truncated() const { return m_is_truncated; }
+
+    //
+    // Parses the contents of a specifier (the characters between the braces). This is the single parser used both by
+    // the runtime format strings and by the format strings checked at compile time, so it must remain constexpr.
+    //
+    NODISCARD static constexpr bool try_parse_specifier(const char* characters, usize byte_count, Specifier& out_specifier)
+    {
+        if (byte_count == 0) {
+            return true;
+        }
+        if (characters[0] != ':') {
+            return false;
+        }
+
+        usize offset = 1;
+        // NOTE: The fill character can only be identified by looking ahead at the alignment that follows it.
+        if (offset + 1 < byte_count && alignment_from_character(characters[offset + 1]) != Specifier::Alignment::Default) {
+            const char fill = characters[offset];
+            if (static_cast<u8>(fill) >= 0x80 || fill == '{' || fill == '}') {
+                return false;
+            }
+            out_specifier.fill = fill;
+            out_specifier.alignment = alignment_from_character(characters[offset + 1]);
+            offset += 2;
+        }
+        else if (offset < byte_count && alignment_from_character(characters[offset]) != Specifier::Alignment::Default) {
+            out_specifier.alignment = alignment_from_character(characters[offset]);
+            ++offset;
+        }
+
+        if (offset < byte_count && characters[offset] == '#') {
+            out_specifier.alternate_form = true;
+            ++offset;
+        }
+        if (offset < byte_count && characters[offset] == '0') {
+            out_specifier.zero_padding = true;
+            ++offset;
+        }
+
+        if (offset < byte_count && is_decimal_digit(characters[offset])) {
+            u32 width = 0;
+            for (; offset < byte_count && is_decimal_digit(characters[offset]); ++offset) {
+                width = 10 * width + static_cast<u32>(characters[offset] - '0');
+                if (width > Specifier::max_width) {
+                    return false;
+                }
+            }
+            out_specifier.width = static_cast<u16>(width);
+        }
+
+        if (offset < byte_count && characters[offset] == '.') {
+            ++offset;
+            if (offset == byte_count || !is_decimal_digit(characters[offset])) {
+                return false;
+            }
 
-    AT_API FormatErrorCode consume_until_format_specifier();
-    AT_API Optional<Specifier> parse_specifier();
-    static Optional<Specifier> parse_specifier(StringView specifier_string);
+            u32 precision = 0;
+            for (; offset < byte_count && is_decimal_digit(characters[offset]); ++offset) {
+                precision = 10 * precision + static_cast<u32>(characters[offset] - '0');
+                if (precision > NumberFormatting::max_float_precision) {
+                    return false;
+                }
+            }
+            out_specifier.precision = precision;
+        }
+
+        if (offset < byte_count) {
+            switch (characters[offset++]) {
+                case 's': out_specifier.type = Specifier::Type::String; break;
+                case 'd': out_specifier.type = Specifier::Type::Decimal; break;
+                case 'b': out_specifier.type = Specifier::Type::Binary; break;
+                case 'o': out_specifier.type = Specifier::Type::Octal; break;
+                case 'x': out_specifier.type = Specifier::Type::Hexadecimal; break;
+                case 'X': out_specifier.type = Specifier::Type::UppercaseHexadecimal; break;
+                case 'g': out_specifier.type = Specifier::Type::General; break;
+                case 'f': out_specifier.type = Specifier::Type::Fixed; break;
+                case 'e': out_specifier.type = Specifier::Type::Scientific; break;
+                default: return false;
+            }
+        }
+
+        return (offset == byte_count);
+    }
+
+    // Appends a literal segment of the format string.
+    ALWAYS_INLINE void push_literal(StringView literal)
+    {
+        if (m_string_builder) {
+            m_string_builder->append(literal);
+            return;
+        }
+
+        const ReadonlyByteSpan literal_bytes = literal.byte_span();
+        write_to_fixed_buffer(reinterpret_cast<const char*>(literal_bytes.elements()), literal_bytes.count());
+    }
 
     AT_API FormatErrorCode push_unsigned_integer(const Specifier& specifier, u64 value);
     AT_API FormatErrorCode push_signed_integer(const Specifier& specifier, i64 value);
     AT_API FormatErrorCode push_string(const Specifier& specifier, StringView value);
+    AT_API FormatErrorCode push_float(const Specifier& specifier, f64 value);
+    AT_API FormatErrorCode push_float(const Specifier& specifier, f32 value);
+
+private:
+    NODISCARD ALWAYS_INLINE static constexpr bool is_decimal_digit(char character) { return ('0' <= character && character <= '9'); }
+
+    NODISCARD ALWAYS_INLINE static constexpr Specifier::Alignment alignment_from_character(char character)
+    {
+        switch (character) {
+            case '<': return Specifier::Alignment::Left;
+            case '>': return Specifier::Alignment::Right;
+            case '^': return Specifier::Alignment::Center;
+            default: return Specifier::Alignment::Default;
+        }
+    }
+
+    AT_API void write_to_fixed_buffer(const char* characters, usize byte_count);
+    void write(const char* characters, usize byte_count);
+    void write_fill(char fill, usize count);
+
+    void push_integer(const Specifier& specifier, u64 magnitude, bool is_negative);
+    void push_number_characters(const Specifier& specifier, const char* characters, usize byte_count, usize zero_padding_offset);
 
 private:
-    StringView m_string_format;
-    Vector<char> m_formatted_string_buffer;
+    // NOTE: Exactly one of the outputs is used, depending on the constructor.
+    StringBuilder* m_string_builder { nullptr };
+    char* m_fixed_buffer { nullptr };
+    usize m_fixed_buffer_size { 0 };
+
+    usize m_byte_count { 0 };
+    usize m_written_byte_count { 0 };
+    bool m_is_truncated { false };
+};
+
+//
+// The result of formatting to a fixed buffer. When the formatted string doesn't fit, it is truncated at a codepoint
+// boundary (so the written characters are always valid UTF-8) and the byte count is the size the buffer would require.
+//
+struct FormatToResult {
+    usize byte_count { 0 };
+    usize written_byte_count { 0 };
+
+    NODISCARD ALWAYS_INLINE bool is_truncated() const { return (written_byte_count < byte_count); }
 };
 
 template<typename T>
 struct Formatter {
+    // NOTE: Only the unspecialized formatter declares this member, which allows detecting at compile time whether a
+    //       type can be formatted.
+    static constexpr bool is_unspecialized = true;
+
     ALWAYS_INLINE static FormatErrorCode format(FormatBuilder&, const FormatBuilder::Specifier&, const T&)
     {
         // TODO: Maybe we should signal that the Formatter<T> isn't specialized by gracefully returning an error code?
@@ -61,6 +297,8 @@ struct Formatter {
 template<typename T>
 requires (is_integral<T>)
 struct Formatter<T> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_integer(); }
+
     ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const T& value)
     {
         if constexpr (is_signed_integral<T>)
@@ -70,16 +308,40 @@ struct Formatter<T> {
     }
 };
 
+template<>
+struct Formatter<f32> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_float(); }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const f32& value)
+    {
+        return builder.push_float(specifier, value);
+    }
+};
+
+template<>
+struct Formatter<f64> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_float(); }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const f64& value)
+    {
+        return builder.push_float(specifier, value);
+    }
+};
+
 template<>
 struct Formatter<bool> {
-    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier&, const bool& value)
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_string(); }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const bool& value)
     {
-        return builder.push_string({}, value ? "true"sv : "false"sv);
+        return builder.push_string(specifier, value ? "true"sv : "false"sv);
     }
 };
 
 template<>
 struct Formatter<StringView> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_string(); }
+
     ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const StringView& value)
     {
         return builder.push_string(specifier, value);
@@ -88,6 +350,8 @@ struct Formatter<StringView> {
 
 template<>
 struct Formatter<String> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_string(); }
+
     ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const String& value)
     {
         return builder.push_string(specifier, value.view());
@@ -96,46 +360,639 @@ struct Formatter<String> {
 
 namespace Detail {
 
-NODISCARD ALWAYS_INLINE FormatErrorCode format(FormatBuilder& builder)
+template<typename T>
+constexpr bool is_formattable = !requires { Formatter<T>::is_unspecialized; };
+
+// NOTE: Formatters that don't declare an 'is_valid_specifier()' function accept any specifier.
+template<typename T>
+NODISCARD constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
 {
-    return builder.consume_until_format_specifier();
+    if constexpr (requires { Formatter<T>::is_valid_specifier(specifier); })
+        return Formatter<T>::is_valid_specifier(specifier);
+    else
+        return true;
 }
 
-template<typename T, typename... Args>
-NODISCARD ALWAYS_INLINE FormatErrorCode format(FormatBuilder& builder, const T& argument, Args&&... other_arguments)
+// NOTE: Not constexpr on purpose. Calling it while a format string is checked at compile time stops the compilation,
+//       and the compiler error shows the message (alongside the call stack that leads to it).
+void format_string_error(const char* message);
+
+// A literal of a pre-parsed format string, followed by the specifier of the next argument (if there is one).
+struct FormatSegment {
+    usize literal_offset { 0 };
+    usize literal_byte_count { 0 };
+    FormatBuilder::Specifier specifier {};
+};
+
+} // namespace Detail
+
+//
+// Options of the formatters of ranges (spans, vectors, arrays and hash maps). The specifier given to a range applies to
+// each of its elements (to each value, in the case of hash maps), so '{:02x}' formats a span of bytes as hexadecimal
+// pairs. Once 'max_element_count' elements are written, the remaining ones are replaced by a single "...".
+//
+struct FormatRangeOptions {
+    StringView opening;
+    StringView closing;
+    StringView separator;
+    usize max_element_count;
+};
+
+namespace Detail {
+
+template<typename RangeType, typename FormatElementFunction>
+FormatErrorCode format_range(FormatBuilder& builder, const FormatRangeOptions& options, const RangeType& range, FormatElementFunction format_element)
 {
-    FormatErrorCode error_code = builder.consume_until_format_specifier();
-    if (error_code != FormatErrorCode::Success)
-        return error_code;
+    builder.push_literal(options.opening);
+    usize element_index = 0;
+    for (const auto& element : range) {
+        if (element_index > 0) {
+            builder.push_literal(options.separator);
+        }
+        if (element_index == options.max_element_count) {
+            builder.push_literal("..."sv);
+            break;
+        }
 
-    Optional<FormatBuilder::Specifier> format_specifier = builder.parse_specifier();
-    if (!format_specifier.has_value())
-        return FormatErrorCode::InvalidSpecifier;
+        const FormatErrorCode error_code = format_element(element);
+        if (error_code != FormatErrorCode::Success) {
+            return error_code;
+        }
+        ++element_index;
+    }
+    builder.push_literal(options.closing);
+    return FormatErrorCode::Success;
+}
+
+template<typename ElementType>
+struct SequenceFormatter {
+    static constexpr FormatRangeOptions default_options = { "["sv, "]"sv, ", "sv, invalid_size };
+
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        return Detail::is_valid_specifier<ElementType>(specifier);
+    }
+
+    template<typename RangeType>
+    static FormatErrorCode format(
+        FormatBuilder& builder,
+        const FormatBuilder::Specifier& specifier,
+        const RangeType& range,
+        const FormatRangeOptions& options = default_options
+    )
+    {
+        return format_range(builder, options, range, [&](const ElementType& element) {
+            return Formatter<ElementType>::format(builder, specifier, element);
+        });
+    }
+};
+
+} // namespace Detail
+
+template<typename T>
+struct Formatter<Span<T>> : public Detail::SequenceFormatter<RemoveConst<T>> {};
+
+template<typename T>
+struct Formatter<Vector<T>> : public Detail::SequenceFormatter<T> {};
 
-    error_code = Formatter<T>::format(builder, format_specifier, argument);
-    if (error_code != FormatErrorCode::Success)
-        return error_code;
+template<typename T, usize inline_count>
+struct Formatter<Array<T, inline_count>> : public Detail::SequenceFormatter<T> {};
 
-    return format(builder, forward<Args>(other_arguments)...);
+template<typename KeyType, typename ValueType, typename KeyTraits>
+struct Formatter<HashMap<KeyType, ValueType, KeyTraits>> {
+    static_assert(Detail::is_formattable<RemoveConst<KeyType>>, "No Formatter<T> specialization exists for the key type!");
+
+    static constexpr FormatRangeOptions default_options = { "{"sv, "}"sv, ", "sv, invalid_size };
+
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        return Detail::is_valid_specifier<ValueType>(specifier);
+    }
+
+    // NOTE: The keys are always formatted with the default specifier.
+    static FormatErrorCode format(
+        FormatBuilder& builder,
+        const FormatBuilder::Specifier& specifier,
+        const HashMap<KeyType, ValueType, KeyTraits>& hash_map,
+        const FormatRangeOptions& options = default_options
+    )
+    {
+        const FormatBuilder::Specifier key_specifier;
+        return Detail::format_range(builder, options, hash_map, [&](const auto& pair) {
+            const FormatErrorCode error_code = Formatter<RemoveConst<KeyType>>::format(builder, key_specifier, pair.key);
+            if (error_code != FormatErrorCode::Success) {
+                return error_code;
+            }
+            builder.push_literal(": "sv);
+            return Formatter<ValueType>::format(builder, specifier, pair.value);
+        });
+    }
+};
+
+//
+// A range that is formatted with a custom separator, without the opening and closing brackets, and optionally truncated
+// after a number of elements. The range is referenced (not copied), so it must outlive the format call:
+//     dbgln("Entity components: {}", format_joined(component_names, " | "sv, 8));
+//
+template<typename RangeType>
+struct FormatJoinedRange {
+    const RangeType& range;
+    StringView separator;
+    usize max_element_count;
+};
+
+template<typename RangeType>
+NODISCARD ALWAYS_INLINE FormatJoinedRange<RangeType>
+format_joined(const RangeType& range, StringView separator, usize max_element_count = invalid_size)
+{
+    return { range, separator, max_element_count };
 }
 
+template<typename RangeType>
+struct Formatter<FormatJoinedRange<RangeType>> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        return Detail::is_valid_specifier<RangeType>(specifier);
+    }
+
+    ALWAYS_INLINE static FormatErrorCode
+    format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const FormatJoinedRange<RangeType>& joined_range)
+    {
+        const FormatRangeOptions options = { {}, {}, joined_range.separator, joined_range.max_element_count };
+        return Formatter<RangeType>::format(builder, specifier, joined_range.range, options);
+    }
+};
+
+template<typename T>
+struct Formatter<Optional<T>> {
+    using ValueType = RemoveConstReference<T>;
+
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        return Detail::is_valid_specifier<ValueType>(specifier);
+    }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const Optional<T>& optional)
+    {
+        if (!optional.has_value()) {
+            return builder.push_string(specifier.padding_only(), "none"sv);
+        }
+        return Formatter<ValueType>::format(builder, specifier, optional.value());
+    }
+};
+
+namespace Detail {
+
+// NOTE: Generated from the same list as the error codes, so the table is indexed by the error code.
+constexpr StringView error_code_names[] = {
+    "Unknown"sv,
+#define AT_ERROR_CODE_NAME(name) StringView::unsafe_create_from_utf8(#name, sizeof(#name) - 1),
+    AT_ENUMERATE_ERROR_CODES(AT_ERROR_CODE_NAME)
+#undef AT_ERROR_CODE_NAME
+};
+
+} // namespace Detail
+
+// Errors are formatted as the name of their code (such as "FileNotFound") or as their message.
+template<>
+struct Formatter<Error> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_string(); }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const Error& error)
+    {
+        switch (error.kind()) {
+            case Error::Kind::Code: {
+                const usize code_index = static_cast<usize>(error.code());
+                AT_ASSERT(code_index < sizeof(Detail::error_code_names) / sizeof(Detail::error_code_names[0]));
+                return builder.push_string(specifier, Detail::error_code_names[code_index]);
+            }
+
+            case Error::Kind::StringLiteral: {
+                return builder.push_string(specifier, StringView::create_from_utf8(error.string_literal()));
+            }
+
+            case Error::Kind::StringAllocated: {
+                const StringView message = StringView::create_from_utf8(error.string_allocated_characters(), error.string_allocated_byte_count());
+                return builder.push_string(specifier, message);
+            }
+        }
+
+        return FormatErrorCode::Unknown;
+    }
+};
+
+// NOTE: The specifier applies to the value. An error is formatted only with the fill, alignment and width of it.
+template<typename T>
+struct Formatter<ErrorOr<T>> {
+    using ValueType = RemoveConstReference<T>;
+
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        return Detail::is_valid_specifier<ValueType>(specifier);
+    }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const ErrorOr<T>& error_or)
+    {
+        if (error_or.is_error()) {
+            return Formatter<Error>::format(builder, specifier.padding_only(), error_or.error());
+        }
+        return Formatter<ValueType>::format(builder, specifier, error_or.value());
+    }
+};
+
+template<>
+struct Formatter<ErrorOr<void>> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier) { return specifier.is_valid_for_string(); }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const ErrorOr<void>& error_or)
+    {
+        if (error_or.is_error()) {
+            return Formatter<Error>::format(builder, specifier, error_or.error());
+        }
+        return builder.push_string(specifier, "ok"sv);
+    }
+};
+
+//
+// Pointers are formatted as their address, in hexadecimal and with the radix prefix (such as "0x7ffd5c8e4a10"). The
+// specifier may only select the uppercase hexadecimal type or add padding. Character pointers are not formatted, as
+// they would be ambiguous with null-terminated strings (which must be wrapped in a StringView instead).
+//
+template<typename T>
+requires (!is_same<RemoveConst<T>, char>)
+struct Formatter<T*> {
+    NODISCARD static constexpr bool is_valid_specifier(const FormatBuilder::Specifier& specifier)
+    {
+        using Type = FormatBuilder::Specifier::Type;
+        const bool is_pointer_type = specifier.type == Type::Default || specifier.type == Type::Hexadecimal ||
+                                     specifier.type == Type::UppercaseHexadecimal;
+        return is_pointer_type && specifier.is_valid_for_integer();
+    }
+
+    ALWAYS_INLINE static FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, T* const& pointer)
+    {
+        FormatBuilder::Specifier address_specifier = specifier;
+        if (address_specifier.type == FormatBuilder::Specifier::Type::Default) {
+            address_specifier.type = FormatBuilder::Specifier::Type::Hexadecimal;
+        }
+        address_specifier.alternate_form = true;
+        return builder.push_unsigned_integer(address_specifier, reinterpret_cast<uintptr>(pointer));
+    }
+};
+
+//
+// Format string whose specifiers are validated against the types of the arguments at compile time. The string is also
+// split at compile time into literal segments and specifier slots, so formatting only appends the segments and the
+// formatted arguments, in order. Format functions take it as 'CheckedFormatString<Args...>', so passing a string
+// literal as the format is enough for it to be checked:
+//     format("Entity {} has {} components", entity_index, component_count); // OK.
+//     format("Entity {} has {} components", entity_index);                  // ERROR: Fewer arguments than specifiers.
+//
+template<typename... Args>
+class FormatString {
+    static_assert((Detail::is_formattable<Args> && ...), "No Formatter<T> specialization exists for one of the arguments!");
+
+public:
+    static constexpr usize argument_count = sizeof...(Args);
+
+public:
+    template<usize N>
+    consteval FormatString(const char (&string_literal)[N])
+        : m_characters(string_literal)
+    {
+        // NOTE: The string literal includes the null-termination byte.
+        constexpr usize byte_count = N - 1;
+        // NOTE: The last element only exists because arrays can't be empty.
+        constexpr bool (*specifier_validators[])(const FormatBuilder::Specifier&) = { &Detail::is_valid_specifier<Args>..., nullptr };
+
+        usize literal_offset = 0;
+        usize specifier_index = 0;
+        for (usize offset = 0; offset < byte_count; ++offset) {
+            if (string_literal[offset] != '{') {
+                continue;
+            }
+
+            if (specifier_index == argument_count) {
+                Detail::format_string_error("The format string has more specifiers than arguments!");
+            }
+
+            usize specifier_end_offset = offset + 1;
+            while (specifier_end_offset < byte_count && string_literal[specifier_end_offset] != '}') {
+                ++specifier_end_offset;
+            }
+            if (specifier_end_offset == byte_count) {
+                Detail::format_string_error("The format string has a specifier without an end token!");
+            }
+
+            Detail::FormatSegment& segment = m_segments[specifier_index++];
+            segment.literal_offset = literal_offset;
+            segment.literal_byte_count = offset - literal_offset;
+
+            const char* specifier_characters = string_literal + offset + 1;
+            const usize specifier_byte_count = specifier_end_offset - offset - 1;
+            if (!FormatBuilder::try_parse_specifier(specifier_characters, specifier_byte_count, segment.specifier)) {
+                Detail::format_string_error("The format string has an invalid specifier!");
+            }
+            if (!specifier_validators[specifier_index - 1](segment.specifier)) {
+                Detail::format_string_error("The format string has a specifier that is not valid for the type of its argument!");
+            }
+
+            literal_offset = specifier_end_offset + 1;
+            offset = specifier_end_offset;
+        }
+
+        if (specifier_index != argument_count) {
+            Detail::format_string_error("The format string has fewer specifiers than arguments!");
+        }
+
+        m_segments[argument_count].literal_offset = literal_offset;
+        m_segments[argument_count].literal_byte_count = byte_count - literal_offset;
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE constexpr const char* characters() const { return m_characters; }
+
+    // NOTE: There is one more segment than arguments, as the last literal follows the last specifier.
+    NODISCARD ALWAYS_INLINE constexpr const Detail::FormatSegment* segments() const { return m_segments; }
+
+private:
+    const char* m_characters;
+    Detail::FormatSegment m_segments[argument_count + 1];
+};
+
+// NOTE: The argument types are only used to check the format string, so they must not participate in the deduction.
+template<typename... Args>
+using CheckedFormatString = FormatString<RemoveConstReference<Args>...>;
+
+//
+// A format string with the types of its arguments erased. It is either a runtime string, which is parsed while it is
+// formatted, or a string that was checked and pre-parsed at compile time.
+//
+class FormatStringView {
+public:
+    ALWAYS_INLINE FormatStringView(StringView string_format)
+        : m_characters(reinterpret_cast<const char*>(string_format.byte_span().elements()))
+        , m_byte_count(string_format.byte_span().count())
+    {}
+
+    template<typename... Args>
+    ALWAYS_INLINE FormatStringView(const FormatString<Args...>& string_format)
+        : m_characters(string_format.characters())
+        , m_segments(string_format.segments())
+    {}
+
+public:
+    NODISCARD ALWAYS_INLINE bool is_parsed() const { return (m_segments != nullptr); }
+
+    // NOTE: Only valid for runtime format strings.
+    NODISCARD ALWAYS_INLINE StringView string() const { return StringView::unsafe_create_from_utf8(m_characters, m_byte_count); }
+
+    // NOTE: Only valid for pre-parsed format strings. The literal with the index 'i' precedes the specifier with the
+    //       same index, and there is always one more literal than specifiers.
+    NODISCARD ALWAYS_INLINE StringView literal(usize index) const
+    {
+        const Detail::FormatSegment& segment = m_segments[index];
+        return StringView::unsafe_create_from_utf8(m_characters + segment.literal_offset, segment.literal_byte_count);
+    }
+
+    NODISCARD ALWAYS_INLINE const FormatBuilder::Specifier& specifier(usize index) const { return m_segments[index].specifier; }
+
+private:
+    const char* m_characters { nullptr };
+    usize m_byte_count { 0 };
+    const Detail::FormatSegment* m_segments { nullptr };
+};
+
+//
+// A format argument with its type erased. The built-in types are stored by value and tagged with their type. Any other
+// type is referenced and formatted by the functions instantiated for its Formatter<T>. The formatting code is thus not
+// instantiated for every combination of argument types, and all format calls share the same (non-template) code.
+//
+class FormatArgument {
+public:
+    enum class Type : u8 {
+        UnsignedInteger,
+        SignedInteger,
+        F32,
+        F64,
+        String,
+        Custom,
+    };
+
+    struct CustomFormatter {
+        FormatErrorCode (*format)(FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const void* value);
+        bool (*is_valid_specifier)(const FormatBuilder::Specifier& specifier);
+    };
+
+public:
+    template<typename T>
+    NODISCARD ALWAYS_INLINE static FormatArgument create(const T& value)
+    {
+        FormatArgument argument;
+        if constexpr (is_unsigned_integral<T>) {
+            argument.m_type = Type::UnsignedInteger;
+            argument.m_unsigned_integer = value;
+        }
+        else if constexpr (is_signed_integral<T>) {
+            argument.m_type = Type::SignedInteger;
+            argument.m_signed_integer = value;
+        }
+        else if constexpr (is_same<T, f32>) {
+            argument.m_type = Type::F32;
+            argument.m_f32 = value;
+        }
+        else if constexpr (is_same<T, f64>) {
+            argument.m_type = Type::F64;
+            argument.m_f64 = value;
+        }
+        else if constexpr (is_same<T, bool>) {
+            argument.m_type = Type::String;
+            argument.m_string = value ? StringValue { "true", 4 } : StringValue { "false", 5 };
+        }
+        else if constexpr (is_same<T, StringView> || is_same<T, String>) {
+            argument.m_type = Type::String;
+            argument.m_string = StringValue::create(value);
+        }
+        else {
+            argument.m_type = Type::Custom;
+            argument.m_custom = { &value, &custom_formatter<T> };
+        }
+        return argument;
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE Type type() const { return m_type; }
+
+    NODISCARD AT_API bool is_valid_specifier(const FormatBuilder::Specifier& specifier) const;
+    NODISCARD AT_API FormatErrorCode format(FormatBuilder& builder, const FormatBuilder::Specifier& specifier) const;
+
+private:
+    ALWAYS_INLINE FormatArgument() {}
+
+    struct StringValue {
+        template<typename StringType>
+        NODISCARD ALWAYS_INLINE static StringValue create(const StringType& string)
+        {
+            const ReadonlyByteSpan bytes = string.byte_span();
+            return { reinterpret_cast<const char*>(bytes.elements()), bytes.count() };
+        }
+
+        const char* characters;
+        usize byte_count;
+    };
+
+    struct CustomValue {
+        const void* value;
+        const CustomFormatter* formatter;
+    };
+
+    template<typename T>
+    static constexpr CustomFormatter custom_formatter = {
+        [](FormatBuilder& builder, const FormatBuilder::Specifier& specifier, const void* value) {
+            return Formatter<T>::format(builder, specifier, *static_cast<const T*>(value));
+        },
+        &Detail::is_valid_specifier<T>,
+    };
+
+private:
+    union {
+        u64 m_unsigned_integer;
+        i64 m_signed_integer;
+        f32 m_f32;
+        f64 m_f64;
+        StringValue m_string;
+        CustomValue m_custom;
+    };
+    Type m_type;
+};
+
+using FormatArgs = Span<const FormatArgument>;
+
+namespace Detail {
+
+// Stores the type-erased arguments for the duration of a format call. See make_format_arguments().
+template<usize ArgumentCount>
+class FormatArgumentStore {
+public:
+    template<typename... Args>
+    ALWAYS_INLINE FormatArgumentStore(const Args&... args)
+        : m_arguments { FormatArgument::create(args)... }
+    {}
+
+    ALWAYS_INLINE operator FormatArgs() const { return { m_arguments, ArgumentCount }; }
+
+private:
+    FormatArgument m_arguments[ArgumentCount];
+};
+
+// NOTE: Arrays can't be empty, so format calls without arguments have a separate store.
+template<>
+class FormatArgumentStore<0> {
+public:
+    ALWAYS_INLINE operator FormatArgs() const { return {}; }
+};
+
 } // namespace Detail
 
+//
+// Erases the types of the arguments, so they can be passed to the vformat() functions. The arguments are referenced
+// (not copied), so the returned value must not outlive the expression that it was created in.
+//
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Detail::FormatArgumentStore<sizeof...(Args)> make_format_arguments(const Args&... args)
+{
+    return Detail::FormatArgumentStore<sizeof...(Args)>(args...);
+}
+
+//
+// The non-template formatting functions, which all variadic format functions forward to. The specifiers of runtime
+// format strings are validated against the types of the arguments while formatting, returning InvalidSpecifier.
+//
+NODISCARD AT_API FormatErrorCode vformat(FormatBuilder& builder, FormatStringView string_format, FormatArgs arguments);
+
+NODISCARD AT_API Optional<String> vformat(FormatStringView string_format, FormatArgs arguments);
+NODISCARD AT_API FormatErrorCode vformat_to(StringBuilder& string_builder, FormatStringView string_format, FormatArgs arguments);
+NODISCARD AT_API Optional<FormatToResult> vformat_to(WriteonlyByteSpan destination, FormatStringView string_format, FormatArgs arguments);
+NODISCARD AT_API Optional<usize> vformatted_size(FormatStringView string_format, FormatArgs arguments);
+
 template<typename... Args>
 NODISCARD ALWAYS_INLINE Optional<String> format(StringView string_format, Args&&... args)
 {
-    FormatBuilder builder = FormatBuilder(string_format);
-    FormatErrorCode error_code = Detail::format(builder, forward<Args>(args)...);
-    if (error_code != FormatErrorCode::Success)
-        return {};
+    return vformat(string_format, make_format_arguments(args...));
+}
+
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Optional<String> format(CheckedFormatString<Args...> string_format, Args&&... args)
+{
+    return vformat(string_format, make_format_arguments(args...));
+}
+
+//
+// Appends the formatted string to the string builder. If formatting fails, the characters that were already appended
+// are not removed. Appending to a builder that is reused (or reserved using formatted_size()) never allocates memory.
+//
+template<typename... Args>
+NODISCARD ALWAYS_INLINE FormatErrorCode format_to(StringBuilder& string_builder, StringView string_format, Args&&... args)
+{
+    return vformat_to(string_builder, string_format, make_format_arguments(args...));
+}
 
-    return builder.release_string();
+template<typename... Args>
+NODISCARD ALWAYS_INLINE FormatErrorCode format_to(StringBuilder& string_builder, CheckedFormatString<Args...> string_format, Args&&... args)
+{
+    return vformat_to(string_builder, string_format, make_format_arguments(args...));
+}
+
+//
+// Writes the formatted string to the caller-provided buffer (usually on the stack), without ever allocating memory.
+// The string is not null-terminated. See FormatToResult for how truncation is reported.
+//
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Optional<FormatToResult> format_to(WriteonlyByteSpan destination, StringView string_format, Args&&... args)
+{
+    return vformat_to(move(destination), string_format, make_format_arguments(args...));
+}
+
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Optional<FormatToResult>
+format_to(WriteonlyByteSpan destination, CheckedFormatString<Args...> string_format, Args&&... args)
+{
+    return vformat_to(move(destination), string_format, make_format_arguments(args...));
+}
+
+// Computes the exact number of bytes of the formatted string, without writing it anywhere.
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Optional<usize> formatted_size(StringView string_format, Args&&... args)
+{
+    return vformatted_size(string_format, make_format_arguments(args...));
+}
+
+template<typename... Args>
+NODISCARD ALWAYS_INLINE Optional<usize> formatted_size(CheckedFormatString<Args...> string_format, Args&&... args)
+{
+    return vformatted_size(string_format, make_format_arguments(args...));
 }
 
 } // namespace AT
 
 #ifdef AT_INCLUDE_GLOBALLY
+using AT::CheckedFormatString;
 using AT::format;
+using AT::format_joined;
+using AT::format_to;
+using AT::FormatArgs;
+using AT::FormatArgument;
 using AT::FormatBuilder;
+using AT::FormatErrorCode;
+using AT::FormatJoinedRange;
+using AT::FormatRangeOptions;
+using AT::FormatString;
+using AT::FormatStringView;
+using AT::formatted_size;
 using AT::Formatter;
+using AT::FormatToResult;
+using AT::make_format_arguments;
+using AT::vformat;
+using AT::vformat_to;
+using AT::vformatted_size;
 #endif // AT_INCLUDE_GLOBALLY
@@ -75,7 +75,7 @@ enum class HashMapRemoveResult {
     KeyDoesNotExist,
 };
 
-template<typename KeyType, typename ValueType>
+template<typename KeyType, typename ValueType, typename KeyTraits = TypeTraits<RemoveConst<KeyType>>>
 requires (!is_reference<KeyType>)
 class HashMap {
 public:
@@ -83,12 +83,45 @@ public:
     public:
         Bucket() = default;
 
+        // NOTE: The key and the value are stored as raw bytes, so they must be explicitly copied or moved when the
+        //       bucket is (for example, when the table is re-allocated). Copying the bytes would leave two buckets that
+        //       own the same resources (such as the heap buffer of a string).
+        ALWAYS_INLINE Bucket(const Bucket& other)
+        {
+            new (m_key_storage) KeyType(other.key());
+            new (m_value_storage) ValueType(other.value());
+        }
+
+        ALWAYS_INLINE Bucket(Bucket&& other) noexcept
+        {
+            new (m_key_storage) KeyType(move(other.key()));
+            new (m_value_storage) ValueType(move(other.value()));
+        }
+
         ALWAYS_INLINE ~Bucket()
         {
             key().~KeyType();
             value().~ValueType();
         }
 
+        ALWAYS_INLINE Bucket& operator=(const Bucket& other)
+        {
+            if (this != &other) {
+                key() = other.key();
+                value() = other.value();
+            }
+            return *this;
+        }
+
+        ALWAYS_INLINE Bucket& operator=(Bucket&& other) noexcept
+        {
+            if (this != &other) {
+                key() = move(other.key());
+                value() = move(other.value());
+            }
+            return *this;
+        }
+
         // NOTE: The equality operator only checks the equality of the keys.
         NODISCARD ALWAYS_INLINE bool operator==(const Bucket& other) const { return (key() == other.key()); }
 
@@ -112,7 +145,12 @@ public:
         NODISCARD ALWAYS_INLINE static u64 hash(const Bucket& value)
         {
             // NOTE: The hash of a bucket only depends on the key.
-            return TypeTraits<RemoveConst<KeyType>>::hash(value.key());
+            return KeyTraits::hash(value.key());
+        }
+
+        NODISCARD ALWAYS_INLINE static bool equals(const Bucket& lhs, const Bucket& rhs)
+        {
+            return Detail::traits_equals<KeyTraits>(lhs.key(), rhs.key());
         }
     };
 
@@ -123,7 +161,7 @@ public:
     using ConstIterator = Detail::HashMapIterator<KeyType, const ValueType, InternalHashTable>;
 
 public:
-    NODISCARD ALWAYS_INLINE Optional<usize> find(const KeyType& key)
+    NODISCARD ALWAYS_INLINE Optional<usize> find(const KeyType& key) const
     {
         const Bucket& key_as_bucket = unsafe_bucket_from_key(key);
         return m_buckets.find(key_as_bucket);
@@ -133,7 +171,7 @@ public:
     {
         auto slot_index = find(key);
         if (slot_index.has_value()) {
-            return m_buckets.m_slots[slot_index];
+            return m_buckets.m_slots[slot_index.value()].value();
         }
         return {};
     }
@@ -142,7 +180,7 @@ public:
     {
         auto slot_index = find(key);
         if (slot_index.has_value()) {
-            return m_buckets.m_slots[slot_index];
+            return m_buckets.m_slots[slot_index.value()].value();
         }
         return {};
     }
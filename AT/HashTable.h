@@ -88,7 +88,7 @@ enum class HashTableRemoveResult {
 template<typename T, typename TraitsForT = TypeTraits<RemoveConst<T>>>
 requires (!is_reference<T>)
 class HashTable {
-    template<typename KeyType, typename ValueType>
+    template<typename KeyType, typename ValueType, typename KeyTraits>
     requires (!is_reference<KeyType>)
     friend class HashMap;
 
@@ -222,7 +222,7 @@ public:
     {
         if (m_occupied_slot_count == 0) {
             // No slots are occupied so the table contains no elements.
-            return false;
+            return {};
         }
 
         const u64 element_hash = get_element_hash(element);
@@ -230,7 +230,7 @@ public:
 
         usize index = get_high_hash(element_hash) % m_slot_count;
         for (usize counter = 0; counter < m_slot_count; ++counter) {
-            if (m_slots_metadata[index] == low_hash && m_slots[index] == element) {
+            if (m_slots_metadata[index] == low_hash && Detail::traits_equals<TraitsForT>(m_slots[index], element)) {
                 // The element has been found.
                 return index;
             }
@@ -458,7 +458,7 @@ private:
                     first_available_slot_index = index;
                 }
             }
-            else if (m_slots_metadata[index] == low_hash && m_slots[index] == element) {
+            else if (m_slots_metadata[index] == low_hash && Detail::traits_equals<TraitsForT>(m_slots[index], element)) {
                 return index;
             }
 
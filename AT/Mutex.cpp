@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/Assertion.h>
+#include <AT/Mutex.h>
+
+#if AT_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <pthread.h>
+#endif // AT_PLATFORM_WINDOWS
+
+namespace AT {
+
+#if AT_PLATFORM_WINDOWS
+using NativeMutex = SRWLOCK;
+#else
+using NativeMutex = pthread_mutex_t;
+#endif // AT_PLATFORM_WINDOWS
+
+static_assert(sizeof(NativeMutex) <= Mutex::native_storage_size);
+static_assert(alignof(NativeMutex) <= Mutex::native_storage_alignment);
+
+NODISCARD ALWAYS_INLINE static NativeMutex* native_mutex(u8* native_storage)
+{
+    return reinterpret_cast<NativeMutex*>(native_storage);
+}
+
+#if AT_PLATFORM_WINDOWS
+
+Mutex::Mutex()
+{
+    InitializeSRWLock(native_mutex(m_native_storage));
+}
+
+Mutex::~Mutex()
+{
+    // NOTE: Slim reader/writer locks don't have to be destroyed.
+}
+
+void Mutex::lock()
+{
+    AcquireSRWLockExclusive(native_mutex(m_native_storage));
+}
+
+void Mutex::unlock()
+{
+    ReleaseSRWLockExclusive(native_mutex(m_native_storage));
+}
+
+#else
+
+Mutex::Mutex()
+{
+    const int result = pthread_mutex_init(native_mutex(m_native_storage), nullptr);
+    AT_ASSERT(result == 0);
+}
+
+Mutex::~Mutex()
+{
+    pthread_mutex_destroy(native_mutex(m_native_storage));
+}
+
+void Mutex::lock()
+{
+    const int result = pthread_mutex_lock(native_mutex(m_native_storage));
+    AT_ASSERT(result == 0);
+}
+
+void Mutex::unlock()
+{
+    const int result = pthread_mutex_unlock(native_mutex(m_native_storage));
+    AT_ASSERT(result == 0);
+}
+
+#endif // AT_PLATFORM_WINDOWS
+
+} // namespace AT
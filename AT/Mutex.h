@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Types.h>
+
+namespace AT {
+
+//
+// Lock that guards data shared between threads, implemented using the native primitive of the platform.
+// The native mutex is stored inline, so the platform headers are only included by the implementation file.
+//
+class Mutex {
+    AT_MAKE_NONCOPYABLE(Mutex);
+    AT_MAKE_NONMOVABLE(Mutex);
+
+public:
+    // NOTE: Large enough (and aligned enough) to store the native mutex of all supported platforms.
+    static constexpr usize native_storage_size = 64;
+    static constexpr usize native_storage_alignment = 8;
+
+public:
+    AT_API Mutex();
+    AT_API ~Mutex();
+
+public:
+    AT_API void lock();
+    AT_API void unlock();
+
+private:
+    alignas(native_storage_alignment) u8 m_native_storage[native_storage_size];
+};
+
+//
+// Locks the given mutex for as long as the locker is in scope.
+//
+class MutexLocker {
+    AT_MAKE_NONCOPYABLE(MutexLocker);
+    AT_MAKE_NONMOVABLE(MutexLocker);
+
+public:
+    ALWAYS_INLINE explicit MutexLocker(Mutex& mutex)
+        : m_mutex(mutex)
+    {
+        m_mutex.lock();
+    }
+
+    ALWAYS_INLINE ~MutexLocker() { m_mutex.unlock(); }
+
+private:
+    Mutex& m_mutex;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::Mutex;
+using AT::MutexLocker;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,1004 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/Assertion.h>
+#include <AT/BitOperations.h>
+#include <AT/MemoryOperations.h>
+#include <AT/NumberFormatting.h>
+#include <AT/PowersOfFive.h>
+#include <AT/StringBuilder.h>
+
+namespace AT {
+
+//
+// Decimal integers are written two digits at a time, by looking up the characters of every number between 00 and 99
+// in a table. This halves the number of (expensive) divisions compared to writing the digits one by one. Values that
+// don't fit in 32 bits are first split in chunks of eight digits, so that all other divisions are performed with 32-bit
+// arithmetic, which is considerably faster. The number of digits is known before writing them, so the digits are
+// written directly at their final position.
+//
+
+static constexpr char decimal_digit_pairs[] = "00010203040506070809"
+                                              "10111213141516171819"
+                                              "20212223242526272829"
+                                              "30313233343536373839"
+                                              "40414243444546474849"
+                                              "50515253545556575859"
+                                              "60616263646566676869"
+                                              "70717273747576777879"
+                                              "80818283848586878889"
+                                              "90919293949596979899";
+
+static constexpr u64 powers_of_ten[] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static constexpr char lowercase_digit_characters[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+static constexpr char uppercase_digit_characters[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+NODISCARD ALWAYS_INLINE static u32 bit_width(u64 value)
+{
+    // NOTE: Zero is written as a single digit, so it is considered to be one bit wide.
+    return 64 - count_leading_zeros(value | 1);
+}
+
+NODISCARD ALWAYS_INLINE static usize decimal_digit_count(u64 value)
+{
+    // NOTE: 1233 / 4096 is a slight overestimation of log10(2), so the approximation is either exact or one digit less
+    //       than the real count, which is corrected by a single comparison against the power of ten. Setting the least
+    //       significant bit never changes the digit count, but ensures that zero is counted as one digit.
+    const u32 approximation = (bit_width(value) * 1233) >> 12;
+    return approximation + ((value | 1) >= powers_of_ten[approximation]);
+}
+
+ALWAYS_INLINE static void write_decimal_digit_pair(char* destination, u32 value)
+{
+    destination[0] = decimal_digit_pairs[2 * value];
+    destination[1] = decimal_digit_pairs[2 * value + 1];
+}
+
+// Writes exactly eight digits (including leading zeros), such that the last digit is written right before the end.
+ALWAYS_INLINE static void write_eight_decimal_digits(char* end, u32 value)
+{
+    const u32 high = value / 10000;
+    const u32 low = value % 10000;
+    write_decimal_digit_pair(end - 8, high / 100);
+    write_decimal_digit_pair(end - 6, high % 100);
+    write_decimal_digit_pair(end - 4, low / 100);
+    write_decimal_digit_pair(end - 2, low % 100);
+}
+
+// Writes the digits of the value, such that the last digit is written right before the given end pointer.
+ALWAYS_INLINE static void write_decimal_digits(char* end, u64 value)
+{
+    // NOTE: The biggest 64-bit integer has 20 digits, so at most two chunks of eight digits are split off.
+    while (value >= (1ull << 32)) {
+        write_eight_decimal_digits(end, static_cast<u32>(value % 100000000));
+        value /= 100000000;
+        end -= 8;
+    }
+
+    u32 small_value = static_cast<u32>(value);
+    while (small_value >= 100) {
+        end -= 2;
+        write_decimal_digit_pair(end, small_value % 100);
+        small_value /= 100;
+    }
+
+    if (small_value >= 10) {
+        write_decimal_digit_pair(end - 2, small_value);
+    }
+    else {
+        *(end - 1) = static_cast<char>('0' + small_value);
+    }
+}
+
+//
+// Radixes that are powers of two (binary, octal and hexadecimal) don't require any division, as every digit is formed
+// by a fixed group of bits.
+//
+
+NODISCARD ALWAYS_INLINE static bool is_power_of_two_radix(u32 radix)
+{
+    return (radix & (radix - 1)) == 0;
+}
+
+NODISCARD ALWAYS_INLINE static u32 radix_bit_count(u32 radix)
+{
+    return 63 - count_leading_zeros(radix);
+}
+
+// NOTE: The commonly used radixes are specialized, so that the shift and the mask are known at compile time.
+template<u32 DigitBitCount>
+ALWAYS_INLINE static void write_power_of_two_radix_digits(char* end, usize width, u64 value, const char* digits)
+{
+    constexpr u64 digit_mask = (1 << DigitBitCount) - 1;
+
+    // NOTE: Two digits are written per iteration, which halves the length of the dependency chain on the shifted value.
+    for (; width >= 2; width -= 2) {
+        end -= 2;
+        end[1] = digits[value & digit_mask];
+        end[0] = digits[(value >> DigitBitCount) & digit_mask];
+        value >>= 2 * DigitBitCount;
+    }
+
+    if (width > 0) {
+        *(--end) = digits[value & digit_mask];
+    }
+}
+
+NODISCARD ALWAYS_INLINE static usize compute_unsigned_integer_width(u64 value, u32 radix)
+{
+    AT_ASSERT(2 <= radix && radix <= 36);
+
+    switch (radix) {
+        case 2: return bit_width(value);
+        case 8: return (bit_width(value) + 2) / 3;
+        case 10: return decimal_digit_count(value);
+        case 16: return (bit_width(value) + 3) / 4;
+    }
+
+    if (is_power_of_two_radix(radix)) {
+        const u32 digit_bit_count = radix_bit_count(radix);
+        return (bit_width(value) + digit_bit_count - 1) / digit_bit_count;
+    }
+
+    usize width = 1;
+    while (value >= radix) {
+        value /= radix;
+        ++width;
+    }
+    return width;
+}
+
+ALWAYS_INLINE static void write_unsigned_integer_digits(char* end, usize width, u64 value, u32 radix, UppercaseDigits uppercase_digits)
+{
+    if (radix == 10) {
+        write_decimal_digits(end, value);
+        return;
+    }
+
+    const char* digits = (uppercase_digits == UppercaseDigits::Yes) ? uppercase_digit_characters : lowercase_digit_characters;
+    switch (radix) {
+        case 2: write_power_of_two_radix_digits<1>(end, width, value, digits); return;
+        case 8: write_power_of_two_radix_digits<3>(end, width, value, digits); return;
+        case 16: write_power_of_two_radix_digits<4>(end, width, value, digits); return;
+    }
+
+    if (is_power_of_two_radix(radix)) {
+        const u32 digit_bit_count = radix_bit_count(radix);
+        const u64 digit_mask = radix - 1;
+        for (usize index = 0; index < width; ++index) {
+            *(--end) = digits[value & digit_mask];
+            value >>= digit_bit_count;
+        }
+        return;
+    }
+
+    for (usize index = 0; index < width; ++index) {
+        *(--end) = digits[value % radix];
+        value /= radix;
+    }
+}
+
+usize NumberFormatting::unsigned_integer_width(u64 value, u32 radix)
+{
+    return compute_unsigned_integer_width(value, radix);
+}
+
+usize NumberFormatting::signed_integer_width(i64 value, u32 radix)
+{
+    if (value < 0) {
+        // NOTE: Negating in the unsigned domain is well defined, even for the smallest representable value.
+        return 1 + compute_unsigned_integer_width(~static_cast<u64>(value) + 1, radix);
+    }
+
+    return compute_unsigned_integer_width(static_cast<u64>(value), radix);
+}
+
+void NumberFormatting::write_unsigned_integer(char* destination, usize width, u64 value, u32 radix, UppercaseDigits uppercase_digits)
+{
+    AT_ASSERT_DEBUG(width == compute_unsigned_integer_width(value, radix));
+    write_unsigned_integer_digits(destination + width, width, value, radix, uppercase_digits);
+}
+
+void NumberFormatting::write_signed_integer(char* destination, usize width, i64 value, u32 radix, UppercaseDigits uppercase_digits)
+{
+    if (value < 0) {
+        const u64 absolute_value = ~static_cast<u64>(value) + 1;
+        AT_ASSERT_DEBUG(width == 1 + compute_unsigned_integer_width(absolute_value, radix));
+        destination[0] = '-';
+        write_unsigned_integer_digits(destination + width, width - 1, absolute_value, radix, uppercase_digits);
+        return;
+    }
+
+    write_unsigned_integer(destination, width, static_cast<u64>(value), radix, uppercase_digits);
+}
+
+//
+// Floating-point numbers are formatted in two steps. The number is first converted to a string of significant decimal
+// digits and the position of the decimal point, which are then laid out in the requested notation.
+// - Without a precision, the digits are the shortest ones that round-trip, computed using the Schubfach algorithm. The
+//   binary significand and the two boundaries of its rounding interval are multiplied by a 128-bit approximation of a
+//   power of ten (the table shared with the parsing functions), after which the shortest decimal that lies inside the
+//   interval is picked using a handful of integer comparisons.
+// - With a precision, the digits are exactly rounded (half to even). The scaled number 'v * 10^f' is computed using
+//   128-bit integer arithmetic when it fits in 64 bits, which covers the common magnitudes and precisions. Otherwise,
+//   the exact decimal expansion is computed using an arbitrary-precision integer, which is slow but always exact.
+// No memory is allocated in either case.
+//
+
+// A finite, non-negative binary floating-point number, equal to 'significand * 2^exponent'.
+struct BinaryFloat {
+    u64 significand;
+    i32 exponent;
+    // Set for powers of two, whose predecessor is closer than their successor.
+    bool is_lower_boundary_closer;
+};
+
+// The number '0.d[0]d[1]...d[digit_count - 1] * 10^point'. Zero is represented by a single '0' digit.
+struct DecimalNumber {
+    char* digits;
+    usize digit_count;
+    i32 point;
+};
+
+static constexpr u64 powers_of_five[] = {
+    1ull,
+    5ull,
+    25ull,
+    125ull,
+    625ull,
+    3125ull,
+    15625ull,
+    78125ull,
+    390625ull,
+    1953125ull,
+    9765625ull,
+    48828125ull,
+    244140625ull,
+    1220703125ull,
+    6103515625ull,
+    30517578125ull,
+    152587890625ull,
+    762939453125ull,
+    3814697265625ull,
+    19073486328125ull,
+    95367431640625ull,
+    476837158203125ull,
+    2384185791015625ull,
+    11920928955078125ull,
+    59604644775390625ull,
+    298023223876953125ull,
+    1490116119384765625ull,
+    7450580596923828125ull,
+};
+
+// The longest exact decimal expansion of a double has 767 significant digits. Rounding it can add a carry digit.
+static constexpr usize max_exact_digit_count = 800;
+
+NODISCARD ALWAYS_INLINE static BinaryFloat decode_float(u64 mantissa, u32 biased_exponent, u32 mantissa_bit_count, i32 exponent_bias)
+{
+    const i32 min_exponent = 1 - exponent_bias - static_cast<i32>(mantissa_bit_count);
+    if (biased_exponent == 0) {
+        return { mantissa, min_exponent, false };
+    }
+
+    return { mantissa | (1ull << mantissa_bit_count), static_cast<i32>(biased_exponent) + min_exponent - 1,
+             mantissa == 0 && biased_exponent > 1 };
+}
+
+// NOTE: The following approximations are exact for every exponent of an f64 (and much more).
+NODISCARD ALWAYS_INLINE static i32 floor_log10_pow2(i32 exponent)
+{
+    return (exponent * 1262611) >> 22;
+}
+
+NODISCARD ALWAYS_INLINE static i32 floor_log10_three_quarters_pow2(i32 exponent)
+{
+    return (exponent * 1262611 - 524031) >> 22;
+}
+
+NODISCARD ALWAYS_INLINE static i32 floor_log2_pow10(i32 exponent)
+{
+    return (exponent * 1741647) >> 19;
+}
+
+// The 128 most significant bits of '10^k', rounded up. They are the same as the bits of '5^k', as the powers of ten
+// only differ by a power of two.
+ALWAYS_INLINE static void get_power_of_ten_rounded_up(i32 k, u64& out_high, u64& out_low)
+{
+    const u64* power_of_five = Detail::powers_of_five[k - Detail::min_power_of_five];
+    out_high = power_of_five[0];
+    out_low = power_of_five[1];
+
+    // NOTE: The entries of the table are exact between 0 and 55 and already rounded up between -27 and -1.
+    if (k < -27 || k > 55) {
+        ++out_low;
+        out_high += (out_low == 0);
+    }
+}
+
+// Computes the 64 most significant bits of 'g * cp / 2^128', setting the least significant bit if the result is inexact.
+NODISCARD ALWAYS_INLINE static u64 multiply_and_round_to_odd(u64 g_high, u64 g_low, u64 cp)
+{
+    u64 low_product_high;
+    (void)multiply_u64(g_low, cp, low_product_high);
+    u64 product_high;
+    u64 product_low = multiply_u64(g_high, cp, product_high);
+
+    product_low += low_product_high;
+    product_high += (product_low < low_product_high);
+    return product_high | (product_low > 1);
+}
+
+//
+// Computes the shortest decimal 'significand * 10^exponent' that rounds to the given binary number, picking the closest
+// one if there are multiple candidates. The significand might have trailing zeros.
+// Raffaello Giulietti, "The Schubfach way to render doubles", 2020.
+//
+NODISCARD static u64 compute_shortest_decimal(const BinaryFloat& binary, i32& out_exponent)
+{
+    const u64 c = binary.significand;
+    const i32 q = binary.exponent;
+
+    // Integers without a fractional part are their own shortest representation.
+    if (q <= 0 && q > -64 && (c & ((1ull << -q) - 1)) == 0) {
+        out_exponent = 0;
+        return c >> -q;
+    }
+
+    // NOTE: The boundaries of the rounding interval are only part of the interval if the significand is even, because
+    //       the parsing functions round ties to even.
+    const bool is_even = (c % 2) == 0;
+    const u64 cb = 4 * c;
+    const u64 cb_right = cb + 2;
+    const u64 cb_left = binary.is_lower_boundary_closer ? (cb - 1) : (cb - 2);
+
+    const i32 k = binary.is_lower_boundary_closer ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+    const i32 h = q + floor_log2_pow10(-k) + 1;
+
+    u64 g_high;
+    u64 g_low;
+    get_power_of_ten_rounded_up(-k, g_high, g_low);
+
+    const u64 v_left = multiply_and_round_to_odd(g_high, g_low, cb_left << h);
+    const u64 v = multiply_and_round_to_odd(g_high, g_low, cb << h);
+    const u64 v_right = multiply_and_round_to_odd(g_high, g_low, cb_right << h);
+
+    const u64 lower = v_left + !is_even;
+    const u64 upper = v_right - !is_even;
+
+    const u64 s = v / 4;
+    if (s >= 10) {
+        // Check whether a number with one digit less lies inside the rounding interval.
+        const u64 sp = s / 10;
+        const bool is_up_inside = lower <= 40 * sp;
+        const bool is_wp_inside = 40 * sp + 40 <= upper;
+        if (is_up_inside != is_wp_inside) {
+            out_exponent = k + 1;
+            return sp + is_wp_inside;
+        }
+    }
+
+    const bool is_u_inside = lower <= 4 * s;
+    const bool is_w_inside = 4 * s + 4 <= upper;
+    out_exponent = k;
+    if (is_u_inside != is_w_inside) {
+        return s + is_w_inside;
+    }
+
+    // Both candidates lie inside the interval, so the closest one is picked (the even one, in case of a tie).
+    const u64 middle = 4 * s + 2;
+    const bool should_round_up = v > middle || (v == middle && (s & 1) != 0);
+    return s + should_round_up;
+}
+
+NODISCARD static DecimalNumber create_shortest_decimal_number(const BinaryFloat& binary, char* digits)
+{
+    if (binary.significand == 0) {
+        digits[0] = '0';
+        return { digits, 1, 1 };
+    }
+
+    i32 exponent;
+    u64 significand = compute_shortest_decimal(binary, exponent);
+    while (significand % 10 == 0) {
+        significand /= 10;
+        ++exponent;
+    }
+
+    const usize digit_count = decimal_digit_count(significand);
+    write_decimal_digits(digits + digit_count, significand);
+    return { digits, digit_count, static_cast<i32>(digit_count) + exponent };
+}
+
+NODISCARD ALWAYS_INLINE static DecimalNumber create_decimal_number_from_integer(u64 value, i32 fractional_digit_count, char* digits)
+{
+    if (value == 0) {
+        digits[0] = '0';
+        return { digits, 1, 1 };
+    }
+
+    const usize digit_count = decimal_digit_count(value);
+    write_decimal_digits(digits + digit_count, value);
+    return { digits, digit_count, static_cast<i32>(digit_count) - fractional_digit_count };
+}
+
+//
+// Computes 'v * 10^f' rounded to the nearest integer (half to even), where 'v' is the given binary number, using only
+// 128-bit integer arithmetic. Returns false if the computation requires more precision or the result doesn't fit.
+//
+NODISCARD static bool try_scale_and_round(const BinaryFloat& binary, i32 f, u64& out_value)
+{
+    const u64 m = binary.significand;
+    const i32 e = binary.exponent;
+
+    if (f >= 0) {
+        // NOTE: '5^27' is the biggest power of five that fits in 63 bits, so the product fits in 116 bits.
+        if (f > 27) {
+            return false;
+        }
+
+        u64 product_high;
+        const u64 product_low = multiply_u64(m, powers_of_five[f], product_high);
+        const i32 t = e + f;
+
+        if (t >= 0) {
+            // The result is an integer, so no rounding is required.
+            if (product_high != 0 || t >= 64 || (t > 0 && (product_low >> (64 - t)) != 0)) {
+                return false;
+            }
+            out_value = product_low << t;
+            return true;
+        }
+
+        const i32 shift = -t;
+        if (shift >= 128) {
+            out_value = 0;
+            return true;
+        }
+
+        u64 quotient;
+        u64 remainder_high;
+        u64 remainder_low;
+        u64 half_high;
+        u64 half_low;
+        if (shift >= 64) {
+            quotient = (shift == 64) ? product_high : (product_high >> (shift - 64));
+            remainder_high = (shift == 64) ? 0 : (product_high & ((1ull << (shift - 64)) - 1));
+            remainder_low = product_low;
+            half_high = (shift == 64) ? 0 : (1ull << (shift - 65));
+            half_low = (shift == 64) ? (1ull << 63) : 0;
+        }
+        else {
+            if ((product_high >> shift) != 0) {
+                return false;
+            }
+            quotient = (product_low >> shift) | (product_high << (64 - shift));
+            remainder_high = 0;
+            remainder_low = product_low & ((1ull << shift) - 1);
+            half_high = 0;
+            half_low = 1ull << (shift - 1);
+        }
+
+        const bool is_above_half = remainder_high > half_high || (remainder_high == half_high && remainder_low > half_low);
+        const bool is_half = remainder_high == half_high && remainder_low == half_low;
+        if (is_above_half || (is_half && (quotient & 1) != 0)) {
+            if (quotient == static_cast<u64>(-1)) {
+                return false;
+            }
+            ++quotient;
+        }
+
+        out_value = quotient;
+        return true;
+    }
+
+    // The number is rounded to a multiple of a power of ten, by dividing it by 'divisor'.
+    if (-f > 19) {
+        return false;
+    }
+
+    u64 numerator = m;
+    u64 divisor = powers_of_ten[-f];
+    if (e >= 0) {
+        if (bit_width(m) + static_cast<u32>(e) > 64) {
+            return false;
+        }
+        numerator <<= e;
+    }
+    else {
+        if (bit_width(divisor) + static_cast<u32>(-e) > 64) {
+            return false;
+        }
+        divisor <<= -e;
+    }
+
+    u64 quotient = numerator / divisor;
+    const u64 remainder = numerator % divisor;
+    if (remainder > divisor - remainder || (remainder == divisor - remainder && (quotient & 1) != 0)) {
+        ++quotient;
+    }
+
+    out_value = quotient;
+    return true;
+}
+
+//
+// Arbitrary-precision unsigned integer, used to compute the exact decimal expansion of a binary floating-point number.
+// The biggest value that it holds is 'm * 5^1074' (about 2550 bits), for the smallest subnormal doubles.
+//
+struct BigInteger {
+    static constexpr usize max_limb_count = 84;
+
+    u32 limbs[max_limb_count];
+    usize limb_count;
+};
+
+static void multiply_big_integer(BigInteger& integer, u32 factor)
+{
+    u64 carry = 0;
+    for (usize index = 0; index < integer.limb_count; ++index) {
+        const u64 product = static_cast<u64>(integer.limbs[index]) * factor + carry;
+        integer.limbs[index] = static_cast<u32>(product);
+        carry = product >> 32;
+    }
+
+    if (carry != 0) {
+        AT_ASSERT(integer.limb_count < BigInteger::max_limb_count);
+        integer.limbs[integer.limb_count++] = static_cast<u32>(carry);
+    }
+}
+
+static void shift_big_integer_left(BigInteger& integer, u32 shift)
+{
+    const usize limb_shift = shift / 32;
+    const u32 bit_shift = shift % 32;
+    AT_ASSERT(integer.limb_count + limb_shift + 1 <= BigInteger::max_limb_count);
+
+    integer.limbs[integer.limb_count + limb_shift] = 0;
+    for (usize index = integer.limb_count; index > 0; --index) {
+        const u64 limb = static_cast<u64>(integer.limbs[index - 1]) << bit_shift;
+        integer.limbs[index - 1 + limb_shift + 1] |= static_cast<u32>(limb >> 32);
+        integer.limbs[index - 1 + limb_shift] = static_cast<u32>(limb);
+    }
+    for (usize index = 0; index < limb_shift; ++index) {
+        integer.limbs[index] = 0;
+    }
+
+    integer.limb_count += limb_shift + 1;
+    if (integer.limbs[integer.limb_count - 1] == 0) {
+        --integer.limb_count;
+    }
+}
+
+// Divides the integer by the divisor in place and returns the remainder.
+static u32 divide_big_integer(BigInteger& integer, u32 divisor)
+{
+    u64 remainder = 0;
+    for (usize index = integer.limb_count; index > 0; --index) {
+        const u64 dividend = (remainder << 32) | integer.limbs[index - 1];
+        integer.limbs[index - 1] = static_cast<u32>(dividend / divisor);
+        remainder = dividend % divisor;
+    }
+
+    while (integer.limb_count > 0 && integer.limbs[integer.limb_count - 1] == 0) {
+        --integer.limb_count;
+    }
+    return static_cast<u32>(remainder);
+}
+
+// Computes all digits of the exact decimal expansion of the binary number, which must not be zero.
+NODISCARD static DecimalNumber create_exact_decimal_number(const BinaryFloat& binary, char* digits)
+{
+    BigInteger integer;
+    integer.limbs[0] = static_cast<u32>(binary.significand);
+    integer.limbs[1] = static_cast<u32>(binary.significand >> 32);
+    integer.limb_count = (integer.limbs[1] != 0) ? 2 : 1;
+
+    // NOTE: 'm * 2^-n' is equal to 'm * 5^n * 10^-n', so the digits of 'm * 5^n' are the digits of the number.
+    if (binary.exponent >= 0) {
+        shift_big_integer_left(integer, static_cast<u32>(binary.exponent));
+    }
+    else {
+        u32 power = static_cast<u32>(-binary.exponent);
+        for (; power >= 13; power -= 13) {
+            multiply_big_integer(integer, static_cast<u32>(powers_of_five[13]));
+        }
+        multiply_big_integer(integer, static_cast<u32>(powers_of_five[power]));
+    }
+
+    // The digits are extracted in groups of nine, starting with the least significant group.
+    constexpr usize max_group_count = (max_exact_digit_count + 8) / 9;
+    u32 groups[max_group_count];
+    usize group_count = 0;
+    while (integer.limb_count > 0) {
+        AT_ASSERT(group_count < max_group_count);
+        groups[group_count++] = divide_big_integer(integer, 1000000000);
+    }
+
+    const usize first_group_digit_count = decimal_digit_count(groups[group_count - 1]);
+    write_decimal_digits(digits + first_group_digit_count, groups[group_count - 1]);
+    usize digit_count = first_group_digit_count;
+    for (usize index = group_count - 1; index > 0; --index) {
+        write_eight_decimal_digits(digits + digit_count + 9, groups[index - 1] % 100000000);
+        digits[digit_count] = static_cast<char>('0' + groups[index - 1] / 100000000);
+        digit_count += 9;
+    }
+
+    const i32 point = static_cast<i32>(digit_count) + ((binary.exponent < 0) ? binary.exponent : 0);
+    return { digits, digit_count, point };
+}
+
+// Rounds the number (half to even) such that it keeps the given number of digits, counted from the first digit.
+static void round_decimal_number(DecimalNumber& number, i32 kept_digit_count)
+{
+    if (kept_digit_count >= static_cast<i32>(number.digit_count)) {
+        return;
+    }
+
+    if (kept_digit_count < 0) {
+        number.digits[0] = '0';
+        number.digit_count = 1;
+        number.point = 1;
+        return;
+    }
+
+    const usize kept_count = static_cast<usize>(kept_digit_count);
+    const char first_dropped_digit = number.digits[kept_count];
+    bool should_round_up = first_dropped_digit > '5';
+    if (first_dropped_digit == '5') {
+        bool is_exactly_half = true;
+        for (usize index = kept_count + 1; index < number.digit_count; ++index) {
+            if (number.digits[index] != '0') {
+                is_exactly_half = false;
+                break;
+            }
+        }
+        const bool is_last_kept_digit_odd = kept_count > 0 && ((number.digits[kept_count - 1] - '0') & 1) != 0;
+        should_round_up = !is_exactly_half || is_last_kept_digit_odd;
+    }
+
+    number.digit_count = kept_count;
+    if (!should_round_up) {
+        if (number.digit_count == 0) {
+            number.digits[0] = '0';
+            number.digit_count = 1;
+            number.point = 1;
+        }
+        return;
+    }
+
+    for (usize index = kept_count; index > 0; --index) {
+        if (number.digits[index - 1] != '9') {
+            ++number.digits[index - 1];
+            return;
+        }
+        number.digits[index - 1] = '0';
+    }
+
+    // All kept digits were nines (or no digit was kept), so the carry adds a new leading digit.
+    number.digits[0] = '1';
+    number.digit_count = (kept_count > 0) ? kept_count : 1;
+    ++number.point;
+}
+
+// Rounds the number such that it has exactly the given number of digits after the decimal point.
+NODISCARD static DecimalNumber create_fixed_decimal_number(const BinaryFloat& binary, u32 precision, char* digits)
+{
+    if (binary.significand == 0) {
+        digits[0] = '0';
+        return { digits, 1, 1 };
+    }
+
+    u64 scaled_value;
+    if (try_scale_and_round(binary, static_cast<i32>(precision), scaled_value)) {
+        return create_decimal_number_from_integer(scaled_value, static_cast<i32>(precision), digits);
+    }
+
+    DecimalNumber number = create_exact_decimal_number(binary, digits);
+    round_decimal_number(number, number.point + static_cast<i32>(precision));
+    return number;
+}
+
+// Rounds the number such that it has the given number of significant digits.
+NODISCARD static DecimalNumber create_scientific_decimal_number(const BinaryFloat& binary, u32 significant_digit_count, char* digits)
+{
+    if (binary.significand == 0) {
+        digits[0] = '0';
+        return { digits, 1, 1 };
+    }
+
+    // NOTE: The estimated exponent of the first digit is either exact or one less than the exact one. In the latter
+    //       case the scaled value has one digit too many, and the scaling is repeated with the next exponent.
+    if (significant_digit_count <= 19) {
+        const i32 estimated_exponent = floor_log10_pow2(binary.exponent + static_cast<i32>(bit_width(binary.significand)) - 1);
+        i32 f = static_cast<i32>(significant_digit_count) - 1 - estimated_exponent;
+
+        u64 scaled_value;
+        if (try_scale_and_round(binary, f, scaled_value)) {
+            if (scaled_value <= powers_of_ten[significant_digit_count]) {
+                DecimalNumber number = create_decimal_number_from_integer(scaled_value, f, digits);
+                number.digit_count = significant_digit_count;
+                return number;
+            }
+            --f;
+            if (try_scale_and_round(binary, f, scaled_value)) {
+                DecimalNumber number = create_decimal_number_from_integer(scaled_value, f, digits);
+                number.digit_count = significant_digit_count;
+                return number;
+            }
+        }
+    }
+
+    DecimalNumber number = create_exact_decimal_number(binary, digits);
+    round_decimal_number(number, static_cast<i32>(significant_digit_count));
+    return number;
+}
+
+NODISCARD ALWAYS_INLINE static u32 fixed_fractional_digit_count(const DecimalNumber& number)
+{
+    const i32 fractional_digit_count = static_cast<i32>(number.digit_count) - number.point;
+    return (fractional_digit_count > 0) ? static_cast<u32>(fractional_digit_count) : 0;
+}
+
+NODISCARD ALWAYS_INLINE static usize fixed_width(const DecimalNumber& number, u32 fractional_digit_count)
+{
+    const usize integer_digit_count = (number.point > 0) ? static_cast<usize>(number.point) : 1;
+    return integer_digit_count + ((fractional_digit_count > 0) ? (1 + fractional_digit_count) : 0);
+}
+
+NODISCARD ALWAYS_INLINE static usize scientific_width(const DecimalNumber& number, u32 fractional_digit_count)
+{
+    // NOTE: The exponent always has a sign and at least two digits.
+    const i32 exponent = number.point - 1;
+    const usize exponent_digit_count = (exponent <= -100 || exponent >= 100) ? 3 : 2;
+    return 1 + ((fractional_digit_count > 0) ? (1 + fractional_digit_count) : 0) + 2 + exponent_digit_count;
+}
+
+NODISCARD ALWAYS_INLINE static char digit_at(const DecimalNumber& number, i32 index)
+{
+    return (index >= 0 && index < static_cast<i32>(number.digit_count)) ? number.digits[index] : '0';
+}
+
+static void write_fixed(char* destination, const DecimalNumber& number, u32 fractional_digit_count)
+{
+    if (number.point > 0) {
+        for (i32 index = 0; index < number.point; ++index) {
+            *destination++ = digit_at(number, index);
+        }
+    }
+    else {
+        *destination++ = '0';
+    }
+
+    if (fractional_digit_count > 0) {
+        *destination++ = '.';
+        for (u32 index = 0; index < fractional_digit_count; ++index) {
+            *destination++ = digit_at(number, number.point + static_cast<i32>(index));
+        }
+    }
+}
+
+static void write_scientific(char* destination, const DecimalNumber& number, u32 fractional_digit_count)
+{
+    *destination++ = number.digits[0];
+    if (fractional_digit_count > 0) {
+        *destination++ = '.';
+        for (u32 index = 1; index <= fractional_digit_count; ++index) {
+            *destination++ = digit_at(number, static_cast<i32>(index));
+        }
+    }
+
+    // NOTE: The exponent of zero is zero, as it is represented as '0.0 * 10^1'.
+    const i32 exponent = number.point - 1;
+    *destination++ = 'e';
+    *destination++ = (exponent < 0) ? '-' : '+';
+    const u32 absolute_exponent = static_cast<u32>((exponent < 0) ? -exponent : exponent);
+    if (absolute_exponent >= 100) {
+        *destination++ = static_cast<char>('0' + absolute_exponent / 100);
+    }
+    write_decimal_digit_pair(destination, absolute_exponent % 100);
+}
+
+NODISCARD static usize write_float_number(
+    WriteonlyByteSpan destination,
+    bool is_negative,
+    u64 mantissa,
+    u32 biased_exponent,
+    u32 mantissa_bit_count,
+    u32 exponent_bit_count,
+    FloatNotation notation,
+    u32 precision
+)
+{
+    const bool is_shortest = (precision == NumberFormatting::shortest_round_trip_precision);
+    AT_ASSERT(is_shortest || precision <= NumberFormatting::max_float_precision);
+    char* output = reinterpret_cast<char*>(destination.elements());
+
+    const u32 infinite_exponent = (1u << exponent_bit_count) - 1;
+    if (biased_exponent == infinite_exponent) {
+        const ReadonlyByteSpan special = ((mantissa != 0) ? "nan"sv : "inf"sv).byte_span();
+        const usize width = is_negative + special.count();
+        if (width <= destination.count()) {
+            if (is_negative) {
+                *output++ = '-';
+            }
+            copy_memory(output, special.elements(), special.count());
+        }
+        return width;
+    }
+
+    const i32 exponent_bias = static_cast<i32>(infinite_exponent >> 1);
+    const BinaryFloat binary = decode_float(mantissa, biased_exponent, mantissa_bit_count, exponent_bias);
+
+    char digits[max_exact_digit_count];
+    DecimalNumber number;
+    bool should_use_fixed_notation;
+    u32 fractional_digit_count;
+
+    if (is_shortest) {
+        number = create_shortest_decimal_number(binary, digits);
+        if (notation == FloatNotation::General) {
+            // The fixed notation is picked when both notations have the same width.
+            should_use_fixed_notation =
+                fixed_width(number, fixed_fractional_digit_count(number)) <= scientific_width(number, static_cast<u32>(number.digit_count - 1));
+        }
+        else {
+            should_use_fixed_notation = (notation == FloatNotation::Fixed);
+        }
+
+        if (should_use_fixed_notation && number.point > static_cast<i32>(number.digit_count)) {
+            // NOTE: Padding the shortest digits with zeros gives an integer that isn't the best fixed representation.
+            //       The exact digits of the number (which is an integer) are as short, or shorter, and closer to it.
+            number = create_fixed_decimal_number(binary, 0, digits);
+        }
+        fractional_digit_count = should_use_fixed_notation ? fixed_fractional_digit_count(number) : static_cast<u32>(number.digit_count - 1);
+    }
+    else if (notation == FloatNotation::General) {
+        // NOTE: The '%g' printf conversion treats a precision of zero as one and never writes trailing zeros.
+        const u32 significant_digit_count = (precision > 0) ? precision : 1;
+        number = create_scientific_decimal_number(binary, significant_digit_count, digits);
+        while (number.digit_count > 1 && number.digits[number.digit_count - 1] == '0') {
+            --number.digit_count;
+        }
+
+        const i32 exponent = number.point - 1;
+        should_use_fixed_notation = (exponent >= -4 && exponent < static_cast<i32>(significant_digit_count));
+        fractional_digit_count = should_use_fixed_notation ? fixed_fractional_digit_count(number) : static_cast<u32>(number.digit_count - 1);
+    }
+    else {
+        should_use_fixed_notation = (notation == FloatNotation::Fixed);
+        if (should_use_fixed_notation) {
+            number = create_fixed_decimal_number(binary, precision, digits);
+        }
+        else {
+            number = create_scientific_decimal_number(binary, precision + 1, digits);
+        }
+        fractional_digit_count = precision;
+    }
+
+    const usize number_width =
+        should_use_fixed_notation ? fixed_width(number, fractional_digit_count) : scientific_width(number, fractional_digit_count);
+    const usize width = is_negative + number_width;
+    if (width > destination.count()) {
+        return width;
+    }
+
+    if (is_negative) {
+        *output++ = '-';
+    }
+    if (should_use_fixed_notation) {
+        write_fixed(output, number, fractional_digit_count);
+    }
+    else {
+        write_scientific(output, number, fractional_digit_count);
+    }
+    return width;
+}
+
+usize NumberFormatting::write_float(WriteonlyByteSpan destination, f64 value, FloatNotation notation, u32 precision)
+{
+    const u64 bits = __builtin_bit_cast(u64, value);
+    return write_float_number(destination, (bits >> 63) != 0, bits & ((1ull << 52) - 1), (bits >> 52) & 0x7FF, 52, 11, notation, precision);
+}
+
+usize NumberFormatting::write_float(WriteonlyByteSpan destination, f32 value, FloatNotation notation, u32 precision)
+{
+    const u32 bits = __builtin_bit_cast(u32, value);
+    return write_float_number(destination, (bits >> 31) != 0, bits & ((1u << 23) - 1), (bits >> 23) & 0xFF, 23, 8, notation, precision);
+}
+
+//
+// The number functions of StringBuilder live in this translation unit, so that the decimal fast paths are inlined.
+//
+
+void StringBuilder::append_unsigned_integer(u64 value)
+{
+    const usize digit_count = decimal_digit_count(value);
+    char* destination = append_uninitialized(digit_count);
+    write_decimal_digits(destination + digit_count, value);
+}
+
+void StringBuilder::append_signed_integer(i64 value)
+{
+    if (value < 0) {
+        const u64 absolute_value = ~static_cast<u64>(value) + 1;
+        const usize digit_count = decimal_digit_count(absolute_value);
+        char* destination = append_uninitialized(1 + digit_count);
+        destination[0] = '-';
+        write_decimal_digits(destination + 1 + digit_count, absolute_value);
+        return;
+    }
+
+    append_unsigned_integer(static_cast<u64>(value));
+}
+
+void StringBuilder::append_unsigned_integer(u64 value, u32 radix, UppercaseDigits uppercase_digits)
+{
+    const usize width = compute_unsigned_integer_width(value, radix);
+    char* destination = append_uninitialized(width);
+    write_unsigned_integer_digits(destination + width, width, value, radix, uppercase_digits);
+}
+
+void StringBuilder::append_signed_integer(i64 value, u32 radix, UppercaseDigits uppercase_digits)
+{
+    if (value < 0) {
+        const u64 absolute_value = ~static_cast<u64>(value) + 1;
+        const usize width = compute_unsigned_integer_width(absolute_value, radix);
+        char* destination = append_uninitialized(1 + width);
+        destination[0] = '-';
+        write_unsigned_integer_digits(destination + 1 + width, width, absolute_value, radix, uppercase_digits);
+        return;
+    }
+
+    append_unsigned_integer(static_cast<u64>(value), radix, uppercase_digits);
+}
+
+template<typename FloatType>
+ALWAYS_INLINE static void append_float_to_builder(StringBuilder& builder, FloatType value, FloatNotation notation, u32 precision)
+{
+    // NOTE: Most numbers are at most 32 characters wide, so they are written directly at the end of the builder. Only
+    //       the rare wider numbers require a second call, after reserving enough space.
+    builder.ensure_capacity(builder.byte_count() + 32);
+    usize width = NumberFormatting::write_float(builder.unused_capacity_span(), value, notation, precision);
+    if (width > builder.capacity() - builder.byte_count()) {
+        builder.ensure_capacity(builder.byte_count() + width);
+        width = NumberFormatting::write_float(builder.unused_capacity_span(), value, notation, precision);
+    }
+    (void)builder.append_uninitialized(width);
+}
+
+void StringBuilder::append_float(f64 value, FloatNotation notation, u32 precision)
+{
+    append_float_to_builder(*this, value, notation, precision);
+}
+
+void StringBuilder::append_float(f32 value, FloatNotation notation, u32 precision)
+{
+    append_float_to_builder(*this, value, notation, precision);
+}
+
+} // namespace AT
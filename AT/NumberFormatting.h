@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/BooleanEnum.h>
+#include <AT/Span.h>
+#include <AT/Types.h>
+
+namespace AT {
+
+AT_DEFINE_BOOLEAN_ENUM(UppercaseDigits)
+
+enum class FloatNotation : u8 {
+    // The fixed or the scientific notation, whichever is shorter. When a precision is given, it is the number of
+    // significant digits and the notation is chosen by the rules of the '%g' printf conversion.
+    General,
+    // The digits are written without an exponent. The precision is the number of digits after the decimal point.
+    Fixed,
+    // One digit before the decimal point, followed by an exponent. The precision is the number of digits after the
+    // decimal point.
+    Scientific,
+};
+
+class NumberFormatting {
+public:
+    // The longest representation of a 64-bit integer: a minus sign followed by 64 binary digits.
+    static constexpr usize max_integer_width = 65;
+
+    // NOTE: Selects the shortest digits that round-trip, meaning that parsing them gives back the exact same number.
+    static constexpr u32 shortest_round_trip_precision = static_cast<u32>(-1);
+    // The smallest subnormal double has 1074 digits after the decimal point, so every number can be written exactly.
+    static constexpr u32 max_float_precision = 1074;
+    // The longest representation of a floating-point number: the largest double (which has 309 integer digits) written
+    // in the fixed notation with the maximum precision, preceded by a minus sign.
+    static constexpr usize max_float_width = 1 + 309 + 1 + max_float_precision;
+
+public:
+    //
+    // Computes the number of characters required to write the integer in the given radix (between 2 and 36, where the
+    // digits after 9 are the letters of the alphabet). Negative integers include the minus sign in their width.
+    //
+    NODISCARD AT_API static usize unsigned_integer_width(u64 value, u32 radix = 10);
+    NODISCARD AT_API static usize signed_integer_width(i64 value, u32 radix = 10);
+
+    //
+    // Writes the integer in the given radix. Exactly 'width' characters are written, which must be the value returned
+    // by the corresponding width function, so the destination buffer can be reserved before the digits are generated.
+    //
+    AT_API static void
+    write_unsigned_integer(char* destination, usize width, u64 value, u32 radix = 10, UppercaseDigits uppercase_digits = UppercaseDigits::No);
+    AT_API static void
+    write_signed_integer(char* destination, usize width, i64 value, u32 radix = 10, UppercaseDigits uppercase_digits = UppercaseDigits::No);
+
+    //
+    // Writes the floating-point number in the given notation, but only if the representation fits in the destination.
+    // Returns the number of characters that the representation requires, so when the destination is too small it can
+    // be grown and the call repeated. The digits are exactly rounded (half to even) and no memory is ever allocated.
+    // An f32 is written using the shortest digits that round-trip as an f32, not as an f64.
+    //
+    NODISCARD AT_API static usize write_float(
+        WriteonlyByteSpan destination,
+        f64 value,
+        FloatNotation notation = FloatNotation::General,
+        u32 precision = shortest_round_trip_precision
+    );
+    NODISCARD AT_API static usize write_float(
+        WriteonlyByteSpan destination,
+        f32 value,
+        FloatNotation notation = FloatNotation::General,
+        u32 precision = shortest_round_trip_precision
+    );
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::FloatNotation;
+using AT::NumberFormatting;
+using AT::UppercaseDigits;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,883 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/BitOperations.h>
+#include <AT/PowersOfFive.h>
+#include <AT/StringView.h>
+
+namespace AT {
+
+//
+// Number parsing functions of StringView. They live in their own translation unit because of the size of the lookup
+// tables required to exactly round floating-point numbers.
+//
+
+NODISCARD ALWAYS_INLINE static bool is_decimal_digit(char character)
+{
+    return static_cast<u8>(character - '0') < 10;
+}
+
+// Loads eight bytes, the first byte being the least significant one (independent of the host endianness).
+NODISCARD ALWAYS_INLINE static u64 load_eight_bytes(const char* characters)
+{
+    u64 value = 0;
+    for (usize index = 0; index < 8; ++index) {
+        value |= static_cast<u64>(static_cast<u8>(characters[index])) << (8 * index);
+    }
+    return value;
+}
+
+//
+// Eight decimal digits are parsed at once by treating a 64-bit integer as eight byte lanes (SWAR). Adjacent lanes are
+// combined into two-digit numbers, then four-digit numbers and finally one eight-digit number, using a few
+// multiplications whose partial products don't overlap. No vector instructions are needed for such a small input.
+//
+
+// Returns a mask that has the most significant bit set in every byte lane that doesn't contain a decimal digit.
+NODISCARD ALWAYS_INLINE static u64 find_non_digit_bytes(u64 eight_bytes)
+{
+    // NOTE: The digits become the values 0 - 9 and every other byte a value that is bigger or equal to 10.
+    //       Masking out the most significant bit before the addition ensures that no carry crosses the lanes.
+    const u64 values = eight_bytes ^ 0x3030303030303030;
+    return (((values & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | values) & 0x8080808080808080;
+}
+
+// Converts eight byte lanes that all contain decimal digits to their value. The first lane is the most significant digit.
+NODISCARD ALWAYS_INLINE static u64 parse_eight_digits(u64 eight_bytes)
+{
+    const u64 digits = eight_bytes - 0x3030303030303030;
+    const u64 two_digit_lanes = (digits * 10) + (digits >> 8);
+    return (((two_digit_lanes & 0x000000FF000000FF) * (100 + (1000000ull << 32))) +
+            (((two_digit_lanes >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >>
+           32;
+}
+
+NODISCARD ALWAYS_INLINE static u32 digit_value(char character)
+{
+    const u8 byte = static_cast<u8>(character);
+    if (static_cast<u8>(byte - '0') < 10) {
+        return byte - '0';
+    }
+    // NOTE: Setting the 0x20 bit converts uppercase ASCII letters to lowercase.
+    const u8 lowercase_byte = byte | 0x20;
+    if (static_cast<u8>(lowercase_byte - 'a') < 26) {
+        return lowercase_byte - 'a' + 10;
+    }
+    return 36;
+}
+
+//
+// Parses the digits of an unsigned integer, which must be the whole given string. The magnitude must not be bigger
+// than the given maximum. Returns 'Error::Unknown' on success, as the error code is only relevant on failure.
+//
+NODISCARD ALWAYS_INLINE static Error::Code parse_integer_magnitude(const char* characters, usize byte_count, u32 radix, u64 max_magnitude, u64& out_magnitude)
+{
+    AT_ASSERT(2 <= radix && radix <= 36);
+    if (byte_count == 0) {
+        return Error::InvalidStringFormat;
+    }
+
+    usize offset = 0;
+    u64 magnitude = 0;
+    bool has_overflowed = false;
+
+    if (radix == 10) {
+        // NOTE: Leading zeros are skipped, so that the number of significant digits can be used to detect overflow.
+        //       Any number that has at most 19 significant digits fits in 64 bits.
+        while (offset < byte_count && characters[offset] == '0') {
+            ++offset;
+        }
+        const usize significant_digits_offset = offset;
+
+        while (offset + 8 <= byte_count && offset + 8 - significant_digits_offset <= 19) {
+            const u64 eight_bytes = load_eight_bytes(characters + offset);
+            const u64 non_digit_bytes = find_non_digit_bytes(eight_bytes);
+            if (non_digit_bytes == 0) {
+                magnitude = magnitude * 100000000 + parse_eight_digits(eight_bytes);
+                offset += 8;
+                continue;
+            }
+
+            // Fewer than eight digits are left. They are moved to the most significant lanes, which makes the lanes
+            // before them zero digits, and the number is parsed using the same multiplications.
+            const usize digit_count = count_trailing_zeros(non_digit_bytes) / 8;
+            if (digit_count > 0) {
+                const u64 digits_only = (eight_bytes << (8 * (8 - digit_count))) | (0x3030303030303030 >> (8 * digit_count));
+                u64 scale = 1;
+                for (usize index = 0; index < digit_count; ++index) {
+                    scale *= 10;
+                }
+                magnitude = magnitude * scale + parse_eight_digits(digits_only);
+                offset += digit_count;
+            }
+            break;
+        }
+
+        for (; offset < byte_count && is_decimal_digit(characters[offset]); ++offset) {
+            const u64 digit = static_cast<u64>(characters[offset] - '0');
+            if (offset - significant_digits_offset >= 19) {
+                if (has_overflowed || magnitude > (static_cast<u64>(-1) - digit) / 10) {
+                    has_overflowed = true;
+                    continue;
+                }
+            }
+            magnitude = magnitude * 10 + digit;
+        }
+    }
+    else {
+        for (; offset < byte_count; ++offset) {
+            const u64 digit = digit_value(characters[offset]);
+            if (digit >= radix) {
+                break;
+            }
+            if (has_overflowed || magnitude > (static_cast<u64>(-1) - digit) / radix) {
+                has_overflowed = true;
+                continue;
+            }
+            magnitude = magnitude * radix + digit;
+        }
+    }
+
+    if (offset != byte_count) {
+        return Error::InvalidStringFormat;
+    }
+    if (has_overflowed || magnitude > max_magnitude) {
+        return Error::NumberOutOfRange;
+    }
+
+    out_magnitude = magnitude;
+    return Error::Unknown;
+}
+
+ErrorOr<u64> StringView::to_unsigned_integer(u32 radix, u64 max_value) const
+{
+    usize offset = 0;
+    if (m_byte_count > 0 && m_characters[0] == '+') {
+        offset = 1;
+    }
+
+    u64 value;
+    const Error::Code error_code = parse_integer_magnitude(m_characters + offset, m_byte_count - offset, radix, max_value, value);
+    if (error_code != Error::Unknown) {
+        return error_code;
+    }
+    return value;
+}
+
+ErrorOr<i64> StringView::to_signed_integer(u32 radix, i64 max_value) const
+{
+    usize offset = 0;
+    bool is_negative = false;
+    if (m_byte_count > 0 && (m_characters[0] == '+' || m_characters[0] == '-')) {
+        is_negative = (m_characters[0] == '-');
+        offset = 1;
+    }
+
+    // NOTE: In two's complement the magnitude of the minimum value is one bigger than the maximum value.
+    const u64 max_magnitude = static_cast<u64>(max_value) + (is_negative ? 1 : 0);
+    u64 magnitude;
+    const Error::Code error_code = parse_integer_magnitude(m_characters + offset, m_byte_count - offset, radix, max_magnitude, magnitude);
+    if (error_code != Error::Unknown) {
+        return error_code;
+    }
+
+    // NOTE: The negation is done using unsigned arithmetic, as negating the magnitude of the minimum value overflows.
+    return static_cast<i64>(is_negative ? (0 - magnitude) : magnitude);
+}
+
+//
+// Floating-point numbers are parsed in three steps. The decimal significand is first accumulated into a 64-bit
+// integer 'w' (keeping at most 19 significant digits), such that the number is 'w * 10^q'.
+// - If 'w' and '10^q' are both exactly representable, a single (correctly rounded) multiplication or division gives
+//   the result (Clinger's fast path).
+// - Otherwise, the Eisel-Lemire algorithm multiplies 'w' by a 128-bit truncated approximation of '5^q' and derives the
+//   binary significand and exponent from the product. The approximation is proven to always be precise enough.
+// - If some significant digits had to be dropped, the result is only known when rounding 'w' and 'w + 1' gives the
+//   same result. Otherwise, the number is converted using an arbitrary-precision decimal, which is slow but exact.
+//
+
+struct FloatFormat {
+    u32 mantissa_bit_count;
+    u32 exponent_bit_count;
+    i32 exponent_bias;
+    i32 min_power_of_ten;
+    i32 max_power_of_ten;
+    i32 min_fast_path_exponent;
+    i32 max_fast_path_exponent;
+    u64 max_fast_path_mantissa;
+    i32 min_round_to_even_exponent;
+    i32 max_round_to_even_exponent;
+};
+
+static constexpr FloatFormat s_f64_format = { 52, 11, 1023, -342, 308, -22, 22, 1ull << 53, -4, 23 };
+static constexpr FloatFormat s_f32_format = { 23, 8, 127, -64, 38, -10, 10, 1ull << 24, -17, 10 };
+
+struct DecodedFloat {
+    // The significand without the implicit bit and the biased exponent.
+    u64 mantissa;
+    i32 biased_exponent;
+};
+
+// Converts 'w * 10^q' to the closest binary floating-point number. The significand must not be zero.
+NODISCARD static DecodedFloat eisel_lemire(u64 w, i64 q, const FloatFormat& format)
+{
+    const i32 infinite_exponent = (1 << format.exponent_bit_count) - 1;
+    if (q < format.min_power_of_ten) {
+        return { 0, 0 };
+    }
+    if (q > format.max_power_of_ten) {
+        return { 0, infinite_exponent };
+    }
+
+    const u32 leading_zero_count = count_leading_zeros(w);
+    w <<= leading_zero_count;
+
+    // Only the high part of the product is needed, unless the bits below the significand (plus the rounding bits)
+    // are all set, in which case the second half of the power can cause a carry.
+    const u64* power_of_five = Detail::powers_of_five[q - Detail::min_power_of_five];
+    const u64 precision_mask = static_cast<u64>(-1) >> (format.mantissa_bit_count + 3);
+    u64 product_high;
+    u64 product_low = multiply_u64(w, power_of_five[0], product_high);
+    if ((product_high & precision_mask) == precision_mask) {
+        u64 second_product_high;
+        (void)multiply_u64(w, power_of_five[1], second_product_high);
+        product_low += second_product_high;
+        if (second_product_high > product_low) {
+            ++product_high;
+        }
+    }
+
+    const u32 upper_bit = static_cast<u32>(product_high >> 63);
+    const u32 shift = upper_bit + 64 - format.mantissa_bit_count - 3;
+    u64 mantissa = product_high >> shift;
+    // NOTE: '(217706 * q) >> 16' is 'floor(log2(10^q))' for every 'q' in the supported range.
+    i32 biased_exponent = static_cast<i32>(((217706 * q) >> 16) + 63 + upper_bit - leading_zero_count + format.exponent_bias);
+
+    if (biased_exponent <= 0) {
+        // The number is subnormal (or rounds to zero).
+        if (-biased_exponent + 1 >= 64) {
+            return { 0, 0 };
+        }
+        mantissa >>= -biased_exponent + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        // NOTE: Rounding up the largest subnormal produces the smallest normal number.
+        biased_exponent = (mantissa < (1ull << format.mantissa_bit_count)) ? 0 : 1;
+        return { mantissa & ((1ull << format.mantissa_bit_count) - 1), biased_exponent };
+    }
+
+    // The product is exactly halfway between two floating-point numbers, so it must be rounded to even. This can only
+    // happen for a small range of exponents, where '5^q' fits in 64 bits.
+    if (product_low <= 1 && q >= format.min_round_to_even_exponent && q <= format.max_round_to_even_exponent && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == product_high) {
+            mantissa &= ~static_cast<u64>(1);
+        }
+    }
+
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= (2ull << format.mantissa_bit_count)) {
+        mantissa = (1ull << format.mantissa_bit_count);
+        ++biased_exponent;
+    }
+
+    mantissa &= ~(1ull << format.mantissa_bit_count);
+    if (biased_exponent >= infinite_exponent) {
+        return { 0, infinite_exponent };
+    }
+    return { mantissa, biased_exponent };
+}
+
+//
+// Arbitrary-precision decimal, used to exactly convert numbers that have too many significant digits for the
+// Eisel-Lemire algorithm to decide the rounding. The number is '0.d[0]d[1]...d[n - 1] * 10^decimal_point'.
+// The number is repeatedly shifted by powers of two until it is in the '[0.5, 1)' range, after which the binary
+// significand is extracted as an integer.
+//
+struct Decimal {
+    static constexpr usize max_digit_count = 800;
+    // The biggest shift that can be done at once without overflowing the 64-bit accumulator.
+    static constexpr u32 max_shift = 60;
+
+    u8 digits[max_digit_count];
+    usize digit_count;
+    i32 decimal_point;
+    // Set if non-zero digits were discarded because there was no space for them.
+    bool is_truncated;
+};
+
+// The number of decimal digits of '2^k' and the decimal representation of '5^k', for every shift 'k'. A left shift
+// by 'k' adds one less digit than '2^k' has if the decimal digits (as a string) are smaller than '5^k'.
+struct DecimalLeftShift {
+    u32 digit_count_increase;
+    const char* cutoff;
+};
+
+static constexpr DecimalLeftShift s_decimal_left_shifts[Decimal::max_shift + 1] = {
+    { 0, "" },
+    { 1, "5" },
+    { 1, "25" },
+    { 1, "125" },
+    { 2, "625" },
+    { 2, "3125" },
+    { 2, "15625" },
+    { 3, "78125" },
+    { 3, "390625" },
+    { 3, "1953125" },
+    { 4, "9765625" },
+    { 4, "48828125" },
+    { 4, "244140625" },
+    { 4, "1220703125" },
+    { 5, "6103515625" },
+    { 5, "30517578125" },
+    { 5, "152587890625" },
+    { 6, "762939453125" },
+    { 6, "3814697265625" },
+    { 6, "19073486328125" },
+    { 7, "95367431640625" },
+    { 7, "476837158203125" },
+    { 7, "2384185791015625" },
+    { 7, "11920928955078125" },
+    { 8, "59604644775390625" },
+    { 8, "298023223876953125" },
+    { 8, "1490116119384765625" },
+    { 9, "7450580596923828125" },
+    { 9, "37252902984619140625" },
+    { 9, "186264514923095703125" },
+    { 10, "931322574615478515625" },
+    { 10, "4656612873077392578125" },
+    { 10, "23283064365386962890625" },
+    { 10, "116415321826934814453125" },
+    { 11, "582076609134674072265625" },
+    { 11, "2910383045673370361328125" },
+    { 11, "14551915228366851806640625" },
+    { 12, "72759576141834259033203125" },
+    { 12, "363797880709171295166015625" },
+    { 12, "1818989403545856475830078125" },
+    { 13, "9094947017729282379150390625" },
+    { 13, "45474735088646411895751953125" },
+    { 13, "227373675443232059478759765625" },
+    { 13, "1136868377216160297393798828125" },
+    { 14, "5684341886080801486968994140625" },
+    { 14, "28421709430404007434844970703125" },
+    { 14, "142108547152020037174224853515625" },
+    { 15, "710542735760100185871124267578125" },
+    { 15, "3552713678800500929355621337890625" },
+    { 15, "17763568394002504646778106689453125" },
+    { 16, "88817841970012523233890533447265625" },
+    { 16, "444089209850062616169452667236328125" },
+    { 16, "2220446049250313080847263336181640625" },
+    { 16, "11102230246251565404236316680908203125" },
+    { 17, "55511151231257827021181583404541015625" },
+    { 17, "277555756156289135105907917022705078125" },
+    { 17, "1387778780781445675529539585113525390625" },
+    { 18, "6938893903907228377647697925567626953125" },
+    { 18, "34694469519536141888238489627838134765625" },
+    { 18, "173472347597680709441192448139190673828125" },
+    { 19, "867361737988403547205962240695953369140625" },
+};
+
+static void trim_decimal(Decimal& decimal)
+{
+    while (decimal.digit_count > 0 && decimal.digits[decimal.digit_count - 1] == 0) {
+        --decimal.digit_count;
+    }
+    if (decimal.digit_count == 0) {
+        decimal.decimal_point = 0;
+    }
+}
+
+static void shift_decimal_left(Decimal& decimal, u32 shift)
+{
+    const DecimalLeftShift& left_shift = s_decimal_left_shifts[shift];
+    usize digit_count_increase = left_shift.digit_count_increase;
+    for (usize index = 0; left_shift.cutoff[index] != 0; ++index) {
+        if (index >= decimal.digit_count) {
+            --digit_count_increase;
+            break;
+        }
+        const u8 cutoff_digit = static_cast<u8>(left_shift.cutoff[index] - '0');
+        if (decimal.digits[index] != cutoff_digit) {
+            if (decimal.digits[index] < cutoff_digit) {
+                --digit_count_increase;
+            }
+            break;
+        }
+    }
+
+    usize read_index = decimal.digit_count;
+    usize write_index = decimal.digit_count + digit_count_increase;
+    u64 accumulator = 0;
+
+    const auto put_down_digit = [&decimal, &write_index](u64 digit) {
+        --write_index;
+        if (write_index < Decimal::max_digit_count) {
+            decimal.digits[write_index] = static_cast<u8>(digit);
+        }
+        else if (digit != 0) {
+            decimal.is_truncated = true;
+        }
+    };
+
+    while (read_index > 0) {
+        --read_index;
+        accumulator += static_cast<u64>(decimal.digits[read_index]) << shift;
+        const u64 quotient = accumulator / 10;
+        put_down_digit(accumulator - 10 * quotient);
+        accumulator = quotient;
+    }
+    while (accumulator > 0) {
+        const u64 quotient = accumulator / 10;
+        put_down_digit(accumulator - 10 * quotient);
+        accumulator = quotient;
+    }
+
+    decimal.digit_count += digit_count_increase;
+    if (decimal.digit_count > Decimal::max_digit_count) {
+        decimal.digit_count = Decimal::max_digit_count;
+    }
+    decimal.decimal_point += static_cast<i32>(digit_count_increase);
+    trim_decimal(decimal);
+}
+
+static void shift_decimal_right(Decimal& decimal, u32 shift)
+{
+    usize read_index = 0;
+    usize write_index = 0;
+    u64 accumulator = 0;
+
+    // Pick up enough leading digits to cover the first shift.
+    for (; (accumulator >> shift) == 0; ++read_index) {
+        if (read_index >= decimal.digit_count) {
+            if (accumulator == 0) {
+                decimal.digit_count = 0;
+                return;
+            }
+            while ((accumulator >> shift) == 0) {
+                accumulator *= 10;
+                ++read_index;
+            }
+            break;
+        }
+        accumulator = accumulator * 10 + decimal.digits[read_index];
+    }
+    decimal.decimal_point -= static_cast<i32>(read_index) - 1;
+
+    const u64 mask = (1ull << shift) - 1;
+    for (; read_index < decimal.digit_count; ++read_index) {
+        const u64 digit = accumulator >> shift;
+        accumulator &= mask;
+        decimal.digits[write_index++] = static_cast<u8>(digit);
+        accumulator = accumulator * 10 + decimal.digits[read_index];
+    }
+    while (accumulator > 0) {
+        const u64 digit = accumulator >> shift;
+        accumulator &= mask;
+        if (write_index < Decimal::max_digit_count) {
+            decimal.digits[write_index++] = static_cast<u8>(digit);
+        }
+        else if (digit > 0) {
+            decimal.is_truncated = true;
+        }
+        accumulator *= 10;
+    }
+
+    decimal.digit_count = write_index;
+    trim_decimal(decimal);
+}
+
+static void shift_decimal(Decimal& decimal, i32 shift)
+{
+    if (decimal.digit_count == 0) {
+        return;
+    }
+    for (; shift > static_cast<i32>(Decimal::max_shift); shift -= Decimal::max_shift) {
+        shift_decimal_left(decimal, Decimal::max_shift);
+    }
+    for (; shift < -static_cast<i32>(Decimal::max_shift); shift += Decimal::max_shift) {
+        shift_decimal_right(decimal, Decimal::max_shift);
+    }
+    if (shift > 0) {
+        shift_decimal_left(decimal, static_cast<u32>(shift));
+    }
+    else if (shift < 0) {
+        shift_decimal_right(decimal, static_cast<u32>(-shift));
+    }
+}
+
+// Returns the integer part of the decimal, rounded to nearest (ties to even) using the fractional digits.
+NODISCARD static u64 round_decimal_to_integer(const Decimal& decimal)
+{
+    if (decimal.decimal_point > 20) {
+        return static_cast<u64>(-1);
+    }
+
+    const usize integer_digit_count = decimal.decimal_point > 0 ? static_cast<usize>(decimal.decimal_point) : 0;
+    u64 value = 0;
+    for (usize index = 0; index < integer_digit_count; ++index) {
+        value = value * 10 + (index < decimal.digit_count ? decimal.digits[index] : 0);
+    }
+
+    bool should_round_up = false;
+    if (decimal.decimal_point >= 0 && integer_digit_count < decimal.digit_count) {
+        const u8 first_fractional_digit = decimal.digits[integer_digit_count];
+        if (first_fractional_digit == 5 && integer_digit_count + 1 == decimal.digit_count) {
+            // Exactly halfway, unless some non-zero digits were discarded.
+            should_round_up = decimal.is_truncated || (integer_digit_count > 0 && (decimal.digits[integer_digit_count - 1] & 1));
+        }
+        else {
+            should_round_up = first_fractional_digit >= 5;
+        }
+    }
+
+    return value + (should_round_up ? 1 : 0);
+}
+
+NODISCARD static DecodedFloat decimal_to_float(Decimal& decimal, const FloatFormat& format)
+{
+    const i32 infinite_exponent = (1 << format.exponent_bit_count) - 1;
+    // NOTE: The bounds are loose enough for all the supported formats. The exact checks are done after scaling.
+    if (decimal.digit_count == 0 || decimal.decimal_point < -330) {
+        return { 0, 0 };
+    }
+    if (decimal.decimal_point > 310) {
+        return { 0, infinite_exponent };
+    }
+
+    // Shifting by these amounts reduces the decimal point by at least the index in the table.
+    static constexpr u32 s_shifts_for_decimal_point[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    const auto shift_for_decimal_point = [](i32 decimal_point) -> i32 {
+        return decimal_point < 9 ? static_cast<i32>(s_shifts_for_decimal_point[decimal_point]) : 27;
+    };
+
+    // Scale the number to the '[0.5, 1)' range, keeping track of the binary exponent.
+    i32 binary_exponent = 0;
+    while (decimal.decimal_point > 0) {
+        const i32 shift = shift_for_decimal_point(decimal.decimal_point);
+        shift_decimal(decimal, -shift);
+        binary_exponent += shift;
+    }
+    while (decimal.decimal_point < 0 || (decimal.decimal_point == 0 && decimal.digits[0] < 5)) {
+        const i32 shift = shift_for_decimal_point(-decimal.decimal_point);
+        shift_decimal(decimal, shift);
+        binary_exponent -= shift;
+    }
+
+    // The range is now '[0.5, 1)', but the floating-point significand range is '[1, 2)'.
+    --binary_exponent;
+
+    // Subnormal numbers have the smallest exponent, so the significand is shifted instead.
+    const i32 min_binary_exponent = 1 - format.exponent_bias;
+    if (binary_exponent < min_binary_exponent) {
+        shift_decimal(decimal, -(min_binary_exponent - binary_exponent));
+        binary_exponent = min_binary_exponent;
+    }
+    if (binary_exponent + format.exponent_bias >= infinite_exponent) {
+        return { 0, infinite_exponent };
+    }
+
+    // Extract the significand, including the implicit bit.
+    shift_decimal(decimal, static_cast<i32>(format.mantissa_bit_count + 1));
+    u64 mantissa = round_decimal_to_integer(decimal);
+    if (mantissa == (2ull << format.mantissa_bit_count)) {
+        mantissa >>= 1;
+        ++binary_exponent;
+        if (binary_exponent + format.exponent_bias >= infinite_exponent) {
+            return { 0, infinite_exponent };
+        }
+    }
+
+    i32 biased_exponent = binary_exponent + format.exponent_bias;
+    if ((mantissa & (1ull << format.mantissa_bit_count)) == 0) {
+        biased_exponent = 0;
+    }
+    return { mantissa & ((1ull << format.mantissa_bit_count) - 1), biased_exponent };
+}
+
+//
+// The components of a decimal floating-point number, as written in the string. The number is valid if it has at
+// least one digit (in the integer or fractional part) and, if there is an exponent, at least one exponent digit.
+//
+struct DecimalNumber {
+    const char* integer_digits;
+    usize integer_digit_count;
+    const char* fractional_digits;
+    usize fractional_digit_count;
+    i64 explicit_exponent;
+    bool is_negative;
+};
+
+// Returns the offset of the first byte, starting at the given offset, that is not a decimal digit.
+NODISCARD ALWAYS_INLINE static usize skip_decimal_digits(const char* characters, usize byte_count, usize offset)
+{
+    while (offset + 8 <= byte_count) {
+        const u64 non_digit_bytes = find_non_digit_bytes(load_eight_bytes(characters + offset));
+        if (non_digit_bytes != 0) {
+            return offset + count_trailing_zeros(non_digit_bytes) / 8;
+        }
+        offset += 8;
+    }
+    while (offset < byte_count && is_decimal_digit(characters[offset])) {
+        ++offset;
+    }
+    return offset;
+}
+
+NODISCARD ALWAYS_INLINE static bool parse_decimal_number(const char* characters, usize byte_count, DecimalNumber& out_number)
+{
+    usize offset = 0;
+    out_number.is_negative = false;
+    if (offset < byte_count && (characters[offset] == '+' || characters[offset] == '-')) {
+        out_number.is_negative = (characters[offset] == '-');
+        ++offset;
+    }
+
+    out_number.integer_digits = characters + offset;
+    const usize integer_digits_end = skip_decimal_digits(characters, byte_count, offset);
+    out_number.integer_digit_count = integer_digits_end - offset;
+    offset = integer_digits_end;
+
+    out_number.fractional_digits = characters + offset;
+    out_number.fractional_digit_count = 0;
+    if (offset < byte_count && characters[offset] == '.') {
+        ++offset;
+        out_number.fractional_digits = characters + offset;
+        const usize fractional_digits_end = skip_decimal_digits(characters, byte_count, offset);
+        out_number.fractional_digit_count = fractional_digits_end - offset;
+        offset = fractional_digits_end;
+    }
+
+    if (out_number.integer_digit_count + out_number.fractional_digit_count == 0) {
+        return false;
+    }
+
+    out_number.explicit_exponent = 0;
+    if (offset < byte_count && (characters[offset] == 'e' || characters[offset] == 'E')) {
+        ++offset;
+        bool exponent_is_negative = false;
+        if (offset < byte_count && (characters[offset] == '+' || characters[offset] == '-')) {
+            exponent_is_negative = (characters[offset] == '-');
+            ++offset;
+        }
+        if (offset >= byte_count || !is_decimal_digit(characters[offset])) {
+            return false;
+        }
+
+        for (; offset < byte_count && is_decimal_digit(characters[offset]); ++offset) {
+            // NOTE: Exponents this big always overflow (or underflow), so the exact value is irrelevant.
+            if (out_number.explicit_exponent < 0x10000) {
+                out_number.explicit_exponent = out_number.explicit_exponent * 10 + (characters[offset] - '0');
+            }
+        }
+        if (exponent_is_negative) {
+            out_number.explicit_exponent = -out_number.explicit_exponent;
+        }
+    }
+
+    return offset == byte_count;
+}
+
+//
+// Accumulates the digits into the significand, keeping at most 19 significant digits (which always fit in 64 bits).
+// For every digit that is not kept, the exponent is adjusted by the given amount. Leading zeros are not significant.
+//
+ALWAYS_INLINE static void accumulate_significant_digits(const char* digits, usize digit_count, i64 exponent_adjustment_for_kept_digits,
+                                          i64 exponent_adjustment_for_dropped_digits, u64& significand, usize& significant_digit_count,
+                                          i64& exponent, bool& is_truncated)
+{
+    usize index = 0;
+    if (significant_digit_count == 0) {
+        while (index < digit_count && digits[index] == '0') {
+            exponent += exponent_adjustment_for_kept_digits;
+            ++index;
+        }
+    }
+
+    while (index + 8 <= digit_count && significant_digit_count + 8 <= 19) {
+        significand = significand * 100000000 + parse_eight_digits(load_eight_bytes(digits + index));
+        significant_digit_count += 8;
+        exponent += 8 * exponent_adjustment_for_kept_digits;
+        index += 8;
+    }
+
+    for (; index < digit_count && significant_digit_count < 19; ++index) {
+        significand = significand * 10 + static_cast<u64>(digits[index] - '0');
+        ++significant_digit_count;
+        exponent += exponent_adjustment_for_kept_digits;
+    }
+
+    for (; index < digit_count; ++index) {
+        exponent += exponent_adjustment_for_dropped_digits;
+        if (digits[index] != '0') {
+            is_truncated = true;
+        }
+    }
+}
+
+static void fill_decimal(const DecimalNumber& number, Decimal& decimal)
+{
+    decimal.digit_count = 0;
+    decimal.decimal_point = 0;
+    decimal.is_truncated = false;
+
+    // Returns the number of significant digits, including the ones that were discarded.
+    const auto add_digits = [&decimal](const char* digits, usize digit_count) -> usize {
+        usize significant_digit_count = 0;
+        for (usize index = 0; index < digit_count; ++index) {
+            const u8 digit = static_cast<u8>(digits[index] - '0');
+            if (decimal.digit_count == 0 && digit == 0) {
+                // Leading zeros only move the decimal point.
+                --decimal.decimal_point;
+                continue;
+            }
+
+            ++significant_digit_count;
+            if (decimal.digit_count < Decimal::max_digit_count) {
+                decimal.digits[decimal.digit_count++] = digit;
+            }
+            else if (digit != 0) {
+                decimal.is_truncated = true;
+            }
+        }
+        return significant_digit_count;
+    };
+
+    // NOTE: The leading zeros of the integer part don't move the decimal point, as it is placed after the last
+    //       significant integer digit. Only the leading zeros of the fractional part do.
+    decimal.decimal_point = static_cast<i32>(add_digits(number.integer_digits, number.integer_digit_count));
+    (void)add_digits(number.fractional_digits, number.fractional_digit_count);
+    decimal.decimal_point += static_cast<i32>(number.explicit_exponent);
+    trim_decimal(decimal);
+}
+
+// NOTE: Kept out of line, so that the big decimal buffer isn't allocated on the stack by the common path.
+NODISCARD NEVER_INLINE static DecodedFloat convert_decimal_number_slow(const DecimalNumber& number, const FloatFormat& format)
+{
+    Decimal decimal;
+    fill_decimal(number, decimal);
+    return decimal_to_float(decimal, format);
+}
+
+NODISCARD static bool equals_ignoring_ascii_case(const char* characters, usize byte_count, const char* lowercase_literal)
+{
+    usize index = 0;
+    for (; index < byte_count && lowercase_literal[index] != 0; ++index) {
+        if ((static_cast<u8>(characters[index]) | 0x20) != static_cast<u8>(lowercase_literal[index])) {
+            return false;
+        }
+    }
+    return index == byte_count && lowercase_literal[index] == 0;
+}
+
+//
+// Parses the string as a floating-point number of the given format. The value is returned as the raw bits of the
+// number, such that the same code can be used for both 32-bit and 64-bit floats.
+//
+NODISCARD ALWAYS_INLINE static Error::Code parse_float_bits(const char* characters, usize byte_count, const FloatFormat& format, u64& out_bits)
+{
+    const i32 infinite_exponent = (1 << format.exponent_bit_count) - 1;
+    const u32 sign_bit_index = format.mantissa_bit_count + format.exponent_bit_count;
+
+    DecimalNumber number;
+    if (!parse_decimal_number(characters, byte_count, number)) {
+        // The special values are accepted (ignoring the case), optionally with a sign.
+        const bool has_sign = byte_count > 0 && (characters[0] == '+' || characters[0] == '-');
+        const char* name = characters + (has_sign ? 1 : 0);
+        const usize name_byte_count = byte_count - (has_sign ? 1 : 0);
+        const u64 sign_bits = (has_sign && characters[0] == '-') ? (1ull << sign_bit_index) : 0;
+
+        if (equals_ignoring_ascii_case(name, name_byte_count, "inf") || equals_ignoring_ascii_case(name, name_byte_count, "infinity")) {
+            out_bits = sign_bits | (static_cast<u64>(infinite_exponent) << format.mantissa_bit_count);
+            return Error::Unknown;
+        }
+        if (equals_ignoring_ascii_case(name, name_byte_count, "nan")) {
+            // NOTE: The quiet NaN has the most significant bit of the significand set.
+            out_bits = sign_bits | (static_cast<u64>(infinite_exponent) << format.mantissa_bit_count) |
+                       (1ull << (format.mantissa_bit_count - 1));
+            return Error::Unknown;
+        }
+        return Error::InvalidStringFormat;
+    }
+
+    u64 significand = 0;
+    usize significant_digit_count = 0;
+    i64 exponent = number.explicit_exponent;
+    bool is_truncated = false;
+    accumulate_significant_digits(number.integer_digits, number.integer_digit_count, 0, 1, significand, significant_digit_count, exponent,
+                                  is_truncated);
+    accumulate_significant_digits(number.fractional_digits, number.fractional_digit_count, -1, 0, significand, significant_digit_count,
+                                  exponent, is_truncated);
+
+    const u64 sign_bits = number.is_negative ? (1ull << sign_bit_index) : 0;
+    DecodedFloat decoded_float = { 0, 0 };
+
+    if (significand == 0) {
+        // NOTE: All the digits are zeros, so the value is zero regardless of the exponent.
+        out_bits = sign_bits;
+        return Error::Unknown;
+    }
+
+    bool is_decoded = false;
+    if (!is_truncated && exponent >= format.min_fast_path_exponent && exponent <= format.max_fast_path_exponent &&
+        significand <= format.max_fast_path_mantissa) {
+        // NOTE: Both operands are exact, so the result is correctly rounded by the hardware.
+        static constexpr f64 s_f64_powers_of_ten[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        static constexpr f32 s_f32_powers_of_ten[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+        if (format.mantissa_bit_count == s_f64_format.mantissa_bit_count) {
+            f64 value = static_cast<f64>(significand);
+            value = (exponent < 0) ? value / s_f64_powers_of_ten[-exponent] : value * s_f64_powers_of_ten[exponent];
+            out_bits = __builtin_bit_cast(u64, value) | sign_bits;
+        }
+        else {
+            f32 value = static_cast<f32>(significand);
+            value = (exponent < 0) ? value / s_f32_powers_of_ten[-exponent] : value * s_f32_powers_of_ten[exponent];
+            out_bits = static_cast<u64>(__builtin_bit_cast(u32, value)) | sign_bits;
+        }
+        return Error::Unknown;
+    }
+
+    decoded_float = eisel_lemire(significand, exponent, format);
+    is_decoded = true;
+    if (is_truncated) {
+        // The dropped digits make the number bigger than 'w * 10^q', but smaller than '(w + 1) * 10^q'.
+        const DecodedFloat upper_bound = eisel_lemire(significand + 1, exponent, format);
+        is_decoded = decoded_float.mantissa == upper_bound.mantissa && decoded_float.biased_exponent == upper_bound.biased_exponent;
+    }
+
+    if (!is_decoded) {
+        decoded_float = convert_decimal_number_slow(number, format);
+    }
+
+    if (decoded_float.biased_exponent == infinite_exponent) {
+        return Error::NumberOutOfRange;
+    }
+
+    out_bits = sign_bits | (static_cast<u64>(decoded_float.biased_exponent) << format.mantissa_bit_count) | decoded_float.mantissa;
+    return Error::Unknown;
+}
+
+ErrorOr<f64> StringView::to_f64() const
+{
+    u64 bits;
+    const Error::Code error_code = parse_float_bits(m_characters, m_byte_count, s_f64_format, bits);
+    if (error_code != Error::Unknown) {
+        return error_code;
+    }
+    return __builtin_bit_cast(f64, bits);
+}
+
+ErrorOr<f32> StringView::to_f32() const
+{
+    u64 bits;
+    const Error::Code error_code = parse_float_bits(m_characters, m_byte_count, s_f32_format, bits);
+    if (error_code != Error::Unknown) {
+        return error_code;
+    }
+    return __builtin_bit_cast(f32, static_cast<u32>(bits));
+}
+
+} // namespace AT
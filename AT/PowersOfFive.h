@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Types.h>
+
+namespace AT {
+
+namespace Detail {
+
+constexpr i32 min_power_of_five = -342;
+constexpr i32 max_power_of_five = 324;
+
+//
+// The 128 most significant bits of '5^q' for every 'q' between -342 and 324, normalized such that the most significant
+// bit is set. The values are exact for 'q' between 0 and 55 and truncated otherwise, except for 'q' between -27 and -1,
+// which are rounded up. The table is shared by the floating-point parsing and formatting functions.
+//
+extern const u64 powers_of_five[max_power_of_five - min_power_of_five + 1][2];
+
+} // namespace Detail
+
+} // namespace AT
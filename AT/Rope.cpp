@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/MemoryOperations.h>
+#include <AT/Rope.h>
+#include <AT/StringBuilder.h>
+
+namespace AT {
+
+RopeNode::RopeNode(StringView chunk)
+    : m_chunk(chunk)
+    , m_byte_count(chunk.byte_span().count())
+    , m_codepoint_count(chunk.codepoint_count())
+    , m_line_break_count(chunk.count('\n'))
+    , m_height(0)
+{
+    AT_ASSERT(m_byte_count > 0);
+}
+
+RopeNode::RopeNode(RefPtr<RopeNode> left, RefPtr<RopeNode> right)
+    : m_left(move(left))
+    , m_right(move(right))
+{
+    m_byte_count = m_left->byte_count() + m_right->byte_count();
+    m_codepoint_count = m_left->codepoint_count() + m_right->codepoint_count();
+    m_line_break_count = m_left->line_break_count() + m_right->line_break_count();
+    const u32 left_height = m_left->height();
+    const u32 right_height = m_right->height();
+    m_height = ((left_height > right_height) ? left_height : right_height) + 1;
+    AT_ASSERT(m_height <= Rope::max_height);
+}
+
+//
+// The tree is kept balanced using the rules of an AVL tree: the heights of the two children of any node differ by at
+// most one. Every operation is expressed in terms of two primitives, which never mutate the existing nodes:
+//   - join(), which concatenates two trees. The shorter tree is attached along the spine of the taller one, so only
+//     the nodes on that spine are recreated (O(height difference)).
+//   - split(), which divides a tree at a byte offset. Each node on the path to the offset is recreated by joining
+//     its remaining subtrees (O(log n) in total, as the joined heights form a telescoping sum).
+//
+
+NODISCARD ALWAYS_INLINE static RefPtr<RopeNode> create_internal_node(RefPtr<RopeNode> left, RefPtr<RopeNode> right)
+{
+    return make_ref<RopeNode>(move(left), move(right));
+}
+
+NODISCARD ALWAYS_INLINE static bool is_codepoint_boundary(StringView chunk, usize offset)
+{
+    const ReadonlyByteSpan byte_span = chunk.byte_span();
+    return offset == byte_span.count() || (byte_span[offset] & 0xC0) != 0x80;
+}
+
+// Creates a node from two balanced trees, whose heights differ by at most two.
+NODISCARD static RefPtr<RopeNode> create_balanced_node(RefPtr<RopeNode> left, RefPtr<RopeNode> right)
+{
+    const u32 left_height = left->height();
+    const u32 right_height = right->height();
+
+    if (left_height > right_height + 1) {
+        // NOTE: The left tree is kept alive by the 'left' pointer, so its children can be referenced directly.
+        const RopeNode& left_node = *left;
+        if (left_node.left()->height() >= left_node.right()->height()) {
+            return create_internal_node(left_node.left(), create_internal_node(left_node.right(), move(right)));
+        }
+
+        const RopeNode& middle_node = *left_node.right();
+        return create_internal_node(create_internal_node(left_node.left(), middle_node.left()),
+                                    create_internal_node(middle_node.right(), move(right)));
+    }
+
+    if (right_height > left_height + 1) {
+        const RopeNode& right_node = *right;
+        if (right_node.right()->height() >= right_node.left()->height()) {
+            return create_internal_node(create_internal_node(move(left), right_node.left()), right_node.right());
+        }
+
+        const RopeNode& middle_node = *right_node.left();
+        return create_internal_node(create_internal_node(move(left), middle_node.left()),
+                                    create_internal_node(middle_node.right(), right_node.right()));
+    }
+
+    return create_internal_node(move(left), move(right));
+}
+
+NODISCARD static RefPtr<RopeNode> join(RefPtr<RopeNode> left, RefPtr<RopeNode> right)
+{
+    if (!left.is_valid()) {
+        return right;
+    }
+    if (!right.is_valid()) {
+        return left;
+    }
+
+    if (left->is_leaf() && right->is_leaf() && left->byte_count() + right->byte_count() <= Rope::max_chunk_byte_count) {
+        // NOTE: Merging small adjacent chunks keeps repeated small edits from fragmenting the rope into tiny leaves.
+        char merged_chunk[Rope::max_chunk_byte_count];
+        const ReadonlyByteSpan left_bytes = left->chunk().byte_span();
+        const ReadonlyByteSpan right_bytes = right->chunk().byte_span();
+        copy_memory(merged_chunk, left_bytes.elements(), left_bytes.count());
+        copy_memory(merged_chunk + left_bytes.count(), right_bytes.elements(), right_bytes.count());
+        return make_ref<RopeNode>(StringView::unsafe_create_from_utf8(merged_chunk, left_bytes.count() + right_bytes.count()));
+    }
+
+    const u32 left_height = left->height();
+    const u32 right_height = right->height();
+
+    if (left_height > right_height + 1) {
+        const RopeNode& left_node = *left;
+        return create_balanced_node(left_node.left(), join(left_node.right(), move(right)));
+    }
+
+    if (right_height > left_height + 1) {
+        const RopeNode& right_node = *right;
+        return create_balanced_node(join(move(left), right_node.left()), right_node.right());
+    }
+
+    return create_internal_node(move(left), move(right));
+}
+
+static void split(const RefPtr<RopeNode>& node, usize offset, RefPtr<RopeNode>& out_left, RefPtr<RopeNode>& out_right)
+{
+    if (!node.is_valid()) {
+        out_left.clear();
+        out_right.clear();
+        return;
+    }
+
+    if (offset == 0) {
+        out_left.clear();
+        out_right = node;
+        return;
+    }
+
+    if (offset == node->byte_count()) {
+        out_left = node;
+        out_right.clear();
+        return;
+    }
+
+    if (node->is_leaf()) {
+        const StringView chunk = node->chunk();
+        AT_ASSERT(is_codepoint_boundary(chunk, offset));
+        out_left = make_ref<RopeNode>(chunk.slice(0, offset));
+        out_right = make_ref<RopeNode>(chunk.slice(offset));
+        return;
+    }
+
+    const usize left_byte_count = node->left()->byte_count();
+    if (offset <= left_byte_count) {
+        RefPtr<RopeNode> middle;
+        split(node->left(), offset, out_left, middle);
+        out_right = join(move(middle), node->right());
+    }
+    else {
+        RefPtr<RopeNode> middle;
+        split(node->right(), offset - left_byte_count, middle, out_right);
+        out_left = join(node->left(), move(middle));
+    }
+}
+
+// Builds a perfectly balanced tree whose leaves are (almost) equally sized chunks of the string.
+NODISCARD static RefPtr<RopeNode> build_tree(StringView string_view)
+{
+    const ReadonlyByteSpan byte_span = string_view.byte_span();
+    if (byte_span.count() == 0) {
+        return {};
+    }
+    if (byte_span.count() <= Rope::max_chunk_byte_count) {
+        return make_ref<RopeNode>(string_view);
+    }
+
+    usize middle_offset = byte_span.count() / 2;
+    while (middle_offset > 0 && !is_codepoint_boundary(string_view, middle_offset)) {
+        --middle_offset;
+    }
+    AT_ASSERT(middle_offset > 0);
+
+    return create_internal_node(build_tree(string_view.slice(0, middle_offset)), build_tree(string_view.slice(middle_offset)));
+}
+
+Rope::Rope(StringView string_view)
+    : m_root(build_tree(string_view))
+{}
+
+char Rope::byte_at(usize offset) const
+{
+    AT_ASSERT(offset < byte_count());
+
+    const RopeNode* node = m_root.raw();
+    while (!node->is_leaf()) {
+        const usize left_byte_count = node->left()->byte_count();
+        if (offset < left_byte_count) {
+            node = node->left().raw();
+        }
+        else {
+            offset -= left_byte_count;
+            node = node->right().raw();
+        }
+    }
+
+    return static_cast<char>(node->chunk().byte_span()[offset]);
+}
+
+usize Rope::byte_offset_of_codepoint(usize codepoint_index) const
+{
+    AT_ASSERT(codepoint_index <= codepoint_count());
+    if (codepoint_index == codepoint_count()) {
+        return byte_count();
+    }
+
+    usize byte_offset = 0;
+    const RopeNode* node = m_root.raw();
+    while (!node->is_leaf()) {
+        const RopeNode& left_node = *node->left();
+        if (codepoint_index < left_node.codepoint_count()) {
+            node = &left_node;
+        }
+        else {
+            codepoint_index -= left_node.codepoint_count();
+            byte_offset += left_node.byte_count();
+            node = node->right().raw();
+        }
+    }
+
+    return byte_offset + UTF8::byte_offset_of_codepoint(node->chunk().byte_span(), codepoint_index);
+}
+
+usize Rope::byte_offset_of_line(usize line_index) const
+{
+    AT_ASSERT(line_index < line_count());
+    if (line_index == 0) {
+        return 0;
+    }
+
+    // NOTE: The line starts after the line break with the index 'line_index - 1'.
+    usize line_break_index = line_index - 1;
+    usize byte_offset = 0;
+    const RopeNode* node = m_root.raw();
+    while (!node->is_leaf()) {
+        const RopeNode& left_node = *node->left();
+        if (line_break_index < left_node.line_break_count()) {
+            node = &left_node;
+        }
+        else {
+            line_break_index -= left_node.line_break_count();
+            byte_offset += left_node.byte_count();
+            node = node->right().raw();
+        }
+    }
+
+    StringView remaining_chunk = node->chunk();
+    usize chunk_offset = 0;
+    while (true) {
+        const usize line_break_offset = remaining_chunk.find('\n');
+        AT_ASSERT(line_break_offset != StringView::invalid_position);
+        if (line_break_index == 0) {
+            return byte_offset + chunk_offset + line_break_offset + 1;
+        }
+
+        --line_break_index;
+        chunk_offset += line_break_offset + 1;
+        remaining_chunk = remaining_chunk.slice(line_break_offset + 1);
+    }
+}
+
+void Rope::append(StringView string_view)
+{
+    m_root = join(move(m_root), build_tree(string_view));
+}
+
+void Rope::append(const Rope& other)
+{
+    m_root = join(move(m_root), other.m_root);
+}
+
+void Rope::insert(usize offset, StringView string_view)
+{
+    AT_ASSERT(offset <= byte_count());
+
+    RefPtr<RopeNode> left;
+    RefPtr<RopeNode> right;
+    split(m_root, offset, left, right);
+    m_root = join(join(move(left), build_tree(string_view)), move(right));
+}
+
+void Rope::insert(usize offset, const Rope& other)
+{
+    AT_ASSERT(offset <= byte_count());
+
+    RefPtr<RopeNode> left;
+    RefPtr<RopeNode> right;
+    split(m_root, offset, left, right);
+    m_root = join(join(move(left), other.m_root), move(right));
+}
+
+void Rope::erase(usize offset, usize erased_byte_count)
+{
+    AT_ASSERT(offset + erased_byte_count <= byte_count());
+
+    RefPtr<RopeNode> left;
+    RefPtr<RopeNode> remaining;
+    split(m_root, offset, left, remaining);
+
+    RefPtr<RopeNode> erased;
+    RefPtr<RopeNode> right;
+    split(remaining, erased_byte_count, erased, right);
+
+    m_root = join(move(left), move(right));
+}
+
+Rope Rope::substring(usize offset, usize substring_byte_count) const
+{
+    AT_ASSERT(offset + substring_byte_count <= byte_count());
+
+    RefPtr<RopeNode> left;
+    RefPtr<RopeNode> remaining;
+    split(m_root, offset, left, remaining);
+
+    RefPtr<RopeNode> middle;
+    RefPtr<RopeNode> right;
+    split(remaining, substring_byte_count, middle, right);
+
+    return Rope(move(middle));
+}
+
+Rope Rope::substring(usize offset) const
+{
+    AT_ASSERT(offset <= byte_count());
+    return substring(offset, byte_count() - offset);
+}
+
+String Rope::to_string() const
+{
+    StringBuilder builder;
+    builder.ensure_capacity(byte_count());
+    for (StringView chunk : chunks()) {
+        builder.append(chunk);
+    }
+    return builder.build();
+}
+
+Rope::ChunkIterator::ChunkIterator(const RopeNode* root)
+    : m_stack_size(0)
+{
+    if (root) {
+        descend_to_leftmost_leaf(root);
+    }
+}
+
+Rope::ChunkIterator& Rope::ChunkIterator::operator++()
+{
+    AT_ASSERT(m_stack_size > 0);
+
+    // Pop the current leaf. The next leaf is the leftmost leaf of the right subtree of the closest ancestor.
+    --m_stack_size;
+    if (m_stack_size > 0) {
+        const RopeNode* parent = m_stack[--m_stack_size];
+        descend_to_leftmost_leaf(parent->right().raw());
+    }
+    return *this;
+}
+
+void Rope::ChunkIterator::descend_to_leftmost_leaf(const RopeNode* node)
+{
+    while (!node->is_leaf()) {
+        m_stack[m_stack_size++] = node;
+        node = node->left().raw();
+    }
+    m_stack[m_stack_size++] = node;
+}
+
+} // namespace AT
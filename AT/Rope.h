@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/RefPtr.h>
+#include <AT/String.h>
+#include <AT/StringView.h>
+
+namespace AT {
+
+//
+// Node of the tree that represents a rope. A node is either a leaf, which holds a chunk of the text, or an internal
+// node, which concatenates its two children. Nodes are never mutated after they are created, so they can be shared
+// by any number of ropes (or by the same rope, multiple times). Each node caches the counts of the text it covers.
+//
+class RopeNode : public RefCounted<RopeNode> {
+public:
+    AT_API explicit RopeNode(StringView chunk);
+    AT_API RopeNode(RefPtr<RopeNode> left, RefPtr<RopeNode> right);
+    virtual ~RopeNode() override = default;
+
+public:
+    NODISCARD ALWAYS_INLINE bool is_leaf() const { return !m_left.is_valid(); }
+
+    // NOTE: Only valid for leaf nodes.
+    NODISCARD ALWAYS_INLINE StringView chunk() const { return m_chunk.view(); }
+
+    // NOTE: Only valid for internal nodes.
+    NODISCARD ALWAYS_INLINE const RefPtr<RopeNode>& left() const { return m_left; }
+    NODISCARD ALWAYS_INLINE const RefPtr<RopeNode>& right() const { return m_right; }
+
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
+    NODISCARD ALWAYS_INLINE usize codepoint_count() const { return m_codepoint_count; }
+    NODISCARD ALWAYS_INLINE usize line_break_count() const { return m_line_break_count; }
+    // NOTE: Leaves have a height of zero.
+    NODISCARD ALWAYS_INLINE u32 height() const { return m_height; }
+
+private:
+    String m_chunk;
+    RefPtr<RopeNode> m_left;
+    RefPtr<RopeNode> m_right;
+    usize m_byte_count;
+    usize m_codepoint_count;
+    usize m_line_break_count;
+    u32 m_height;
+};
+
+//
+// A UTF-8 encoded string that is stored as a balanced (AVL) tree of immutable chunks, designed for large texts that
+// are frequently edited. Inserting, erasing and extracting a substring only rebuild the O(log n) nodes along the
+// edited paths, while all the other nodes (and the chunks they hold) are shared with the previous version of the
+// rope. Concatenating two ropes is O(log n) as well, and copying a rope is O(1).
+//
+// All offsets are in bytes and must be codepoint boundaries.
+// NOTE: The reference counts of the nodes are not atomic, so a rope (or its copies) can't be used by multiple threads.
+//
+class Rope {
+public:
+    // NOTE: Bigger chunks make the iteration and the counting faster, but every edit copies up to two chunks.
+    static constexpr usize max_chunk_byte_count = 1024;
+    // NOTE: An AVL tree with this height would need more nodes than can be addressed.
+    static constexpr u32 max_height = 92;
+
+public:
+    Rope() = default;
+    AT_API explicit Rope(StringView string_view);
+
+    Rope(const Rope&) = default;
+    Rope(Rope&&) noexcept = default;
+    Rope& operator=(const Rope&) = default;
+    Rope& operator=(Rope&&) noexcept = default;
+
+    ~Rope() = default;
+
+public:
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return !m_root.is_valid(); }
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_root.is_valid() ? m_root->byte_count() : 0; }
+    NODISCARD ALWAYS_INLINE usize codepoint_count() const { return m_root.is_valid() ? m_root->codepoint_count() : 0; }
+
+    // NOTE: The number of lines is one greater than the number of line breaks ('\n'), so an empty rope has one line.
+    NODISCARD ALWAYS_INLINE usize line_count() const { return (m_root.is_valid() ? m_root->line_break_count() : 0) + 1; }
+
+    // Returns the byte at the given offset. The offset doesn't have to be a codepoint boundary.
+    NODISCARD AT_API char byte_at(usize offset) const;
+
+    //
+    // Returns the offset (in bytes) of the codepoint with the given index.
+    // The index can be equal to the codepoint count, in which case the byte count of the rope is returned.
+    //
+    NODISCARD AT_API usize byte_offset_of_codepoint(usize codepoint_index) const;
+
+    //
+    // Returns the offset (in bytes) of the first byte of the line with the given index, which is the offset after the
+    // line break that ends the previous line. The index must be less than the line count.
+    //
+    NODISCARD AT_API usize byte_offset_of_line(usize line_index) const;
+
+public:
+    AT_API void append(StringView string_view);
+    AT_API void append(const Rope& other);
+
+    AT_API void insert(usize offset, StringView string_view);
+    AT_API void insert(usize offset, const Rope& other);
+
+    AT_API void erase(usize offset, usize byte_count);
+    ALWAYS_INLINE void clear() { m_root.clear(); }
+
+    NODISCARD AT_API Rope substring(usize offset, usize byte_count) const;
+    NODISCARD AT_API Rope substring(usize offset) const;
+
+    // Copies the whole text of the rope into a string.
+    NODISCARD AT_API String to_string() const;
+
+public:
+    //
+    // Iterates over the chunks of the rope, in order. Each chunk is a non-empty view into a leaf of the tree, so it
+    // remains valid for as long as the rope (or any other rope that shares the leaf) is not destroyed.
+    //
+    class ChunkIterator {
+    public:
+        ALWAYS_INLINE ChunkIterator()
+            : m_stack_size(0)
+        {}
+
+        AT_API explicit ChunkIterator(const RopeNode* root);
+
+        NODISCARD ALWAYS_INLINE bool operator==(const ChunkIterator& other) const
+        {
+            return (m_stack_size == 0 && other.m_stack_size == 0) ||
+                   (m_stack_size == other.m_stack_size && m_stack[m_stack_size - 1] == other.m_stack[m_stack_size - 1]);
+        }
+
+        NODISCARD ALWAYS_INLINE bool operator!=(const ChunkIterator& other) const { return !(*this == other); }
+
+        NODISCARD ALWAYS_INLINE StringView operator*() const
+        {
+            AT_ASSERT(m_stack_size > 0);
+            return m_stack[m_stack_size - 1]->chunk();
+        }
+
+        AT_API ChunkIterator& operator++();
+
+    private:
+        // Pushes the path from the given node to its leftmost leaf.
+        void descend_to_leftmost_leaf(const RopeNode* node);
+
+    private:
+        // NOTE: The path from the root to the current leaf. The top of the stack is the current leaf, and all the other
+        //       entries are internal nodes whose right subtree wasn't visited yet.
+        const RopeNode* m_stack[max_height + 1];
+        u32 m_stack_size;
+    };
+
+    class ChunkRange {
+    public:
+        ALWAYS_INLINE explicit ChunkRange(const RopeNode* root)
+            : m_root(root)
+        {}
+
+        NODISCARD ALWAYS_INLINE ChunkIterator begin() const { return ChunkIterator(m_root); }
+        NODISCARD ALWAYS_INLINE ChunkIterator end() const { return ChunkIterator(); }
+
+    private:
+        const RopeNode* m_root;
+    };
+
+    NODISCARD ALWAYS_INLINE ChunkRange chunks() const { return ChunkRange(m_root.raw()); }
+
+private:
+    ALWAYS_INLINE explicit Rope(RefPtr<RopeNode> root)
+        : m_root(move(root))
+    {}
+
+private:
+    RefPtr<RopeNode> m_root;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::Rope;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Optional.h>
+#include <AT/Vector.h>
+
+namespace AT {
+
+//
+// Handle that identifies a value stored in a SlotMap. It is a 64-bit integer that packs the index of a slot (low half)
+// and the generation of that slot at the moment the value was added (high half). When the value is removed the slot
+// generation changes, so any handle that still refers to it becomes stale and can be safely detected.
+// The handle is trivially copyable, so it can be freely passed around without any reference counting overhead.
+//
+class SlotHandle {
+public:
+    ALWAYS_INLINE SlotHandle()
+        : m_value(0)
+    {}
+
+    ALWAYS_INLINE SlotHandle(u32 slot_index, u32 generation)
+        : m_value((static_cast<u64>(generation) << 32) | static_cast<u64>(slot_index))
+    {}
+
+    NODISCARD ALWAYS_INLINE static SlotHandle create_from_value(u64 value)
+    {
+        SlotHandle handle;
+        handle.m_value = value;
+        return handle;
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE u64 value() const { return m_value; }
+    NODISCARD ALWAYS_INLINE u32 slot_index() const { return static_cast<u32>(m_value); }
+    NODISCARD ALWAYS_INLINE u32 generation() const { return static_cast<u32>(m_value >> 32); }
+
+    // NOTE: The generation of an occupied slot is always odd, so a default constructed handle is never valid.
+    NODISCARD ALWAYS_INLINE bool is_null() const { return (generation() == 0); }
+
+    NODISCARD ALWAYS_INLINE bool operator==(const SlotHandle& other) const { return m_value == other.m_value; }
+    NODISCARD ALWAYS_INLINE bool operator!=(const SlotHandle& other) const { return m_value != other.m_value; }
+
+private:
+    u64 m_value;
+};
+
+enum class SlotMapRemoveResult {
+    RemovedExistingValue,
+    HandleIsStale,
+};
+
+//
+// Container that stores values densely (in a contiguous vector, in no particular order) and hands out generational
+// handles to them. Adding, removing and looking up a value are all constant time operations. Removing a value moves
+// the last value into its place, so iterating over the values is always as fast as iterating over a Vector.
+// Looking up a value using a handle that refers to a removed value is detected and never returns another value.
+//
+template<typename T>
+requires (!is_reference<T>)
+class SlotMap {
+private:
+    static constexpr u32 invalid_slot_index = static_cast<u32>(-1);
+
+    struct Slot {
+        // If the slot is occupied, this represents the index of the value in the dense array. Otherwise, it represents
+        // the index of the next free slot (forming an intrusive linked list).
+        u32 dense_index_or_next_free;
+        // NOTE: The generation is odd if the slot is occupied and even if the slot is free.
+        u32 generation;
+    };
+
+public:
+    using Iterator = typename Vector<T>::Iterator;
+    using ConstIterator = typename Vector<T>::ConstIterator;
+
+public:
+    ALWAYS_INLINE SlotMap()
+        : m_free_slot_head(invalid_slot_index)
+    {}
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_values.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_values.is_empty(); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return m_values.has_elements(); }
+
+    // NOTE: The values are stored densely, but their order is unspecified and changes when values are removed.
+    NODISCARD ALWAYS_INLINE Span<T> values() { return m_values.span(); }
+    NODISCARD ALWAYS_INLINE Span<const T> values() const { return m_values.span(); }
+
+    // Returns the handle of the value that is currently located at the given index in the dense array.
+    NODISCARD ALWAYS_INLINE SlotHandle handle_of_value_at(usize dense_index) const
+    {
+        const u32 slot_index = m_dense_to_slot[dense_index];
+        return SlotHandle(slot_index, m_slots[slot_index].generation);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE bool contains(SlotHandle handle) const { return is_handle_valid(handle); }
+
+    NODISCARD ALWAYS_INLINE Optional<T&> get_if_exists(SlotHandle handle)
+    {
+        if (!is_handle_valid(handle)) {
+            return {};
+        }
+        return m_values[m_slots[handle.slot_index()].dense_index_or_next_free];
+    }
+
+    NODISCARD ALWAYS_INLINE Optional<const T&> get_if_exists(SlotHandle handle) const
+    {
+        if (!is_handle_valid(handle)) {
+            return {};
+        }
+        return m_values[m_slots[handle.slot_index()].dense_index_or_next_free];
+    }
+
+    NODISCARD ALWAYS_INLINE T& at(SlotHandle handle)
+    {
+        AT_ASSERT(is_handle_valid(handle));
+        return m_values[m_slots[handle.slot_index()].dense_index_or_next_free];
+    }
+
+    NODISCARD ALWAYS_INLINE const T& at(SlotHandle handle) const
+    {
+        AT_ASSERT(is_handle_valid(handle));
+        return m_values[m_slots[handle.slot_index()].dense_index_or_next_free];
+    }
+
+    NODISCARD ALWAYS_INLINE T& operator[](SlotHandle handle) { return at(handle); }
+    NODISCARD ALWAYS_INLINE const T& operator[](SlotHandle handle) const { return at(handle); }
+
+public:
+    ALWAYS_INLINE SlotHandle add(const T& value) { return emplace(value); }
+    ALWAYS_INLINE SlotHandle add(T&& value) { return emplace(move(value)); }
+
+    template<typename... Args>
+    SlotHandle emplace(Args&&... args)
+    {
+        AT_ASSERT(m_values.count() < static_cast<usize>(invalid_slot_index));
+        const u32 dense_index = static_cast<u32>(m_values.count());
+
+        u32 slot_index;
+        if (m_free_slot_head != invalid_slot_index) {
+            slot_index = m_free_slot_head;
+            m_free_slot_head = m_slots[slot_index].dense_index_or_next_free;
+        }
+        else {
+            slot_index = static_cast<u32>(m_slots.count());
+            m_slots.add({ invalid_slot_index, 0 });
+        }
+
+        m_values.emplace(forward<Args>(args)...);
+        m_dense_to_slot.add(slot_index);
+
+        Slot& slot = m_slots[slot_index];
+        slot.dense_index_or_next_free = dense_index;
+        ++slot.generation;
+        return SlotHandle(slot_index, slot.generation);
+    }
+
+    ALWAYS_INLINE void remove(SlotHandle handle)
+    {
+        MAYBE_UNUSED const SlotMapRemoveResult result = remove_if_exists(handle);
+        AT_ASSERT(result == SlotMapRemoveResult::RemovedExistingValue);
+    }
+
+    SlotMapRemoveResult remove_if_exists(SlotHandle handle)
+    {
+        if (!is_handle_valid(handle)) {
+            return SlotMapRemoveResult::HandleIsStale;
+        }
+
+        Slot& slot = m_slots[handle.slot_index()];
+        const u32 dense_index = slot.dense_index_or_next_free;
+        const u32 last_dense_index = static_cast<u32>(m_values.count() - 1);
+
+        if (dense_index != last_dense_index) {
+            // Move the last value into the hole, so the values remain densely packed.
+            m_values[dense_index] = move(m_values[last_dense_index]);
+            m_dense_to_slot[dense_index] = m_dense_to_slot[last_dense_index];
+            m_slots[m_dense_to_slot[dense_index]].dense_index_or_next_free = dense_index;
+        }
+        m_values.remove_last();
+        m_dense_to_slot.remove_last();
+
+        ++slot.generation;
+        slot.dense_index_or_next_free = m_free_slot_head;
+        m_free_slot_head = handle.slot_index();
+
+        return SlotMapRemoveResult::RemovedExistingValue;
+    }
+
+    //
+    // Removes all values from the map. All handles that were given before become stale, but the slots are kept, so
+    // the memory can be reused when adding new values.
+    //
+    void clear()
+    {
+        for (usize dense_index = 0; dense_index < m_dense_to_slot.count(); ++dense_index) {
+            Slot& slot = m_slots[m_dense_to_slot[dense_index]];
+            ++slot.generation;
+            slot.dense_index_or_next_free = m_free_slot_head;
+            m_free_slot_head = m_dense_to_slot[dense_index];
+        }
+
+        m_values.clear();
+        m_dense_to_slot.clear();
+    }
+
+    ALWAYS_INLINE void ensure_capacity(usize required_capacity)
+    {
+        m_values.ensure_capacity(required_capacity);
+        m_dense_to_slot.ensure_capacity(required_capacity);
+        m_slots.ensure_capacity(required_capacity);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE Iterator begin() { return m_values.begin(); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return m_values.end(); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return m_values.begin(); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return m_values.end(); }
+
+private:
+    NODISCARD ALWAYS_INLINE bool is_handle_valid(SlotHandle handle) const
+    {
+        if (handle.slot_index() >= m_slots.count()) {
+            return false;
+        }
+        // NOTE: Free slots have an even generation, so a handle with an odd generation that matches the slot generation
+        //       always refers to an occupied slot.
+        return (handle.generation() & 1) && m_slots[handle.slot_index()].generation == handle.generation();
+    }
+
+private:
+    Vector<T> m_values;
+    // Maps the index of a value in the dense array to the index of the slot that refers to it.
+    Vector<u32> m_dense_to_slot;
+    Vector<Slot> m_slots;
+    u32 m_free_slot_head;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::SlotHandle;
+using AT::SlotMap;
+using AT::SlotMapRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Optional.h>
+#include <AT/Vector.h>
+
+namespace AT {
+
+enum class SparseSetRemoveResult {
+    RemovedExistingKey,
+    KeyDoesNotExist,
+};
+
+//
+// Associative container that maps small integer keys (such as indices of generational handles) to values.
+// The values and their keys are stored densely in two parallel arrays, while a sparse array (indexed by the key) stores
+// the position of each key in the dense arrays. Adding, removing and looking up a value are constant time operations
+// that never hash or compare, and iterating over the values is a linear scan of contiguous memory.
+// The sparse array grows up to the greatest key that was ever added, so the keys should be allocated densely.
+//
+template<typename T>
+requires (!is_reference<T>)
+class SparseSet {
+public:
+    static constexpr u32 invalid_dense_index = static_cast<u32>(-1);
+
+    using Iterator = typename Vector<T>::Iterator;
+    using ConstIterator = typename Vector<T>::ConstIterator;
+
+public:
+    NODISCARD ALWAYS_INLINE usize count() const { return m_values.count(); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return m_values.is_empty(); }
+    NODISCARD ALWAYS_INLINE bool has_elements() const { return m_values.has_elements(); }
+
+    // NOTE: The keys and the values are parallel arrays. Their order is unspecified and changes when keys are removed.
+    NODISCARD ALWAYS_INLINE Span<const u32> keys() const { return m_keys.span(); }
+    NODISCARD ALWAYS_INLINE Span<T> values() { return m_values.span(); }
+    NODISCARD ALWAYS_INLINE Span<const T> values() const { return m_values.span(); }
+
+public:
+    NODISCARD ALWAYS_INLINE bool contains(u32 key) const { return dense_index_of(key) != invalid_dense_index; }
+
+    // Returns the position of the key in the dense arrays, or 'invalid_dense_index' if the key doesn't exist.
+    NODISCARD ALWAYS_INLINE u32 dense_index_of(u32 key) const
+    {
+        if (key >= m_sparse.count()) {
+            return invalid_dense_index;
+        }
+        return m_sparse[key];
+    }
+
+    NODISCARD ALWAYS_INLINE Optional<T&> get_if_exists(u32 key)
+    {
+        const u32 dense_index = dense_index_of(key);
+        if (dense_index == invalid_dense_index) {
+            return {};
+        }
+        return m_values[dense_index];
+    }
+
+    NODISCARD ALWAYS_INLINE Optional<const T&> get_if_exists(u32 key) const
+    {
+        const u32 dense_index = dense_index_of(key);
+        if (dense_index == invalid_dense_index) {
+            return {};
+        }
+        return m_values[dense_index];
+    }
+
+    NODISCARD ALWAYS_INLINE T& at(u32 key)
+    {
+        const u32 dense_index = dense_index_of(key);
+        AT_ASSERT(dense_index != invalid_dense_index);
+        return m_values[dense_index];
+    }
+
+    NODISCARD ALWAYS_INLINE const T& at(u32 key) const
+    {
+        const u32 dense_index = dense_index_of(key);
+        AT_ASSERT(dense_index != invalid_dense_index);
+        return m_values[dense_index];
+    }
+
+    NODISCARD ALWAYS_INLINE T& operator[](u32 key) { return at(key); }
+    NODISCARD ALWAYS_INLINE const T& operator[](u32 key) const { return at(key); }
+
+public:
+    ALWAYS_INLINE T& add(u32 key, const T& value) { return emplace(key, value); }
+    ALWAYS_INLINE T& add(u32 key, T&& value) { return emplace(key, move(value)); }
+
+    template<typename... Args>
+    T& emplace(u32 key, Args&&... args)
+    {
+        AT_ASSERT(key != invalid_dense_index);
+        AT_ASSERT(!contains(key)); // Key already exists.
+
+        if (key >= m_sparse.count()) {
+            // NOTE: Vector::add grows the capacity geometrically, so growing the sparse array is amortized constant time.
+            m_sparse.ensure_capacity(static_cast<usize>(key) + 1);
+            while (m_sparse.count() <= key) {
+                m_sparse.add(invalid_dense_index);
+            }
+        }
+
+        m_sparse[key] = static_cast<u32>(m_values.count());
+        m_keys.add(key);
+        return m_values.emplace(forward<Args>(args)...);
+    }
+
+    ALWAYS_INLINE void remove(u32 key)
+    {
+        MAYBE_UNUSED const SparseSetRemoveResult result = remove_if_exists(key);
+        AT_ASSERT(result == SparseSetRemoveResult::RemovedExistingKey);
+    }
+
+    SparseSetRemoveResult remove_if_exists(u32 key)
+    {
+        const u32 dense_index = dense_index_of(key);
+        if (dense_index == invalid_dense_index) {
+            return SparseSetRemoveResult::KeyDoesNotExist;
+        }
+
+        const u32 last_dense_index = static_cast<u32>(m_values.count() - 1);
+        if (dense_index != last_dense_index) {
+            // Move the last entry into the hole, so the dense arrays remain tightly packed.
+            m_values[dense_index] = move(m_values[last_dense_index]);
+            m_keys[dense_index] = m_keys[last_dense_index];
+            m_sparse[m_keys[dense_index]] = dense_index;
+        }
+
+        m_values.remove_last();
+        m_keys.remove_last();
+        m_sparse[key] = invalid_dense_index;
+        return SparseSetRemoveResult::RemovedExistingKey;
+    }
+
+    void clear()
+    {
+        for (u32 key : m_keys) {
+            m_sparse[key] = invalid_dense_index;
+        }
+
+        m_values.clear();
+        m_keys.clear();
+    }
+
+    ALWAYS_INLINE void ensure_capacity(usize required_capacity)
+    {
+        m_values.ensure_capacity(required_capacity);
+        m_keys.ensure_capacity(required_capacity);
+    }
+
+public:
+    NODISCARD ALWAYS_INLINE Iterator begin() { return m_values.begin(); }
+    NODISCARD ALWAYS_INLINE Iterator end() { return m_values.end(); }
+
+    NODISCARD ALWAYS_INLINE ConstIterator begin() const { return m_values.begin(); }
+    NODISCARD ALWAYS_INLINE ConstIterator end() const { return m_values.end(); }
+
+private:
+    Vector<T> m_values;
+    Vector<u32> m_keys;
+    Vector<u32> m_sparse;
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::SparseSet;
+using AT::SparseSetRemoveResult;
+#endif // AT_INCLUDE_GLOBALLY
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: BSD-3-Clause.
  */
 
+#include <AT/Ascii.h>
 #include <AT/MemoryOperations.h>
 #include <AT/String.h>
 
@@ -22,94 +23,140 @@ String String::create_from_utf8(const char* null_terminated_characters)
 
 String::String()
 {
-    m_inline_buffer[0] = 0;
-    m_byte_count = 1;
+    set_inline_byte_count(0);
 }
 
 String::~String()
 {
     if (is_stored_on_heap())
-        release_memory(m_heap_buffer, m_byte_count);
+        release_memory(m_heap.buffer, heap_capacity());
 }
 
 String::String(const String& other)
 {
-    // Forward the constructor to the StringView overload.
-    new (this) String(other.view());
+    initialize_from_bytes(reinterpret_cast<const char*>(other.bytes()), other.byte_count());
 }
 
 String::String(String&& other) noexcept
-    : m_heap_buffer(other.m_heap_buffer)
-    , m_byte_count(other.m_byte_count)
+    : m_heap(other.m_heap)
 {
-    other.m_inline_buffer[0] = 0;
-    other.m_byte_count = 1;
+    other.clear_without_releasing();
 }
 
 String::String(StringView string_view)
-    : m_byte_count(string_view.byte_span().count() + 1)
 {
-    char* destination_buffer = m_inline_buffer;
-
-    if (is_stored_on_heap()) {
-        m_heap_buffer = allocate_memory(m_byte_count);
-        destination_buffer = m_heap_buffer;
-    }
-
-    copy_memory_from_span(destination_buffer, string_view.byte_span());
-    destination_buffer[m_byte_count - 1] = 0;
+    auto span = string_view.byte_span().as<const char>();
+    initialize_from_bytes(span.elements(), span.count());
 }
 
 String& String::operator=(const String& other)
 {
+    if (this == &other)
+        return *this;
+
     *this = other.view();
     return *this;
 }
 
 String& String::operator=(String&& other) noexcept
 {
-    if (is_stored_on_heap())
-        release_memory(m_heap_buffer, m_byte_count);
+    if (this == &other)
+        return *this;
 
-    m_heap_buffer = other.m_heap_buffer;
-    m_byte_count = other.m_byte_count;
+    if (is_stored_on_heap())
+        release_memory(m_heap.buffer, heap_capacity());
 
-    zero_memory(other.m_inline_buffer, inline_capacity);
-    other.m_inline_buffer[0] = 0;
-    other.m_byte_count = 1;
+    m_heap = other.m_heap;
+    other.clear_without_releasing();
 
     return *this;
 }
 
 String& String::operator=(StringView string_view)
 {
-    usize byte_count = string_view.byte_span().count() + 1;
-    char* destination_buffer = m_inline_buffer;
+    auto span = string_view.byte_span().as<const char>();
+    const usize byte_count = span.count();
 
-    if (is_stored_inline()) {
-        if (byte_count > inline_capacity) {
-            m_heap_buffer = allocate_memory(byte_count);
-            destination_buffer = m_heap_buffer;
+    // NOTE: The string view might point inside the current buffer (for example, if it is a slice of this string).
+    //       When the current buffer is reused, the destination is never located after the source and the bytes are
+    //       copied front-to-back, so the copy is safe. Otherwise, the view is longer than the current capacity, so it
+    //       can't point inside the current buffer.
+    if (is_stored_on_heap()) {
+        if (byte_count + 1 <= heap_capacity()) {
+            copy_memory(m_heap.buffer, span.elements(), byte_count);
+            m_heap.buffer[byte_count] = 0;
+            m_heap.byte_count = byte_count;
+            return *this;
         }
+
+        char* old_heap_buffer = m_heap.buffer;
+        const usize old_heap_capacity = heap_capacity();
+        initialize_from_bytes(span.elements(), byte_count);
+        release_memory(old_heap_buffer, old_heap_capacity);
+        return *this;
     }
-    else {
-        if (byte_count <= inline_capacity) {
-            release_memory(m_heap_buffer, m_byte_count);
-        }
-        else {
-            if (m_byte_count != byte_count) {
-                release_memory(m_heap_buffer, m_byte_count);
-                m_heap_buffer = allocate_memory(byte_count);
-            }
-            destination_buffer = m_heap_buffer;
-        }
+
+    initialize_from_bytes(span.elements(), byte_count);
+    return *this;
+}
+
+void String::make_ascii_lowercase()
+{
+    const usize string_byte_count = byte_count();
+    ASCII::to_lowercase(ReadonlyByteSpan(bytes(), string_byte_count), WriteonlyByteSpan(mutable_bytes(), string_byte_count));
+}
+
+void String::make_ascii_uppercase()
+{
+    const usize string_byte_count = byte_count();
+    ASCII::to_uppercase(ReadonlyByteSpan(bytes(), string_byte_count), WriteonlyByteSpan(mutable_bytes(), string_byte_count));
+}
+
+String String::create_by_adopting_heap_buffer(char* heap_buffer, usize byte_count, usize capacity)
+{
+    AT_ASSERT(byte_count < capacity);
+    AT_ASSERT((capacity & heap_capacity_flag) == 0);
+    AT_ASSERT(heap_buffer[byte_count] == 0);
+
+    String string;
+    string.m_heap.buffer = heap_buffer;
+    string.m_heap.byte_count = byte_count;
+    string.m_heap.capacity_and_flag = capacity | heap_capacity_flag;
+    return string;
+}
+
+void String::initialize_from_bytes(const char* characters, usize byte_count)
+{
+    if (byte_count < inline_capacity) {
+        copy_memory(m_inline_buffer, characters, byte_count);
+        set_inline_byte_count(byte_count);
+        return;
     }
 
-    m_byte_count = byte_count;
-    copy_memory_from_span(destination_buffer, string_view.byte_span());
-    destination_buffer[m_byte_count - 1] = 0;
+    // NOTE: The buffer is allocated to fit the string exactly, as strings rarely grow after they are created.
+    const usize capacity = byte_count + 1;
+    AT_ASSERT((capacity & heap_capacity_flag) == 0);
 
-    return *this;
+    char* heap_buffer = allocate_memory(capacity);
+    copy_memory(heap_buffer, characters, byte_count);
+    heap_buffer[byte_count] = 0;
+
+    m_heap.buffer = heap_buffer;
+    m_heap.byte_count = byte_count;
+    m_heap.capacity_and_flag = capacity | heap_capacity_flag;
+}
+
+void String::set_inline_byte_count(usize byte_count)
+{
+    AT_ASSERT_DEBUG(byte_count < inline_capacity);
+    m_inline_buffer[byte_count] = 0;
+    // NOTE: If the inline buffer is full, this writes zero over the null-termination byte, which is correct.
+    m_inline_buffer[inline_capacity - 1] = static_cast<char>((inline_capacity - 1) - byte_count);
+}
+
+void String::clear_without_releasing()
+{
+    set_inline_byte_count(0);
 }
 
 char* String::allocate_memory(usize byte_count)
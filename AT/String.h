@@ -12,15 +12,18 @@ namespace AT {
 
 //
 // Container that stores a UTF-8 encoded, null-terminated string.
-// If the string is small enough, the threshold being determined by the platform
-// architecture, no memory will be allocated from the heap and the characters will
-// be instead stored inline. This allows small strings to be very efficient in terms
-// of performance, as copying and creating them would be very cheap.
+// The string object is 24 bytes big and strings of up to 23 bytes (excluding the null-termination byte) are stored
+// inline, without allocating any memory from the heap. This covers almost all identifiers, keys and log fragments,
+// so creating and copying them is very cheap. Longer strings are stored in a heap buffer that tracks its capacity,
+// so assigning a string that fits in the current buffer doesn't allocate either.
 //
 class String {
+    friend class StringBuilder;
+
 public:
-    static constexpr usize inline_capacity = sizeof(char*);
-    static_assert(inline_capacity > 0);
+    // NOTE: The number of bytes (including the null-termination byte) that can be stored inline.
+    static constexpr usize inline_capacity = 3 * sizeof(char*);
+    static_assert(inline_capacity > 0 && inline_capacity <= 128);
 
 public:
     AT_API static String create_from_utf8(const char* characters, usize byte_count);
@@ -47,25 +50,17 @@ public:
         return StringView::unsafe_create_from_utf8(span.elements(), span.count() * span.element_size());
     }
 
-    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span() const
-    {
-        AT_ASSERT(m_byte_count > 0);
-        const auto* bytes = reinterpret_cast<ReadonlyBytes>(is_stored_inline() ? m_inline_buffer : m_heap_buffer);
-        return ReadonlyByteSpan(bytes, m_byte_count - 1);
-    }
-
-    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span_with_null_termination() const
-    {
-        AT_ASSERT(m_byte_count > 0);
-        const auto* bytes = reinterpret_cast<ReadonlyBytes>(is_stored_inline() ? m_inline_buffer : m_heap_buffer);
-        return ReadonlyByteSpan(bytes, m_byte_count);
-    }
+    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span() const { return ReadonlyByteSpan(bytes(), byte_count()); }
+    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span_with_null_termination() const { return ReadonlyByteSpan(bytes(), byte_count() + 1); }
 
     // For compatiblity with C-style APIs.
-    NODISCARD ALWAYS_INLINE const char* c_str() const { return byte_span_with_null_termination().as<const char>().elements(); }
+    NODISCARD ALWAYS_INLINE const char* c_str() const { return reinterpret_cast<const char*>(bytes()); }
+
+    // NOTE: The number of bytes (excluding the null-termination byte) that can be stored without reallocating.
+    NODISCARD ALWAYS_INLINE usize capacity() const { return is_stored_on_heap() ? (heap_capacity() - 1) : (inline_capacity - 1); }
 
-    NODISCARD ALWAYS_INLINE bool is_stored_inline() const { return m_byte_count <= inline_capacity; }
-    NODISCARD ALWAYS_INLINE bool is_stored_on_heap() const { return m_byte_count > inline_capacity; }
+    NODISCARD ALWAYS_INLINE bool is_stored_inline() const { return !is_stored_on_heap(); }
+    NODISCARD ALWAYS_INLINE bool is_stored_on_heap() const { return (static_cast<u8>(m_inline_buffer[inline_capacity - 1]) & heap_flag); }
 
 public:
     NODISCARD ALWAYS_INLINE bool operator==(const String& other) const { return (view() == other.view()); }
@@ -74,16 +69,81 @@ public:
     NODISCARD ALWAYS_INLINE bool operator!=(const String& other) const { return (view() != other.view()); }
     NODISCARD ALWAYS_INLINE bool operator!=(StringView string_view) const { return (view() != string_view); }
 
+public:
+    // Converts the ASCII letters of the string to lowercase (or uppercase) in place. The byte count of the string
+    // doesn't change, so no memory is ever allocated.
+    AT_API void make_ascii_lowercase();
+    AT_API void make_ascii_uppercase();
+
 private:
+    //
+    // The last byte of the object determines how the string is stored:
+    //   - If its most significant bit is set, the string is stored on the heap. The last byte is the most significant
+    //     byte of the 'capacity_and_flag' field (all supported architectures are little-endian).
+    //   - Otherwise, the string is stored inline and the last byte represents the number of unused inline bytes. When
+    //     the inline buffer is completely filled, this number is zero, so it doubles as the null-termination byte.
+    //
+    static constexpr u8 heap_flag = 0x80;
+    static constexpr usize heap_capacity_flag = static_cast<usize>(heap_flag) << (8 * (sizeof(usize) - 1));
+
+    struct HeapStorage {
+        char* buffer;
+        // NOTE: Excludes the null-termination byte.
+        usize byte_count;
+        // NOTE: Includes the null-termination byte.
+        usize capacity_and_flag;
+    };
+
+    NODISCARD ALWAYS_INLINE ReadonlyBytes bytes() const
+    {
+        // NOTE: Written as a select, so the compiler can emit a conditional move instead of a branch.
+        const char* characters = is_stored_on_heap() ? m_heap.buffer : m_inline_buffer;
+        return reinterpret_cast<ReadonlyBytes>(characters);
+    }
+
+    NODISCARD ALWAYS_INLINE usize byte_count() const
+    {
+        const usize inline_byte_count = (inline_capacity - 1) - static_cast<u8>(m_inline_buffer[inline_capacity - 1]);
+        return is_stored_on_heap() ? m_heap.byte_count : inline_byte_count;
+    }
+
+    NODISCARD ALWAYS_INLINE usize heap_capacity() const { return m_heap.capacity_and_flag & ~heap_capacity_flag; }
+
+    NODISCARD ALWAYS_INLINE WriteonlyBytes mutable_bytes()
+    {
+        char* characters = is_stored_on_heap() ? m_heap.buffer : m_inline_buffer;
+        return reinterpret_cast<WriteonlyBytes>(characters);
+    }
+
+    // Creates a string that takes the ownership of a heap buffer, allocated using String::allocate_memory().
+    // NOTE: The buffer must already contain the null-termination byte and the capacity must include it.
+    NODISCARD static String create_by_adopting_heap_buffer(char* heap_buffer, usize byte_count, usize capacity);
+
+    void initialize_from_bytes(const char* characters, usize byte_count);
+    void set_inline_byte_count(usize byte_count);
+    void clear_without_releasing();
+
     NODISCARD static char* allocate_memory(usize byte_count);
     static void release_memory(char* heap_buffer, usize byte_count);
 
 private:
     union {
         char m_inline_buffer[inline_capacity];
-        char* m_heap_buffer;
+        HeapStorage m_heap;
     };
-    usize m_byte_count;
+};
+
+static_assert(sizeof(String) == String::inline_capacity);
+
+template<>
+struct TypeTraits<String> {
+    NODISCARD ALWAYS_INLINE static u64 hash(const String& value) { return value.view().hash(); }
+};
+
+template<>
+struct ASCIICaseInsensitiveTraits<String> {
+    NODISCARD ALWAYS_INLINE static u64 hash(const String& value) { return value.view().hash_ignoring_ascii_case(); }
+    NODISCARD ALWAYS_INLINE static bool equals(const String& lhs, const String& rhs) { return lhs.view().equals_ignoring_ascii_case(rhs.view()); }
 };
 
 } // namespace AT
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/StringBuilder.h>
+#include <AT/Utf8.h>
+
+namespace AT {
+
+StringBuilder::StringBuilder()
+    : m_buffer(m_inline_buffer)
+    , m_byte_count(0)
+    , m_capacity(inline_capacity)
+{}
+
+StringBuilder::~StringBuilder()
+{
+    if (!is_stored_inline())
+        String::release_memory(m_buffer, m_capacity + 1);
+}
+
+ErrorOr<void> StringBuilder::append_codepoint(UnicodeCodepoint codepoint)
+{
+    const usize codepoint_width = UTF8::codepoint_width(codepoint);
+    if (codepoint_width == 0)
+        return Error::InvalidEncoding;
+
+    ensure_capacity(m_byte_count + codepoint_width);
+    MAYBE_UNUSED const usize written_byte_count =
+        UTF8::bytes_from_codepoint(codepoint, { reinterpret_cast<WriteonlyBytes>(m_buffer + m_byte_count), codepoint_width });
+    AT_ASSERT(written_byte_count == codepoint_width);
+
+    m_byte_count += codepoint_width;
+    return {};
+}
+
+String StringBuilder::build()
+{
+    // NOTE: If more than half of the heap buffer is unused, adopting it would make the string hold on to much more
+    //       memory than it needs for its entire lifetime, so the characters are copied into an exact-size allocation.
+    const bool fits_inline = is_stored_inline() || m_byte_count < String::inline_capacity;
+    const bool is_mostly_unused = (m_capacity - m_byte_count) > (m_capacity / 2);
+
+    if (fits_inline || is_mostly_unused) {
+        // The heap buffer (if any) is kept for reuse.
+        String string = String(view());
+        clear();
+        return string;
+    }
+
+    m_buffer[m_byte_count] = 0;
+    String string = String::create_by_adopting_heap_buffer(m_buffer, m_byte_count, m_capacity + 1);
+
+    m_buffer = m_inline_buffer;
+    m_byte_count = 0;
+    m_capacity = inline_capacity;
+    return string;
+}
+
+void StringBuilder::grow(usize required_capacity)
+{
+    const usize old_capacity = m_capacity;
+    char* old_buffer = reallocate_buffer(required_capacity);
+    if (old_buffer)
+        String::release_memory(old_buffer, old_capacity + 1);
+}
+
+void StringBuilder::grow_and_append(const char* characters, usize byte_count)
+{
+    const usize old_capacity = m_capacity;
+    char* old_buffer = reallocate_buffer(m_byte_count + byte_count);
+
+    // NOTE: The characters are copied while the old buffer is still alive, as they might be stored in it.
+    copy_memory(m_buffer + m_byte_count, characters, byte_count);
+    m_byte_count += byte_count;
+
+    if (old_buffer)
+        String::release_memory(old_buffer, old_capacity + 1);
+}
+
+// Moves the characters into a new, larger buffer. Returns the old heap buffer (or null if it was the inline buffer),
+// which is not released, so that the caller can still read from it.
+char* StringBuilder::reallocate_buffer(usize required_capacity)
+{
+    // NOTE: The capacity grows by a factor of two, so appending a byte is amortized constant time.
+    usize new_capacity = 2 * m_capacity;
+    if (new_capacity < required_capacity)
+        new_capacity = required_capacity;
+
+    char* new_buffer = String::allocate_memory(new_capacity + 1);
+    copy_memory(new_buffer, m_buffer, m_byte_count);
+
+    char* old_buffer = is_stored_inline() ? nullptr : m_buffer;
+    m_buffer = new_buffer;
+    m_capacity = new_capacity;
+    return old_buffer;
+}
+
+} // namespace AT
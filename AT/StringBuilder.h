@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Error.h>
+#include <AT/MemoryOperations.h>
+#include <AT/NumberFormatting.h>
+#include <AT/String.h>
+#include <AT/StringView.h>
+
+namespace AT {
+
+//
+// Incrementally builds a UTF-8 encoded string.
+// The characters are first written into an inline buffer (that lives on the stack when the builder does), so building
+// short strings never allocates any memory. When the inline buffer is exhausted the characters are moved into a heap
+// buffer, which grows geometrically. Calling build() transfers the ownership of the heap buffer to the created
+// String, so the characters are never copied a second time, unless most of the buffer is unused.
+//
+class StringBuilder {
+    AT_MAKE_NONCOPYABLE(StringBuilder);
+    AT_MAKE_NONMOVABLE(StringBuilder);
+
+public:
+    static constexpr usize inline_capacity = 256;
+
+public:
+    AT_API StringBuilder();
+    AT_API ~StringBuilder();
+
+public:
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return m_byte_count; }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_byte_count == 0); }
+    NODISCARD ALWAYS_INLINE usize capacity() const { return m_capacity; }
+
+    NODISCARD ALWAYS_INLINE StringView view() const { return StringView::unsafe_create_from_utf8(m_buffer, m_byte_count); }
+    NODISCARD ALWAYS_INLINE bool is_stored_inline() const { return (m_buffer == m_inline_buffer); }
+
+public:
+    ALWAYS_INLINE void append(StringView string_view)
+    {
+        auto span = string_view.byte_span().as<const char>();
+        if (m_byte_count + span.count() > m_capacity) {
+            // NOTE: The string view might point into this builder, so it must be copied before the buffer is released.
+            grow_and_append(span.elements(), span.count());
+            return;
+        }
+        copy_memory(m_buffer + m_byte_count, span.elements(), span.count());
+        m_byte_count += span.count();
+    }
+
+    // NOTE: The character must be ASCII, as non-ASCII bytes can't form valid UTF-8 sequences by themselves.
+    ALWAYS_INLINE void append(char ascii_character)
+    {
+        AT_ASSERT_DEBUG(static_cast<u8>(ascii_character) < 0x80);
+        ensure_capacity(m_byte_count + 1);
+        m_buffer[m_byte_count++] = ascii_character;
+    }
+
+    // Encodes the codepoint as UTF-8. If the codepoint is not valid Unicode an error is returned and nothing is appended.
+    AT_API ErrorOr<void> append_codepoint(UnicodeCodepoint codepoint);
+
+    // Appends the decimal representation of the integer.
+    AT_API void append_unsigned_integer(u64 value);
+    AT_API void append_signed_integer(i64 value);
+
+    // Appends the representation of the integer in the given radix (between 2 and 36).
+    AT_API void append_unsigned_integer(u64 value, u32 radix, UppercaseDigits uppercase_digits = UppercaseDigits::No);
+    AT_API void append_signed_integer(i64 value, u32 radix, UppercaseDigits uppercase_digits = UppercaseDigits::No);
+
+    // Appends the floating-point number in the given notation. See NumberFormatting::write_float() for the details.
+    AT_API void
+    append_float(f64 value, FloatNotation notation = FloatNotation::General, u32 precision = NumberFormatting::shortest_round_trip_precision);
+    AT_API void
+    append_float(f32 value, FloatNotation notation = FloatNotation::General, u32 precision = NumberFormatting::shortest_round_trip_precision);
+
+    //
+    // Reserves space for the given number of bytes at the end of the string and returns a pointer towards it.
+    // The caller must write valid UTF-8 to all reserved bytes, which become a part of the string.
+    //
+    NODISCARD ALWAYS_INLINE char* append_uninitialized(usize byte_count)
+    {
+        ensure_capacity(m_byte_count + byte_count);
+        char* destination = m_buffer + m_byte_count;
+        m_byte_count += byte_count;
+        return destination;
+    }
+
+    // The reserved but unused bytes at the end of the string. Writing to them doesn't change the string.
+    NODISCARD ALWAYS_INLINE WriteonlyByteSpan unused_capacity_span()
+    {
+        return { reinterpret_cast<WriteonlyBytes>(m_buffer + m_byte_count), m_capacity - m_byte_count };
+    }
+
+public:
+    //
+    // Creates a string that contains the appended characters and clears the builder.
+    // If the characters are stored in a heap buffer, the buffer is adopted by the string instead of being copied.
+    // When more than half of the heap buffer is unused, the characters are copied into an exact-size string instead.
+    //
+    NODISCARD AT_API String build();
+
+    ALWAYS_INLINE void clear() { m_byte_count = 0; }
+
+    ALWAYS_INLINE void ensure_capacity(usize required_capacity)
+    {
+        if (required_capacity > m_capacity) {
+            grow(required_capacity);
+        }
+    }
+
+private:
+    AT_API void grow(usize required_capacity);
+    AT_API void grow_and_append(const char* characters, usize byte_count);
+    NODISCARD char* reallocate_buffer(usize required_capacity);
+
+private:
+    // NOTE: Points either towards the inline buffer or towards a heap buffer, allocated using the String allocator.
+    //       Heap buffers always have an extra byte reserved (not included in the capacity) for the null-termination
+    //       byte, so they can be adopted by a String without reallocating.
+    char* m_buffer;
+    usize m_byte_count;
+    usize m_capacity;
+    char m_inline_buffer[inline_capacity];
+};
+
+} // namespace AT
+
+#ifdef AT_INCLUDE_GLOBALLY
+using AT::StringBuilder;
+#endif // AT_INCLUDE_GLOBALLY
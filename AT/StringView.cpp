@@ -3,11 +3,188 @@
  * SPDX-License-Identifier: BSD-3-Clause.
  */
 
+#include <AT/Ascii.h>
+#include <AT/BitOperations.h>
+#include <AT/CPUFeatures.h>
 #include <AT/StringView.h>
 #include <AT/Utf8.h>
 
+#if AT_ARCH_X86_64
+    #include <immintrin.h>
+#endif // AT_ARCH_X86_64
+
 namespace AT {
 
+//
+// The search functions are vectorized using SSE2, which is always available on x86-64, so no runtime dispatch is
+// required. Sixteen bytes are compared using a single instruction and the result is compressed to a bit mask, the
+// offset of the first match being the index of the lowest set bit. On other architectures the scalar loops are used.
+//
+
+NODISCARD static bool bytes_are_equal(const char* lhs, const char* rhs, usize byte_count)
+{
+    usize offset = 0;
+#if AT_ARCH_X86_64
+    for (; offset + 16 <= byte_count; offset += 16) {
+        const __m128i lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + offset));
+        const __m128i rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + offset));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        if (lhs[offset] != rhs[offset]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+NODISCARD static usize find_byte(const char* characters, usize byte_count, char byte)
+{
+    usize offset = 0;
+#if AT_ARCH_X86_64
+    const __m128i needle = _mm_set1_epi8(byte);
+
+    // NOTE: Four blocks are checked per iteration, with a single branch, which is enough to be bound by the memory
+    //       bandwidth. The exact position is only computed after a match is found.
+    for (; offset + 64 <= byte_count; offset += 64) {
+        const __m128i matches_0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset + 0)), needle);
+        const __m128i matches_1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset + 16)), needle);
+        const __m128i matches_2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset + 32)), needle);
+        const __m128i matches_3 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset + 48)), needle);
+
+        const __m128i any_matches = _mm_or_si128(_mm_or_si128(matches_0, matches_1), _mm_or_si128(matches_2, matches_3));
+        if (_mm_movemask_epi8(any_matches) != 0) {
+            const u64 match_mask = static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(matches_0))) |
+                                   static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(matches_1))) << 16 |
+                                   static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(matches_2))) << 32 |
+                                   static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(matches_3))) << 48;
+            return offset + count_trailing_zeros(match_mask);
+        }
+    }
+
+    for (; offset + 16 <= byte_count; offset += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset));
+        const u32 match_mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (match_mask != 0) {
+            return offset + count_trailing_zeros(match_mask);
+        }
+    }
+
+    if (offset < byte_count && byte_count >= 16) {
+        // The last block overlaps with the already checked bytes, whose bits are discarded from the mask.
+        const usize block_offset = byte_count - 16;
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + block_offset));
+        const u32 match_mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle))) >> (offset - block_offset);
+        if (match_mask != 0) {
+            return offset + count_trailing_zeros(match_mask);
+        }
+        return StringView::invalid_position;
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        if (characters[offset] == byte) {
+            return offset;
+        }
+    }
+
+    return StringView::invalid_position;
+}
+
+NODISCARD static usize rfind_byte(const char* characters, usize byte_count, char byte)
+{
+    usize end_offset = byte_count;
+#if AT_ARCH_X86_64
+    const __m128i needle = _mm_set1_epi8(byte);
+    for (; end_offset >= 16; end_offset -= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + end_offset - 16));
+        const u32 match_mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (match_mask != 0) {
+            return end_offset - 16 + (63 - count_leading_zeros(match_mask));
+        }
+    }
+#endif // AT_ARCH_X86_64
+
+    while (end_offset > 0) {
+        --end_offset;
+        if (characters[end_offset] == byte) {
+            return end_offset;
+        }
+    }
+
+    return StringView::invalid_position;
+}
+
+NODISCARD static usize count_byte(const char* characters, usize byte_count, char byte)
+{
+    usize offset = 0;
+    usize match_count = 0;
+#if AT_ARCH_X86_64
+    const __m128i needle = _mm_set1_epi8(byte);
+    while (offset + 16 <= byte_count) {
+        // The matches are accumulated in byte counters (a match is -1), so at most 255 blocks can be processed
+        // before the counters are summed, using the sum of absolute differences against zero.
+        __m128i lane_counters = _mm_setzero_si128();
+        for (usize iteration = 0; iteration < 255 && offset + 16 <= byte_count; ++iteration, offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset));
+            lane_counters = _mm_sub_epi8(lane_counters, _mm_cmpeq_epi8(block, needle));
+        }
+
+        const __m128i lane_sums = _mm_sad_epu8(lane_counters, _mm_setzero_si128());
+        match_count += static_cast<usize>(_mm_cvtsi128_si64(lane_sums)) + static_cast<usize>(_mm_extract_epi16(lane_sums, 4));
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        match_count += (characters[offset] == byte) ? 1 : 0;
+    }
+
+    return match_count;
+}
+
+#if AT_ARCH_X86_64
+
+// Finds the first byte that is part of the set, using the nibble lookup technique (also known as "shufti"). The low
+// nibble table stores, for each low nibble, a bit for every high nibble that together form a byte in the set. The
+// high nibble table maps each high nibble to its bit. A byte belongs to the set if the two lookups share a bit.
+// NOTE: There are only eight bits available, so the set must only contain ASCII characters (high nibbles 0 - 7).
+NODISCARD AT_TARGET_SSE4_2 static usize
+find_any_of_ascii_sse(const char* characters, usize byte_count, const u8 low_nibble_bits[16], const u8 high_nibble_bits[16])
+{
+    const __m128i low_nibble_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_nibble_bits));
+    const __m128i high_nibble_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_nibble_bits));
+    const __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+
+    usize offset = 0;
+    for (; offset + 16 <= byte_count; offset += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offset));
+        const __m128i low_nibble_lookup = _mm_shuffle_epi8(low_nibble_table, _mm_and_si128(block, low_nibble_mask));
+        const __m128i high_nibble_lookup = _mm_shuffle_epi8(high_nibble_table, _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble_mask));
+        const __m128i not_in_set = _mm_cmpeq_epi8(_mm_and_si128(low_nibble_lookup, high_nibble_lookup), _mm_setzero_si128());
+
+        const u32 match_mask = static_cast<u32>(_mm_movemask_epi8(not_in_set)) ^ 0xFFFF;
+        if (match_mask != 0) {
+            return offset + count_trailing_zeros(match_mask);
+        }
+    }
+
+    for (; offset < byte_count; ++offset) {
+        const u8 byte = static_cast<u8>(characters[offset]);
+        if (low_nibble_bits[byte & 0x0F] & high_nibble_bits[byte >> 4]) {
+            return offset;
+        }
+    }
+
+    return StringView::invalid_position;
+}
+
+#endif // AT_ARCH_X86_64
+
 StringView StringView::create_from_utf8(const char* characters, usize byte_count)
 {
     MAYBE_UNUSED bool validity = UTF8::check_validity({ reinterpret_cast<ReadonlyBytes>(characters), byte_count });
@@ -24,10 +201,77 @@ StringView StringView::create_from_utf8(const char* null_terminated_characters)
     return unsafe_create_from_utf8(null_terminated_characters, byte_count);
 }
 
+usize StringView::codepoint_count() const
+{
+    return UTF8::count_codepoints(byte_span());
+}
+
 usize StringView::find(char ascii_character) const
 {
-    for (usize offset = 0; offset < m_byte_count; ++offset) {
-        if (m_characters[offset] == ascii_character) {
+    return find_byte(m_characters, m_byte_count, ascii_character);
+}
+
+usize StringView::find(UnicodeCodepoint codepoint) const
+{
+    // NOTE: UTF-8 is self-synchronizing, so the encoded codepoint can only ever match at a codepoint boundary.
+    //       Searching for its bytes is much faster than decoding every codepoint of the string.
+    u8 encoded_codepoint[4];
+    const usize codepoint_width = UTF8::bytes_from_codepoint(codepoint, { encoded_codepoint, sizeof(encoded_codepoint) });
+    if (codepoint_width == 0) {
+        return invalid_position;
+    }
+
+    if (codepoint_width == 1) {
+        return find_byte(m_characters, m_byte_count, static_cast<char>(encoded_codepoint[0]));
+    }
+
+    return find(unsafe_create_from_utf8(reinterpret_cast<const char*>(encoded_codepoint), codepoint_width));
+}
+
+usize StringView::find(StringView substring) const
+{
+    if (substring.m_byte_count == 0) {
+        return 0;
+    }
+    if (substring.m_byte_count > m_byte_count) {
+        return invalid_position;
+    }
+    if (substring.m_byte_count == 1) {
+        return find_byte(m_characters, m_byte_count, substring.m_characters[0]);
+    }
+
+    // The candidate positions are first filtered by checking both the first and the last byte of the substring, which
+    // rejects almost all of them. Only the remaining candidates have their middle bytes compared.
+    const usize substring_byte_count = substring.m_byte_count;
+    const char first_byte = substring.m_characters[0];
+    const char last_byte = substring.m_characters[substring_byte_count - 1];
+    const usize candidate_count = m_byte_count - substring_byte_count + 1;
+
+    usize offset = 0;
+#if AT_ARCH_X86_64
+    const __m128i first_byte_needle = _mm_set1_epi8(first_byte);
+    const __m128i last_byte_needle = _mm_set1_epi8(last_byte);
+
+    for (; offset + 16 <= candidate_count; offset += 16) {
+        const __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_characters + offset));
+        const __m128i last_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_characters + offset + substring_byte_count - 1));
+        const __m128i candidates = _mm_and_si128(_mm_cmpeq_epi8(first_block, first_byte_needle), _mm_cmpeq_epi8(last_block, last_byte_needle));
+
+        u32 candidate_mask = static_cast<u32>(_mm_movemask_epi8(candidates));
+        while (candidate_mask != 0) {
+            const usize candidate_offset = offset + count_trailing_zeros(candidate_mask);
+            if (bytes_are_equal(m_characters + candidate_offset + 1, substring.m_characters + 1, substring_byte_count - 2)) {
+                return candidate_offset;
+            }
+            // Clear the lowest set bit.
+            candidate_mask &= candidate_mask - 1;
+        }
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < candidate_count; ++offset) {
+        if (m_characters[offset] == first_byte && m_characters[offset + substring_byte_count - 1] == last_byte &&
+            bytes_are_equal(m_characters + offset + 1, substring.m_characters + 1, substring_byte_count - 2)) {
             return offset;
         }
     }
@@ -35,15 +279,81 @@ usize StringView::find(char ascii_character) const
     return invalid_position;
 }
 
-usize StringView::find(UnicodeCodepoint codepoint) const
+usize StringView::rfind(char ascii_character) const
+{
+    return rfind_byte(m_characters, m_byte_count, ascii_character);
+}
+
+usize StringView::rfind(StringView substring) const
 {
+    if (substring.m_byte_count == 0) {
+        return m_byte_count;
+    }
+    if (substring.m_byte_count > m_byte_count) {
+        return invalid_position;
+    }
+
+    // Search (backwards) for the first byte of the substring and only then compare the remaining bytes.
+    const usize substring_byte_count = substring.m_byte_count;
+    usize candidate_count = m_byte_count - substring_byte_count + 1;
+    while (candidate_count > 0) {
+        const usize candidate_offset = rfind_byte(m_characters, candidate_count, substring.m_characters[0]);
+        if (candidate_offset == invalid_position) {
+            break;
+        }
+
+        if (bytes_are_equal(m_characters + candidate_offset + 1, substring.m_characters + 1, substring_byte_count - 1)) {
+            return candidate_offset;
+        }
+        candidate_count = candidate_offset;
+    }
+
+    return invalid_position;
+}
+
+usize StringView::find_any_of(StringView codepoint_set) const
+{
+    u8 low_nibble_bits[16] = {};
+    u8 high_nibble_bits[16] = {};
+    bool set_is_ascii = true;
+
+    for (usize index = 0; index < codepoint_set.m_byte_count; ++index) {
+        const u8 byte = static_cast<u8>(codepoint_set.m_characters[index]);
+        if (byte >= 0x80) {
+            set_is_ascii = false;
+            break;
+        }
+        low_nibble_bits[byte & 0x0F] |= static_cast<u8>(1 << (byte >> 4));
+    }
+
+    if (set_is_ascii) {
+        for (u8 high_nibble = 0; high_nibble < 8; ++high_nibble) {
+            high_nibble_bits[high_nibble] = static_cast<u8>(1 << high_nibble);
+        }
+
+#if AT_ARCH_X86_64
+        if (cpu_features().has_sse4_2) {
+            return find_any_of_ascii_sse(m_characters, m_byte_count, low_nibble_bits, high_nibble_bits);
+        }
+#endif // AT_ARCH_X86_64
+
+        for (usize offset = 0; offset < m_byte_count; ++offset) {
+            const u8 byte = static_cast<u8>(m_characters[offset]);
+            if (low_nibble_bits[byte & 0x0F] & high_nibble_bits[byte >> 4]) {
+                return offset;
+            }
+        }
+        return invalid_position;
+    }
+
+    // The set contains multibyte codepoints, so the string must be decoded.
     usize offset = 0;
     while (offset < m_byte_count) {
         usize current_codepoint_width;
         UnicodeCodepoint current_codepoint = UTF8::bytes_to_codepoint(byte_span().slice(offset), current_codepoint_width);
         AT_ASSERT(current_codepoint != invalid_unicode_codepoint);
 
-        if (current_codepoint == codepoint) {
+        if (codepoint_set.contains(current_codepoint)) {
             return offset;
         }
         offset += current_codepoint_width;
@@ -52,6 +362,11 @@ usize StringView::find(UnicodeCodepoint codepoint) const
     return invalid_position;
 }
 
+usize StringView::count(char ascii_character) const
+{
+    return count_byte(m_characters, m_byte_count, ascii_character);
+}
+
 StringView StringView::slice(usize offset_in_bytes) const
 {
     AT_ASSERT(offset_in_bytes <= m_byte_count);
@@ -70,13 +385,7 @@ bool StringView::operator==(const StringView& other) const
         return false;
     }
 
-    for (usize byte_offset = 0; byte_offset < m_byte_count; ++byte_offset) {
-        if (m_characters[byte_offset] != other.m_characters[byte_offset]) {
-            return false;
-        }
-    }
-
-    return true;
+    return bytes_are_equal(m_characters, other.m_characters, m_byte_count);
 }
 
 bool StringView::operator!=(const StringView& other) const
@@ -85,4 +394,166 @@ bool StringView::operator!=(const StringView& other) const
     return !are_equal;
 }
 
+// Reads 8 bytes in little-endian order. Compilers fold the shifts into a single unaligned load.
+NODISCARD ALWAYS_INLINE static u64 load_u64_little_endian(ReadonlyBytes bytes, usize byte_count)
+{
+    u64 value = 0;
+    for (usize index = 0; index < byte_count; ++index) {
+        value |= static_cast<u64>(bytes[index]) << (8 * index);
+    }
+    return value;
+}
+
+NODISCARD ALWAYS_INLINE static u64 rotate_left(u64 value, u32 count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+// Converts the uppercase ASCII letters of the 8 bytes packed in the word to lowercase, without branches.
+NODISCARD ALWAYS_INLINE static u64 word_to_ascii_lowercase(u64 word)
+{
+    constexpr u64 low_seven_bits_mask = 0x7F7F7F7F7F7F7F7F;
+    constexpr u64 high_bit_mask = 0x8080808080808080;
+
+    // NOTE: The low 7 bits of each byte are offset such that the high bit of the byte is set exactly when the byte is
+    //       at least 'A' (respectively greater than 'Z'). The sums never carry into the next byte.
+    const u64 low_seven_bits = word & low_seven_bits_mask;
+    const u64 is_at_least_a = low_seven_bits + 0x3F3F3F3F3F3F3F3F;
+    const u64 is_greater_than_z = low_seven_bits + 0x2525252525252525;
+    const u64 is_uppercase = is_at_least_a & ~is_greater_than_z & ~word & high_bit_mask;
+    return word | (is_uppercase >> 2);
+}
+
+template<bool IgnoreASCIICase>
+NODISCARD ALWAYS_INLINE static u64 hash_bytes(ReadonlyBytes bytes, usize byte_count)
+{
+    // NOTE: The bytes are consumed in 8 byte words, each word being mixed using multiplications. The final avalanche
+    //       step is the finalizer of SplitMix64, which ensures that both the low and the high bits are well distributed.
+    constexpr u64 multiplier_a = 0x9E3779B97F4A7C15;
+    constexpr u64 multiplier_b = 0xBF58476D1CE4E5B9;
+    constexpr u64 multiplier_c = 0x94D049BB133111EB;
+
+    const auto load_word = [bytes](usize offset, usize word_byte_count) -> u64 {
+        const u64 word = load_u64_little_endian(bytes + offset, word_byte_count);
+        if constexpr (IgnoreASCIICase) {
+            return word_to_ascii_lowercase(word);
+        }
+        else {
+            return word;
+        }
+    };
+
+    u64 hash_value = multiplier_a ^ (byte_count * multiplier_b);
+
+    usize offset = 0;
+    for (; offset + sizeof(u64) <= byte_count; offset += sizeof(u64)) {
+        hash_value ^= load_word(offset, sizeof(u64)) * multiplier_b;
+        hash_value = rotate_left(hash_value, 29) * multiplier_c;
+    }
+
+    if (offset < byte_count) {
+        hash_value ^= load_word(offset, byte_count - offset) * multiplier_b;
+        hash_value = rotate_left(hash_value, 29) * multiplier_c;
+    }
+
+    hash_value ^= hash_value >> 30;
+    hash_value *= multiplier_b;
+    hash_value ^= hash_value >> 27;
+    hash_value *= multiplier_c;
+    hash_value ^= hash_value >> 31;
+    return hash_value;
+}
+
+u64 StringView::hash() const
+{
+    return hash_bytes<false>(reinterpret_cast<ReadonlyBytes>(m_characters), m_byte_count);
+}
+
+u64 StringView::hash_ignoring_ascii_case() const
+{
+    return hash_bytes<true>(reinterpret_cast<ReadonlyBytes>(m_characters), m_byte_count);
+}
+
+bool StringView::equals_ignoring_ascii_case(StringView other) const
+{
+    return ASCII::equals_ignoring_case(byte_span(), other.byte_span());
+}
+
+usize StringSplitRange::count() const
+{
+    if (m_string_view.is_empty()) {
+        return 0;
+    }
+
+    switch (m_delimiter_kind) {
+        case DelimiterKind::ASCIICharacter:
+            return m_string_view.count(m_ascii_delimiter) + 1;
+        case DelimiterKind::LineEnding: {
+            // NOTE: A trailing line ending doesn't produce an empty last line.
+            const bool ends_with_line_ending = m_string_view.byte_span().last() == '\n';
+            return m_string_view.count('\n') + (ends_with_line_ending ? 0 : 1);
+        }
+        case DelimiterKind::Substring:
+        case DelimiterKind::AnyOf:
+            break;
+    }
+
+    usize segment_count = 0;
+    StringView remaining = m_string_view;
+    bool has_remaining = true;
+    StringView segment;
+    while (next_segment(remaining, has_remaining, segment)) {
+        ++segment_count;
+    }
+    return segment_count;
+}
+
+bool StringSplitRange::next_segment(StringView& remaining, bool& has_remaining, StringView& out_segment) const
+{
+    if (!has_remaining) {
+        return false;
+    }
+
+    usize delimiter_offset = StringView::invalid_position;
+    usize delimiter_width = 0;
+    switch (m_delimiter_kind) {
+        case DelimiterKind::ASCIICharacter:
+        case DelimiterKind::LineEnding:
+            delimiter_offset = find_byte(remaining.m_characters, remaining.m_byte_count, m_ascii_delimiter);
+            delimiter_width = 1;
+            break;
+        case DelimiterKind::Substring:
+            delimiter_offset = remaining.find(m_delimiter);
+            delimiter_width = m_delimiter.byte_span().count();
+            break;
+        case DelimiterKind::AnyOf:
+            delimiter_offset = remaining.find_any_of(m_delimiter);
+            if (delimiter_offset != StringView::invalid_position) {
+                delimiter_width = UTF8::bytes_to_codepoint_width(remaining.byte_span().slice(delimiter_offset));
+            }
+            break;
+    }
+
+    if (delimiter_offset == StringView::invalid_position) {
+        out_segment = remaining;
+        has_remaining = false;
+    }
+    else {
+        // NOTE: The delimiter was found in the remaining string, so the bounds don't have to be checked again.
+        out_segment = StringView::unsafe_create_from_utf8(remaining.m_characters, delimiter_offset);
+        remaining = StringView::unsafe_create_from_utf8(remaining.m_characters + delimiter_offset + delimiter_width,
+                                                        remaining.m_byte_count - delimiter_offset - delimiter_width);
+        // NOTE: A trailing line ending doesn't produce an empty last line.
+        has_remaining = !(m_delimiter_kind == DelimiterKind::LineEnding && remaining.is_empty());
+
+        // NOTE: Only a '\r' that precedes the '\n' is part of the line ending. A lone '\r' is kept in the line.
+        if (m_delimiter_kind == DelimiterKind::LineEnding && out_segment.m_byte_count > 0 &&
+            out_segment.m_characters[out_segment.m_byte_count - 1] == '\r') {
+            out_segment.m_byte_count -= 1;
+        }
+    }
+
+    return true;
+}
+
 } // namespace AT
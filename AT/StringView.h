@@ -5,11 +5,18 @@
 
 #pragma once
 
+#include <AT/Error.h>
 #include <AT/Span.h>
+#include <AT/TypeTraits.h>
 #include <AT/Types.h>
+#include <AT/Utf8.h>
 
 namespace AT {
 
+class StringSplitRange;
+template<typename Predicate>
+class StringTokenizeRange;
+
 //
 // A view towards a UTF-8 encoded string.
 // The held string is not null-terminated and can't be mutated by the string view.
@@ -64,23 +71,354 @@ public:
         return ReadonlyByteSpan(reinterpret_cast<ReadonlyBytes>(m_characters), m_byte_count);
     }
 
+    // NOTE: The codepoints are counted each time this function is called, so the result should be cached if needed often.
+    NODISCARD AT_API usize codepoint_count() const;
+
 public:
     // NOTE: The value these function return represents the offset in bytes and not the number
     //       codepoints until the given character/codepoint.
     NODISCARD AT_API usize find(char ascii_character) const;
     NODISCARD AT_API usize find(UnicodeCodepoint codepoint) const;
+    NODISCARD AT_API usize find(StringView substring) const;
+
+    // Same as find(), but returns the offset of the last occurrence.
+    NODISCARD AT_API usize rfind(char ascii_character) const;
+    NODISCARD AT_API usize rfind(StringView substring) const;
+
+    // Returns the offset of the first codepoint that is any of the codepoints in the given set.
+    // NOTE: Sets that contain only ASCII characters are considerably faster, as they are searched byte-wise.
+    NODISCARD AT_API usize find_any_of(StringView codepoint_set) const;
+
+    NODISCARD ALWAYS_INLINE bool contains(char ascii_character) const { return (find(ascii_character) != invalid_position); }
+    NODISCARD ALWAYS_INLINE bool contains(UnicodeCodepoint codepoint) const { return (find(codepoint) != invalid_position); }
+    NODISCARD ALWAYS_INLINE bool contains(StringView substring) const { return (find(substring) != invalid_position); }
+
+    NODISCARD ALWAYS_INLINE bool starts_with(StringView prefix) const
+    {
+        return prefix.m_byte_count <= m_byte_count && unsafe_create_from_utf8(m_characters, prefix.m_byte_count) == prefix;
+    }
+
+    NODISCARD ALWAYS_INLINE bool ends_with(StringView suffix) const
+    {
+        return suffix.m_byte_count <= m_byte_count &&
+               unsafe_create_from_utf8(m_characters + (m_byte_count - suffix.m_byte_count), suffix.m_byte_count) == suffix;
+    }
+
+    // Returns the number of occurrences of the given character.
+    NODISCARD AT_API usize count(char ascii_character) const;
 
+public:
+    //
+    // Lazy ranges over the segments of the string that are separated by the given delimiter. The segments are views
+    // into this string (nothing is allocated), so the string must outlive the range. Consecutive delimiters produce
+    // empty segments, the same as a leading or trailing delimiter, while an empty string has no segments at all.
+    //
+    NODISCARD ALWAYS_INLINE StringSplitRange split(char ascii_delimiter) const;
+    NODISCARD ALWAYS_INLINE StringSplitRange split(StringView delimiter) const;
+    // The delimiter is any of the codepoints in the given set.
+    NODISCARD ALWAYS_INLINE StringSplitRange split_any(StringView codepoint_set) const;
+
+    // Same as split('\n'), but the line endings can also be "\r\n" and a trailing line ending doesn't produce an
+    // empty last line.
+    NODISCARD ALWAYS_INLINE StringSplitRange lines() const;
+
+    //
+    // Lazy range over the tokens of the string, which are the longest non-empty sequences of codepoints for which the
+    // predicate returns false. The predicate is invoked as 'bool(UnicodeCodepoint)' and decides which codepoints are
+    // separators, for example: 'string.tokenize([](UnicodeCodepoint codepoint) { return codepoint == ' '; })'.
+    //
+    template<typename Predicate>
+    NODISCARD ALWAYS_INLINE StringTokenizeRange<Predicate> tokenize(Predicate predicate) const;
+
+public:
+    //
+    // Parses the whole string as an integer written in the given radix (between 2 and 36, where the digits after 9
+    // are the letters of the alphabet, ignoring their case). An optional sign can precede the digits, but the minus
+    // sign is only accepted by signed types. Returns 'InvalidStringFormat' if the string is not an integer and
+    // 'NumberOutOfRange' if the integer can't be represented by the given type.
+    //
+    template<typename T>
+    requires (is_integral<T>)
+    NODISCARD ALWAYS_INLINE ErrorOr<T> to_integer(u32 radix = 10) const
+    {
+        if constexpr (is_signed_integral<T>) {
+            const i64 max_value = static_cast<i64>((1ull << (sizeof(T) * 8 - 1)) - 1);
+            TRY_ASSIGN(const i64 value, to_signed_integer(radix, max_value));
+            return static_cast<T>(value);
+        }
+        else {
+            const u64 max_value = static_cast<u64>(static_cast<T>(-1));
+            TRY_ASSIGN(const u64 value, to_unsigned_integer(radix, max_value));
+            return static_cast<T>(value);
+        }
+    }
+
+    //
+    // Parses the whole string as a decimal floating-point number (an optional sign, the digits with an optional
+    // decimal point and an optional exponent), or as one of the "inf", "infinity" and "nan" special values.
+    // The result is always the closest floating-point number (ties to even). Numbers too small to be represented
+    // become zero, while numbers too big to be represented return 'NumberOutOfRange'.
+    //
+    NODISCARD AT_API ErrorOr<f64> to_f64() const;
+    NODISCARD AT_API ErrorOr<f32> to_f32() const;
+
+public:
     NODISCARD AT_API StringView slice(usize offset_in_bytes) const;
     NODISCARD AT_API StringView slice(usize offset_in_bytes, usize bytes_count) const;
 
     NODISCARD AT_API bool operator==(const StringView& other) const;
     NODISCARD AT_API bool operator!=(const StringView& other) const;
 
+    // Computes a 64-bit hash of the bytes of the string. All the bits of the result are well distributed, so the
+    // value can be directly used by hash tables.
+    NODISCARD AT_API u64 hash() const;
+
+    // Checks if the two strings are equal, considering that an uppercase ASCII letter is equal to its lowercase.
+    NODISCARD AT_API bool equals_ignoring_ascii_case(StringView other) const;
+
+    //
+    // Computes the same hash as the one of the string with all ASCII letters converted to lowercase, without creating
+    // the lowercase copy. Strings that are equal ignoring the ASCII case always have the same hash.
+    //
+    NODISCARD AT_API u64 hash_ignoring_ascii_case() const;
+
+private:
+    NODISCARD AT_API ErrorOr<u64> to_unsigned_integer(u32 radix, u64 max_value) const;
+    NODISCARD AT_API ErrorOr<i64> to_signed_integer(u32 radix, i64 max_value) const;
+
 private:
+    friend class StringSplitRange;
+
     const char* m_characters;
     usize m_byte_count;
 };
 
+//
+// Lazy range over the segments of a string that are separated by a delimiter. Created by StringView::split(),
+// StringView::split_any() and StringView::lines(), which describe how the string is split.
+// The range must outlive its iterators.
+//
+class StringSplitRange {
+public:
+    enum class DelimiterKind : u8 {
+        ASCIICharacter,
+        Substring,
+        AnyOf,
+        LineEnding,
+    };
+
+    class Iterator {
+    public:
+        ALWAYS_INLINE Iterator(const StringSplitRange* range, bool is_end)
+            : m_range(range)
+            , m_remaining(range->m_string_view)
+            , m_has_remaining(!is_end && !range->m_string_view.is_empty())
+            , m_is_end(is_end)
+        {
+            if (!m_is_end) {
+                m_is_end = !m_range->next_segment(m_remaining, m_has_remaining, m_segment);
+            }
+        }
+
+        NODISCARD ALWAYS_INLINE StringView operator*() const { return m_segment; }
+        NODISCARD ALWAYS_INLINE const StringView* operator->() const { return &m_segment; }
+
+        ALWAYS_INLINE Iterator& operator++()
+        {
+            m_is_end = !m_range->next_segment(m_remaining, m_has_remaining, m_segment);
+            return *this;
+        }
+
+        // NOTE: Iterators are only compared against the end of the range, as there is a single forward traversal.
+        NODISCARD ALWAYS_INLINE bool operator==(const Iterator& other) const
+        {
+            return m_is_end == other.m_is_end && (m_is_end || m_segment.byte_span().elements() == other.m_segment.byte_span().elements());
+        }
+
+        NODISCARD ALWAYS_INLINE bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        const StringSplitRange* m_range;
+        StringView m_remaining;
+        StringView m_segment;
+        bool m_has_remaining;
+        bool m_is_end;
+    };
+
+public:
+    ALWAYS_INLINE StringSplitRange(StringView string_view, DelimiterKind delimiter_kind, StringView delimiter, char ascii_delimiter)
+        : m_string_view(string_view)
+        , m_delimiter(delimiter)
+        , m_delimiter_kind(delimiter_kind)
+        , m_ascii_delimiter(ascii_delimiter)
+    {}
+
+    NODISCARD ALWAYS_INLINE Iterator begin() const { return Iterator(this, false); }
+    NODISCARD ALWAYS_INLINE Iterator end() const { return Iterator(this, true); }
+
+    //
+    // Returns the number of segments, without producing them. When splitting by a character (or into lines) the
+    // occurrences of the delimiter are counted using a single vectorized pass over the string.
+    // Useful to reserve the memory of a container before collecting the segments.
+    //
+    NODISCARD AT_API usize count() const;
+
+    //
+    // Extracts the next segment from the remaining part of the string. The remaining string is only valid if
+    // 'has_remaining' is true, which differentiates an empty remaining segment from the end of the range.
+    // Returns false if there are no more segments.
+    //
+    NODISCARD AT_API bool next_segment(StringView& remaining, bool& has_remaining, StringView& out_segment) const;
+
+private:
+    StringView m_string_view;
+    StringView m_delimiter;
+    DelimiterKind m_delimiter_kind;
+    char m_ascii_delimiter;
+};
+
+ALWAYS_INLINE StringSplitRange StringView::split(char ascii_delimiter) const
+{
+    return StringSplitRange(*this, StringSplitRange::DelimiterKind::ASCIICharacter, {}, ascii_delimiter);
+}
+
+ALWAYS_INLINE StringSplitRange StringView::split(StringView delimiter) const
+{
+    AT_ASSERT(!delimiter.is_empty());
+    return StringSplitRange(*this, StringSplitRange::DelimiterKind::Substring, delimiter, 0);
+}
+
+ALWAYS_INLINE StringSplitRange StringView::split_any(StringView codepoint_set) const
+{
+    AT_ASSERT(!codepoint_set.is_empty());
+    return StringSplitRange(*this, StringSplitRange::DelimiterKind::AnyOf, codepoint_set, 0);
+}
+
+ALWAYS_INLINE StringSplitRange StringView::lines() const
+{
+    return StringSplitRange(*this, StringSplitRange::DelimiterKind::LineEnding, {}, '\n');
+}
+
+//
+// Lazy range over the tokens of a string. Created by StringView::tokenize().
+// The range must outlive its iterators.
+//
+template<typename Predicate>
+class StringTokenizeRange {
+public:
+    class Iterator {
+    public:
+        ALWAYS_INLINE Iterator(const StringTokenizeRange* range, usize offset)
+            : m_range(range)
+            , m_offset(offset)
+        {
+            advance();
+        }
+
+        NODISCARD ALWAYS_INLINE StringView operator*() const { return m_token; }
+        NODISCARD ALWAYS_INLINE const StringView* operator->() const { return &m_token; }
+
+        ALWAYS_INLINE Iterator& operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        NODISCARD ALWAYS_INLINE bool operator==(const Iterator& other) const { return m_token_offset == other.m_token_offset; }
+        NODISCARD ALWAYS_INLINE bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        ALWAYS_INLINE void advance()
+        {
+            const StringView string_view = m_range->m_string_view;
+            const usize byte_count = string_view.byte_span().count();
+
+            m_offset = m_range->skip_codepoints(m_offset, true);
+            if (m_offset == byte_count) {
+                // NOTE: The end iterator is the only one whose token starts at the end of the string.
+                m_token_offset = byte_count;
+                m_token = {};
+                return;
+            }
+
+            m_token_offset = m_offset;
+            m_offset = m_range->skip_codepoints(m_offset, false);
+            m_token = string_view.slice(m_token_offset, m_offset - m_token_offset);
+        }
+
+    private:
+        const StringTokenizeRange* m_range;
+        usize m_offset;
+        usize m_token_offset;
+        StringView m_token;
+    };
+
+public:
+    ALWAYS_INLINE StringTokenizeRange(StringView string_view, Predicate predicate)
+        : m_string_view(string_view)
+        , m_predicate(move(predicate))
+    {}
+
+    NODISCARD ALWAYS_INLINE Iterator begin() const { return Iterator(this, 0); }
+    NODISCARD ALWAYS_INLINE Iterator end() const { return Iterator(this, m_string_view.byte_span().count()); }
+
+    // Returns the number of tokens, without producing them.
+    NODISCARD usize count() const
+    {
+        const usize byte_count = m_string_view.byte_span().count();
+        usize token_count = 0;
+        usize offset = skip_codepoints(0, true);
+        while (offset < byte_count) {
+            ++token_count;
+            offset = skip_codepoints(skip_codepoints(offset, false), true);
+        }
+        return token_count;
+    }
+
+private:
+    // Returns the offset of the first codepoint, starting at the given offset, for which the predicate doesn't
+    // return the given value (or the byte count of the string, if there is no such codepoint).
+    NODISCARD usize skip_codepoints(usize offset, bool is_separator) const
+    {
+        const ReadonlyByteSpan byte_span = m_string_view.byte_span();
+        while (offset < byte_span.count()) {
+            UnicodeCodepoint codepoint = byte_span[offset];
+            usize codepoint_width = 1;
+            if (codepoint >= 0x80) {
+                codepoint = UTF8::bytes_to_codepoint(byte_span.slice(offset), codepoint_width);
+                AT_ASSERT(codepoint != invalid_unicode_codepoint);
+            }
+
+            if (static_cast<bool>(m_predicate(codepoint)) != is_separator) {
+                break;
+            }
+            offset += codepoint_width;
+        }
+        return offset;
+    }
+
+private:
+    StringView m_string_view;
+    Predicate m_predicate;
+};
+
+template<typename Predicate>
+ALWAYS_INLINE StringTokenizeRange<Predicate> StringView::tokenize(Predicate predicate) const
+{
+    return StringTokenizeRange<Predicate>(*this, move(predicate));
+}
+
+template<>
+struct TypeTraits<StringView> {
+    NODISCARD ALWAYS_INLINE static u64 hash(const StringView& value) { return value.hash(); }
+};
+
+template<>
+struct ASCIICaseInsensitiveTraits<StringView> {
+    NODISCARD ALWAYS_INLINE static u64 hash(const StringView& value) { return value.hash_ignoring_ascii_case(); }
+    NODISCARD ALWAYS_INLINE static bool equals(const StringView& lhs, const StringView& rhs) { return lhs.equals_ignoring_ascii_case(rhs); }
+};
+
 #if AT_COMPILER_MSVC
     #pragma warning(push)
     // Disables the following compiler warning:
@@ -109,6 +447,8 @@ NODISCARD ALWAYS_INLINE constexpr StringView operator""sv(const char* ascii_lite
 } // namespace AT
 
 #ifdef AT_INCLUDE_GLOBALLY
+using AT::StringSplitRange;
+using AT::StringTokenizeRange;
 using AT::StringView;
 using AT::operator""sv;
 #endif // AT_INCLUDE_GLOBALLY
@@ -25,8 +25,33 @@ struct TypeTraits<T> {
     NODISCARD ALWAYS_INLINE static u64 hash(const T&) { return 0; }
 };
 
+//
+// Traits that hash and compare strings ignoring the case of the ASCII letters. Specialized for the string types, they
+// can be passed to the hash containers so that lookups don't require a lowercase copy of the key:
+//     HashMap<String, u32, ASCIICaseInsensitiveTraits<String>> map;
+//
+template<typename T>
+struct ASCIICaseInsensitiveTraits;
+
+namespace Detail {
+
+// Uses the equality function of the traits if they provide one, or the equality operator otherwise.
+template<typename Traits, typename T>
+NODISCARD ALWAYS_INLINE bool traits_equals(const T& lhs, const T& rhs)
+{
+    if constexpr (requires { Traits::equals(lhs, rhs); }) {
+        return Traits::equals(lhs, rhs);
+    }
+    else {
+        return (lhs == rhs);
+    }
+}
+
+} // namespace Detail
+
 } // namespace AT
 
 #ifdef AT_INCLUDE_GLOBALLY
+using AT::ASCIICaseInsensitiveTraits;
 using AT::TypeTraits;
 #endif // AT_INCLUDE_GLOBALLY
@@ -32,6 +32,12 @@ using i16 = signed short;
 using i32 = signed int;
 using i64 = signed long long;
 
+//
+// Floating-point primitive types, in the IEEE-754 single and double precision formats.
+//
+using f32 = float;
+using f64 = double;
+
 // Checks that ensure the sizes of the primitive integer types are as expected.
 // If a mismatch is found, we do not allow the compilation to succeed, as
 // unexpected issues related to alignment or integer overflow may occur.
@@ -43,6 +49,8 @@ static_assert(sizeof(i8) == 1);
 static_assert(sizeof(i16) == 2);
 static_assert(sizeof(i32) == 4);
 static_assert(sizeof(i64) == 8);
+static_assert(sizeof(f32) == 4);
+static_assert(sizeof(f64) == 8);
 
 //
 // Integers types that can exactly represent a memory address on the current architecture.
@@ -54,6 +62,12 @@ using uintptr = unsigned long long;
 
 constexpr usize invalid_size = static_cast<usize>(-1);
 
+//
+// The size (in bytes) of a cache line on all architectures that are currently supported.
+// Used to lay out data structures such that hot data doesn't straddle or share cache lines.
+//
+constexpr usize cache_line_size = 64;
+
 //
 // Integer types that represent a byte and have the allowed access modifiers attached to their name.
 //
@@ -171,6 +185,15 @@ struct IsSignedIntegral<i64> {
     static constexpr bool value = true;
 };
 
+template<typename T, typename U>
+struct IsSame {
+    static constexpr bool value = false;
+};
+template<typename T>
+struct IsSame<T, T> {
+    static constexpr bool value = true;
+};
+
 template<typename TypeIfTrue, typename TypeIfFalse, bool condition>
 struct ConditionalType {};
 
@@ -190,6 +213,8 @@ template<typename T>
 using RemoveReference = typename Detail::RemoveReference<T>::Type;
 template<typename T>
 using RemoveConst = typename Detail::RemoveConst<T>::Type;
+template<typename T>
+using RemoveConstReference = RemoveConst<RemoveReference<T>>;
 
 template<typename T>
 constexpr bool is_reference = Detail::IsReference<T>::value;
@@ -201,6 +226,8 @@ template<typename T>
 constexpr bool is_signed_integral = Detail::IsSignedIntegral<T>::value;
 template<typename T>
 constexpr bool is_integral = is_unsigned_integral<T> || is_signed_integral<T>;
+template<typename T, typename U>
+constexpr bool is_same = Detail::IsSame<T, U>::value;
 
 //
 // The STL equivalent of the move function. Same signature and behaviour.
@@ -233,6 +260,18 @@ NODISCARD ALWAYS_INLINE constexpr T&& forward(RemoveReference<T>&& instance) noe
     return static_cast<T&&>(instance);
 }
 
+//
+// The STL equivalent of the swap function. Same signature and behaviour.
+// https://en.cppreference.com/w/cpp/algorithm/swap
+//
+template<typename T>
+ALWAYS_INLINE constexpr void swap(T& a, T& b)
+{
+    T temporary = move(a);
+    a = move(b);
+    b = move(temporary);
+}
+
 template<typename TypeIfTrue, typename TypeIfFalse, bool condition>
 using ConditionalType = typename Detail::ConditionalType<TypeIfTrue, TypeIfFalse, condition>::Type;
 
@@ -242,6 +281,9 @@ constexpr bool is_derived_from = std::is_base_of_v<BaseType, DerivedType>;
 } // namespace AT
 
 #ifdef AT_INCLUDE_GLOBALLY
+using AT::cache_line_size;
+using AT::f32;
+using AT::f64;
 using AT::forward;
 using AT::i16;
 using AT::i32;
@@ -250,6 +292,7 @@ using AT::i8;
 using AT::invalid_size;
 using AT::invalid_unicode_codepoint;
 using AT::is_integral;
+using AT::is_same;
 using AT::is_signed_integral;
 using AT::is_unsigned_integral;
 using AT::move;
@@ -258,8 +301,10 @@ using AT::ReadonlyBytes;
 using AT::ReadWriteByte;
 using AT::ReadWriteBytes;
 using AT::RemoveConst;
+using AT::RemoveConstReference;
 using AT::RemoveReference;
 using AT::ssize;
+using AT::swap;
 using AT::u16;
 using AT::u32;
 using AT::u64;
@@ -3,10 +3,362 @@
  * SPDX-License-Identifier: BSD-3-Clause.
  */
 
+#include <AT/CPUFeatures.h>
+#include <AT/MemoryOperations.h>
 #include <AT/Utf8.h>
 
+#if AT_ARCH_X86_64
+    #include <immintrin.h>
+#endif // AT_ARCH_X86_64
+
 namespace AT {
 
+//
+// Strict UTF-8 validation, as defined by the "Well-Formed UTF-8 Byte Sequences" table of the Unicode standard.
+// Besides sequences that are truncated or have invalid continuation bytes, overlong encodings, surrogates
+// (U+D800 - U+DFFF) and codepoints above U+10FFFF are rejected as well.
+//
+// The vectorized implementations use the lookup algorithm described by John Keiser and Daniel Lemire in
+// "Validating UTF-8 In Less Than One Instruction Per Byte". Every byte is classified by the high nibble of the previous
+// byte, the low nibble of the previous byte and its own high nibble using three 16-entry tables. Each table entry
+// is a set of error bits, and a pair of bytes is invalid if all three lookups have a common error bit. The only errors
+// that can't be detected by looking at a pair of bytes are related to the third and fourth bytes of a sequence, which
+// are checked separately. Blocks of 64 bytes that only contain ASCII characters skip the checks entirely.
+//
+
+using CheckValidityFunction = bool (*)(ReadonlyBytes bytes, usize byte_count);
+
+static bool check_validity_scalar(ReadonlyBytes bytes, usize byte_count)
+{
+    usize offset = 0;
+    while (offset < byte_count) {
+        const u8 leading_byte = bytes[offset];
+        if (leading_byte < 0x80) {
+            // Skip ASCII characters eight at a time. The compiler is able to combine the loads in a single one.
+            if (offset + 8 <= byte_count) {
+                u8 combined_bytes = 0;
+                for (usize index = 0; index < 8; ++index) {
+                    combined_bytes |= bytes[offset + index];
+                }
+                if ((combined_bytes & 0x80) == 0) {
+                    offset += 8;
+                    continue;
+                }
+            }
+
+            ++offset;
+            continue;
+        }
+
+        // The valid range of the second byte is restricted for some leading bytes, in order to reject overlong
+        // encodings, surrogates and codepoints above U+10FFFF.
+        usize codepoint_width = 0;
+        u8 second_byte_minimum = 0x80;
+        u8 second_byte_maximum = 0xBF;
+
+        if (0xC2 <= leading_byte && leading_byte <= 0xDF) {
+            codepoint_width = 2;
+        }
+        else if (0xE0 <= leading_byte && leading_byte <= 0xEF) {
+            codepoint_width = 3;
+            if (leading_byte == 0xE0) {
+                second_byte_minimum = 0xA0;
+            }
+            else if (leading_byte == 0xED) {
+                second_byte_maximum = 0x9F;
+            }
+        }
+        else if (0xF0 <= leading_byte && leading_byte <= 0xF4) {
+            codepoint_width = 4;
+            if (leading_byte == 0xF0) {
+                second_byte_minimum = 0x90;
+            }
+            else if (leading_byte == 0xF4) {
+                second_byte_maximum = 0x8F;
+            }
+        }
+        else {
+            // Either a continuation byte, an overlong two byte sequence (0xC0 and 0xC1) or a byte that can never
+            // appear in UTF-8 (0xF5 - 0xFF).
+            return false;
+        }
+
+        if (byte_count - offset < codepoint_width) {
+            return false;
+        }
+
+        const u8 second_byte = bytes[offset + 1];
+        if (second_byte < second_byte_minimum || second_byte > second_byte_maximum) {
+            return false;
+        }
+
+        for (usize index = 2; index < codepoint_width; ++index) {
+            if ((bytes[offset + index] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+
+        offset += codepoint_width;
+    }
+
+    return true;
+}
+
+#if AT_ARCH_X86_64
+
+namespace UTF8ValidationTables {
+
+// The error bits that are set in the lookup tables.
+constexpr u8 too_short = 1 << 0;      // 11______ 0_______ or 11______ 11______
+constexpr u8 too_long = 1 << 1;       // 0_______ 10______
+constexpr u8 overlong_3 = 1 << 2;     // 11100000 100_____
+constexpr u8 too_large = 1 << 3;      // 11110100 1001____ or 11110100 101_____ or 11110101 - 11111111
+constexpr u8 surrogate = 1 << 4;      // 11101101 101_____
+constexpr u8 overlong_2 = 1 << 5;     // 1100000_ 10______
+constexpr u8 too_large_1000 = 1 << 6; // 11110101 - 11111111 followed by 1000____
+constexpr u8 overlong_4 = 1 << 6;     // 11110000 1000____
+constexpr u8 two_continuations = 1 << 7; // 10______ 10______
+constexpr u8 carry = too_short | too_long | two_continuations;
+
+// Indexed by the high nibble of the previous byte.
+alignas(16) constexpr u8 previous_byte_high_nibble[16] = {
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    two_continuations,
+    two_continuations,
+    two_continuations,
+    two_continuations,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4,
+};
+
+// Indexed by the low nibble of the previous byte.
+alignas(16) constexpr u8 previous_byte_low_nibble[16] = {
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+};
+
+// Indexed by the high nibble of the current byte.
+alignas(16) constexpr u8 current_byte_high_nibble[16] = {
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_long | overlong_2 | two_continuations | overlong_3 | too_large_1000 | overlong_4,
+    too_long | overlong_2 | two_continuations | overlong_3 | too_large,
+    too_long | overlong_2 | two_continuations | surrogate | too_large,
+    too_long | overlong_2 | two_continuations | surrogate | too_large,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+};
+
+// A block is incomplete if any of its last three bytes starts a sequence that doesn't fit in the block.
+// Saturating subtracting these values from the last bytes of a block yields non-zero only for such bytes.
+alignas(32) constexpr u8 incomplete_sequence_thresholds[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+} // namespace UTF8ValidationTables
+
+struct UTF8ValidationStateSSE {
+    __m128i error;
+    __m128i previous_block;
+    __m128i previous_block_is_incomplete;
+};
+
+AT_TARGET_SSE4_2 static ALWAYS_INLINE __m128i check_utf8_block_sse(__m128i block, __m128i previous_block)
+{
+    using namespace UTF8ValidationTables;
+    const __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+
+    // The bytes of the block, shifted by one, two and three positions (the previous block bytes are shifted in).
+    const __m128i previous_1 = _mm_alignr_epi8(block, previous_block, 16 - 1);
+    const __m128i previous_2 = _mm_alignr_epi8(block, previous_block, 16 - 2);
+    const __m128i previous_3 = _mm_alignr_epi8(block, previous_block, 16 - 3);
+
+    const __m128i previous_high_nibble = _mm_and_si128(_mm_srli_epi16(previous_1, 4), low_nibble_mask);
+    const __m128i previous_low_nibble = _mm_and_si128(previous_1, low_nibble_mask);
+    const __m128i current_high_nibble = _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble_mask);
+
+    const __m128i special_cases = _mm_and_si128(
+        _mm_and_si128(_mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(previous_byte_high_nibble)), previous_high_nibble),
+                      _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(previous_byte_low_nibble)), previous_low_nibble)),
+        _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(current_byte_high_nibble)), current_high_nibble));
+
+    // The third and fourth bytes of three and four byte sequences must be continuation bytes. These are exactly the
+    // bytes that were flagged as two consecutive continuations, so the bits cancel out for valid input.
+    const __m128i is_third_byte = _mm_subs_epu8(previous_2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m128i is_fourth_byte = _mm_subs_epu8(previous_3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm_xor_si128(must_be_continuation, special_cases);
+}
+
+AT_TARGET_SSE4_2 static ALWAYS_INLINE void check_utf8_chunk_sse(ReadonlyBytes chunk, UTF8ValidationStateSSE& state)
+{
+    const __m128i block_0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 0));
+    const __m128i block_1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 16));
+    const __m128i block_2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 32));
+    const __m128i block_3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 48));
+
+    const __m128i combined_blocks = _mm_or_si128(_mm_or_si128(block_0, block_1), _mm_or_si128(block_2, block_3));
+    if (_mm_movemask_epi8(combined_blocks) == 0) {
+        // The chunk only contains ASCII characters, so it is valid if the previous chunk didn't end in the middle of
+        // a multibyte sequence.
+        state.error = _mm_or_si128(state.error, state.previous_block_is_incomplete);
+    }
+    else {
+        state.error = _mm_or_si128(state.error, check_utf8_block_sse(block_0, state.previous_block));
+        state.error = _mm_or_si128(state.error, check_utf8_block_sse(block_1, block_0));
+        state.error = _mm_or_si128(state.error, check_utf8_block_sse(block_2, block_1));
+        state.error = _mm_or_si128(state.error, check_utf8_block_sse(block_3, block_2));
+        state.previous_block_is_incomplete = _mm_subs_epu8(
+            block_3, _mm_load_si128(reinterpret_cast<const __m128i*>(UTF8ValidationTables::incomplete_sequence_thresholds + 16)));
+    }
+
+    state.previous_block = block_3;
+}
+
+AT_TARGET_SSE4_2 static bool check_validity_sse(ReadonlyBytes bytes, usize byte_count)
+{
+    UTF8ValidationStateSSE state;
+    state.error = _mm_setzero_si128();
+    state.previous_block = _mm_setzero_si128();
+    state.previous_block_is_incomplete = _mm_setzero_si128();
+
+    usize offset = 0;
+    for (; offset + 64 <= byte_count; offset += 64) {
+        check_utf8_chunk_sse(bytes + offset, state);
+    }
+
+    // NOTE: The remaining bytes are padded with zeros (which are ASCII), so an incomplete sequence at the end of the
+    //       string is always reported as an error. The padded chunk is processed even when there are no bytes left.
+    u8 last_chunk[64] = {};
+    copy_memory(last_chunk, bytes + offset, byte_count - offset);
+    check_utf8_chunk_sse(last_chunk, state);
+
+    return _mm_testz_si128(state.error, state.error);
+}
+
+struct UTF8ValidationStateAVX2 {
+    __m256i error;
+    __m256i previous_block;
+    __m256i previous_block_is_incomplete;
+};
+
+AT_TARGET_AVX2 static ALWAYS_INLINE __m256i check_utf8_block_avx2(__m256i block, __m256i previous_block)
+{
+    using namespace UTF8ValidationTables;
+    const __m256i low_nibble_mask = _mm256_set1_epi8(0x0F);
+
+    // NOTE: The AVX2 byte alignment instruction operates on each 128-bit lane independently, so the upper lane of the
+    //       previous block and the lower lane of the current block are combined first.
+    const __m256i shifted_in = _mm256_permute2x128_si256(previous_block, block, 0x21);
+    const __m256i previous_1 = _mm256_alignr_epi8(block, shifted_in, 16 - 1);
+    const __m256i previous_2 = _mm256_alignr_epi8(block, shifted_in, 16 - 2);
+    const __m256i previous_3 = _mm256_alignr_epi8(block, shifted_in, 16 - 3);
+
+    const __m256i previous_high_nibble = _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), low_nibble_mask);
+    const __m256i previous_low_nibble = _mm256_and_si256(previous_1, low_nibble_mask);
+    const __m256i current_high_nibble = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble_mask);
+
+    const __m256i previous_high_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(previous_byte_high_nibble)));
+    const __m256i previous_low_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(previous_byte_low_nibble)));
+    const __m256i current_high_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(current_byte_high_nibble)));
+
+    const __m256i special_cases = _mm256_and_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(previous_high_table, previous_high_nibble), _mm256_shuffle_epi8(previous_low_table, previous_low_nibble)),
+        _mm256_shuffle_epi8(current_high_table, current_high_nibble));
+
+    const __m256i is_third_byte = _mm256_subs_epu8(previous_2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m256i is_fourth_byte = _mm256_subs_epu8(previous_3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m256i must_be_continuation =
+        _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+AT_TARGET_AVX2 static ALWAYS_INLINE void check_utf8_chunk_avx2(ReadonlyBytes chunk, UTF8ValidationStateAVX2& state)
+{
+    const __m256i block_0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + 0));
+    const __m256i block_1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk + 32));
+
+    if (_mm256_movemask_epi8(_mm256_or_si256(block_0, block_1)) == 0) {
+        state.error = _mm256_or_si256(state.error, state.previous_block_is_incomplete);
+    }
+    else {
+        state.error = _mm256_or_si256(state.error, check_utf8_block_avx2(block_0, state.previous_block));
+        state.error = _mm256_or_si256(state.error, check_utf8_block_avx2(block_1, block_0));
+        state.previous_block_is_incomplete =
+            _mm256_subs_epu8(block_1, _mm256_load_si256(reinterpret_cast<const __m256i*>(UTF8ValidationTables::incomplete_sequence_thresholds)));
+    }
+
+    state.previous_block = block_1;
+}
+
+AT_TARGET_AVX2 static bool check_validity_avx2(ReadonlyBytes bytes, usize byte_count)
+{
+    UTF8ValidationStateAVX2 state;
+    state.error = _mm256_setzero_si256();
+    state.previous_block = _mm256_setzero_si256();
+    state.previous_block_is_incomplete = _mm256_setzero_si256();
+
+    usize offset = 0;
+    for (; offset + 64 <= byte_count; offset += 64) {
+        check_utf8_chunk_avx2(bytes + offset, state);
+    }
+
+    u8 last_chunk[64] = {};
+    copy_memory(last_chunk, bytes + offset, byte_count - offset);
+    check_utf8_chunk_avx2(last_chunk, state);
+
+    return _mm256_testz_si256(state.error, state.error);
+}
+
+#endif // AT_ARCH_X86_64
+
+static CheckValidityFunction select_check_validity_function()
+{
+#if AT_ARCH_X86_64
+    if (cpu_features().has_avx2) {
+        return check_validity_avx2;
+    }
+    if (cpu_features().has_sse4_2) {
+        return check_validity_sse;
+    }
+#endif // AT_ARCH_X86_64
+    return check_validity_scalar;
+}
+
 UnicodeCodepoint UTF8::bytes_to_codepoint(ReadonlyByteSpan byte_span, usize& out_codepoint_width)
 {
     if (byte_span.count() == 0) {
@@ -40,7 +392,7 @@ UnicodeCodepoint UTF8::bytes_to_codepoint(ReadonlyByteSpan byte_span, usize& out
         }
 
         UnicodeCodepoint codepoint = 0;
-        codepoint += (byte_span.elements()[0] & 0x1F) << 12;
+        codepoint += (byte_span.elements()[0] & 0x0F) << 12;
         codepoint += (byte_span.elements()[1] & 0x3F) << 6;
         codepoint += (byte_span.elements()[2] & 0x3F) << 0;
 
@@ -55,7 +407,7 @@ UnicodeCodepoint UTF8::bytes_to_codepoint(ReadonlyByteSpan byte_span, usize& out
         }
 
         UnicodeCodepoint codepoint = 0;
-        codepoint += (byte_span.elements()[0] & 0x1F) << 18;
+        codepoint += (byte_span.elements()[0] & 0x07) << 18;
         codepoint += (byte_span.elements()[1] & 0x3F) << 12;
         codepoint += (byte_span.elements()[2] & 0x3F) << 6;
         codepoint += (byte_span.elements()[3] & 0x3F) << 0;
@@ -104,6 +456,10 @@ usize UTF8::bytes_to_codepoint_width(ReadonlyByteSpan byte_span)
 
 usize UTF8::bytes_from_codepoint(UnicodeCodepoint codepoint, WriteonlyByteSpan destination_byte_span)
 {
+    if (!is_valid_codepoint(codepoint)) {
+        return 0;
+    }
+
     if (codepoint <= 0x007F) {
         if (destination_byte_span.count() < 1) {
             return 0;
@@ -147,6 +503,10 @@ usize UTF8::bytes_from_codepoint(UnicodeCodepoint codepoint, WriteonlyByteSpan d
 
 usize UTF8::codepoint_width(UnicodeCodepoint codepoint)
 {
+    if (!is_valid_codepoint(codepoint)) {
+        return 0;
+    }
+
     if (codepoint <= 0x007F) {
         return 1;
     }
@@ -165,20 +525,675 @@ usize UTF8::codepoint_width(UnicodeCodepoint codepoint)
 
 usize UTF8::length(ReadonlyByteSpan byte_span)
 {
-    usize len = 0;
-    usize byte_offset = 0;
+    if (!check_validity(byte_span)) {
+        return invalid_size;
+    }
+
+    return count_codepoints(byte_span);
+}
+
+// NOTE: Continuation bytes (0x80 - 0xBF) are exactly the bytes that are smaller than -64 when interpreted as signed.
+#if AT_ARCH_X86_64
+NODISCARD ALWAYS_INLINE static __m128i find_continuation_bytes(__m128i block)
+{
+    return _mm_cmplt_epi8(block, _mm_set1_epi8(-64));
+}
+
+// Sums the sixteen bytes of the vector.
+NODISCARD ALWAYS_INLINE static usize horizontal_byte_sum(__m128i block)
+{
+    const __m128i partial_sums = _mm_sad_epu8(block, _mm_setzero_si128());
+    return static_cast<usize>(_mm_cvtsi128_si64(partial_sums)) + static_cast<usize>(_mm_extract_epi16(partial_sums, 4));
+}
+#endif // AT_ARCH_X86_64
+
+NODISCARD ALWAYS_INLINE static bool is_continuation_byte(u8 byte)
+{
+    return (byte & 0xC0) == 0x80;
+}
+
+usize UTF8::count_codepoints(ReadonlyByteSpan byte_span)
+{
+    // Every codepoint has exactly one byte that is not a continuation byte, so it is enough to count them.
+    const ReadonlyBytes bytes = byte_span.elements();
+    const usize byte_count = byte_span.count();
+    usize continuation_byte_count = 0;
+    usize offset = 0;
+
+#if AT_ARCH_X86_64
+    // The continuation bytes are counted in eight bit lanes (the comparison result is -1 for each one), which are
+    // summed before they can overflow, every 255 iterations.
+    while (offset + 16 <= byte_count) {
+        __m128i lane_counters = _mm_setzero_si128();
+        for (usize iteration = 0; iteration < 255 && offset + 16 <= byte_count; ++iteration, offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+            lane_counters = _mm_sub_epi8(lane_counters, find_continuation_bytes(block));
+        }
+        continuation_byte_count += horizontal_byte_sum(lane_counters);
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        continuation_byte_count += is_continuation_byte(bytes[offset]) ? 1 : 0;
+    }
+
+    return byte_count - continuation_byte_count;
+}
+
+usize UTF8::byte_offset_of_codepoint(ReadonlyByteSpan byte_span, usize codepoint_index)
+{
+    const ReadonlyBytes bytes = byte_span.elements();
+    const usize byte_count = byte_span.count();
+    usize remaining_codepoint_count = codepoint_index;
+    usize offset = 0;
+
+#if AT_ARCH_X86_64
+    // Skip whole chunks of 64 bytes as long as the codepoint doesn't start in them.
+    for (; offset + 64 <= byte_count; offset += 64) {
+        __m128i lane_counters = _mm_setzero_si128();
+        for (usize block_offset = 0; block_offset < 64; block_offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset + block_offset));
+            lane_counters = _mm_sub_epi8(lane_counters, find_continuation_bytes(block));
+        }
+
+        const usize chunk_codepoint_count = 64 - horizontal_byte_sum(lane_counters);
+        if (chunk_codepoint_count > remaining_codepoint_count) {
+            break;
+        }
+        remaining_codepoint_count -= chunk_codepoint_count;
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        if (!is_continuation_byte(bytes[offset])) {
+            if (remaining_codepoint_count == 0) {
+                return offset;
+            }
+            --remaining_codepoint_count;
+        }
+    }
+
+    // The index is one past the last codepoint, which is the end of the byte sequence.
+    if (remaining_codepoint_count == 0) {
+        return byte_count;
+    }
+
+    return invalid_size;
+}
+
+//
+// UTF-16 and UTF-32 transcoding.
+// When converting to UTF-8, blocks of code units from the Basic Multilingual Plane are encoded four at a time: each
+// code unit is expanded to its (one, two or three) UTF-8 bytes in a 32-bit lane and the unused bytes are removed using
+// a shuffle, whose mask is selected by the widths of the code units. When converting from UTF-8, blocks that contain
+// only one and two byte sequences are decoded eight bytes at a time, in a similar manner: each byte is combined with
+// the following one and the lanes that correspond to continuation bytes are removed. Runs of ASCII characters are
+// converted sixteen at a time. Everything else (surrogate pairs, three and four byte sequences) is transcoded by the
+// scalar loops, one codepoint at a time.
+//
+
+NODISCARD ALWAYS_INLINE static bool is_high_surrogate(u32 code_unit)
+{
+    return 0xD800 <= code_unit && code_unit <= 0xDBFF;
+}
+
+NODISCARD ALWAYS_INLINE static bool is_low_surrogate(u32 code_unit)
+{
+    return 0xDC00 <= code_unit && code_unit <= 0xDFFF;
+}
+
+// Decodes the codepoint that starts at the given offset. The byte sequence must be valid UTF-8.
+NODISCARD ALWAYS_INLINE static u32 decode_valid_codepoint(ReadonlyBytes bytes, usize& offset)
+{
+    const u32 leading_byte = bytes[offset];
+    if (leading_byte < 0x80) {
+        offset += 1;
+        return leading_byte;
+    }
+    if (leading_byte < 0xE0) {
+        const u32 codepoint = ((leading_byte & 0x1F) << 6) | (bytes[offset + 1] & 0x3F);
+        offset += 2;
+        return codepoint;
+    }
+    if (leading_byte < 0xF0) {
+        const u32 codepoint = ((leading_byte & 0x0F) << 12) | ((bytes[offset + 1] & 0x3F) << 6) | (bytes[offset + 2] & 0x3F);
+        offset += 3;
+        return codepoint;
+    }
+
+    const u32 codepoint =
+        ((leading_byte & 0x07) << 18) | ((bytes[offset + 1] & 0x3F) << 12) | ((bytes[offset + 2] & 0x3F) << 6) | (bytes[offset + 3] & 0x3F);
+    offset += 4;
+    return codepoint;
+}
+
+// Encodes a valid codepoint as UTF-8 and returns the number of written bytes. The destination must have four bytes.
+NODISCARD ALWAYS_INLINE static usize encode_valid_codepoint(u32 codepoint, WriteonlyBytes destination)
+{
+    if (codepoint < 0x80) {
+        destination[0] = static_cast<u8>(codepoint);
+        return 1;
+    }
+    if (codepoint < 0x800) {
+        destination[0] = static_cast<u8>(0xC0 | (codepoint >> 6));
+        destination[1] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint < 0x10000) {
+        destination[0] = static_cast<u8>(0xE0 | (codepoint >> 12));
+        destination[1] = static_cast<u8>(0x80 | ((codepoint >> 6) & 0x3F));
+        destination[2] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+
+    destination[0] = static_cast<u8>(0xF0 | (codepoint >> 18));
+    destination[1] = static_cast<u8>(0x80 | ((codepoint >> 12) & 0x3F));
+    destination[2] = static_cast<u8>(0x80 | ((codepoint >> 6) & 0x3F));
+    destination[3] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+// Returns the number of written bytes, or zero if the destination is not big enough.
+NODISCARD ALWAYS_INLINE static usize encode_valid_codepoint(u32 codepoint, WriteonlyBytes destination, usize destination_capacity)
+{
+    u8 encoded_codepoint[4];
+    const usize codepoint_width = encode_valid_codepoint(codepoint, encoded_codepoint);
+    if (codepoint_width > destination_capacity) {
+        return 0;
+    }
+
+    for (usize index = 0; index < codepoint_width; ++index) {
+        destination[index] = encoded_codepoint[index];
+    }
+    return codepoint_width;
+}
+
+#if AT_ARCH_X86_64
+
+//
+// Shuffle masks that compact four code units (from the Basic Multilingual Plane), each expanded to a 32-bit lane that
+// contains its UTF-8 bytes, by removing the unused bytes of each lane. The table is indexed by two bit masks: the low
+// four bits are set for the code units that are bigger than 0x7F and the high four bits for those bigger than 0x7FF.
+//
+struct UTF8EncodeShuffleTable {
+    u8 shuffle_masks[256][16];
+    u8 byte_counts[256];
+
+    constexpr UTF8EncodeShuffleTable()
+        : shuffle_masks()
+        , byte_counts()
+    {
+        for (usize mask_index = 0; mask_index < 256; ++mask_index) {
+            usize byte_count = 0;
+            for (usize lane_index = 0; lane_index < 4; ++lane_index) {
+                const usize lane_width = 1 + ((mask_index >> lane_index) & 1) + ((mask_index >> (lane_index + 4)) & 1);
+                for (usize byte_index = 0; byte_index < lane_width; ++byte_index) {
+                    shuffle_masks[mask_index][byte_count++] = static_cast<u8>(4 * lane_index + byte_index);
+                }
+            }
+            byte_counts[mask_index] = static_cast<u8>(byte_count);
+            for (; byte_count < 16; ++byte_count) {
+                // The most significant bit being set makes the shuffle write a zero.
+                shuffle_masks[mask_index][byte_count] = 0x80;
+            }
+        }
+    }
+};
+
+//
+// Shuffle masks that compact eight 16-bit lanes by removing the lanes that correspond to continuation bytes.
+// The table is indexed by a bit mask, where bit 'i' is set if the lane 'i' must be kept.
+//
+struct UTF8DecodeShuffleTable {
+    u8 shuffle_masks[256][16];
+    u8 lane_counts[256];
+
+    constexpr UTF8DecodeShuffleTable()
+        : shuffle_masks()
+        , lane_counts()
+    {
+        for (usize mask_index = 0; mask_index < 256; ++mask_index) {
+            usize byte_count = 0;
+            for (usize lane_index = 0; lane_index < 8; ++lane_index) {
+                if (mask_index & (1 << lane_index)) {
+                    shuffle_masks[mask_index][byte_count++] = static_cast<u8>(2 * lane_index);
+                    shuffle_masks[mask_index][byte_count++] = static_cast<u8>(2 * lane_index + 1);
+                }
+            }
+            lane_counts[mask_index] = static_cast<u8>(byte_count / 2);
+            for (; byte_count < 16; ++byte_count) {
+                shuffle_masks[mask_index][byte_count] = 0x80;
+            }
+        }
+    }
+};
+
+alignas(16) static constexpr UTF8EncodeShuffleTable s_utf8_encode_shuffle_table;
+alignas(16) static constexpr UTF8DecodeShuffleTable s_utf8_decode_shuffle_table;
+
+// Encodes four code units (32-bit lanes), that must be valid codepoints smaller than U+10000, and returns the number
+// of written bytes. Sixteen bytes are always written to the destination, even if less of them are encoded bytes.
+NODISCARD AT_TARGET_SSE4_2 static ALWAYS_INLINE usize encode_four_bmp_code_units_sse(__m128i code_units, WriteonlyBytes destination)
+{
+    const __m128i is_two_bytes_or_more = _mm_cmpgt_epi32(code_units, _mm_set1_epi32(0x7F));
+    const __m128i is_three_bytes = _mm_cmpgt_epi32(code_units, _mm_set1_epi32(0x7FF));
+
+    const __m128i bits_6_to_11 = _mm_srli_epi32(code_units, 6);
+    const __m128i bits_12_to_15 = _mm_srli_epi32(code_units, 12);
+    const __m128i last_continuation_byte = _mm_or_si128(_mm_and_si128(code_units, _mm_set1_epi32(0x3F)), _mm_set1_epi32(0x80));
+    const __m128i middle_continuation_byte = _mm_or_si128(_mm_and_si128(bits_6_to_11, _mm_set1_epi32(0x3F)), _mm_set1_epi32(0x80));
+
+    const __m128i two_byte_lanes = _mm_or_si128(_mm_or_si128(bits_6_to_11, _mm_set1_epi32(0xC0)), _mm_slli_epi32(last_continuation_byte, 8));
+    const __m128i three_byte_lanes = _mm_or_si128(_mm_or_si128(bits_12_to_15, _mm_set1_epi32(0xE0)),
+                                                  _mm_or_si128(_mm_slli_epi32(middle_continuation_byte, 8), _mm_slli_epi32(last_continuation_byte, 16)));
+
+    __m128i encoded_lanes = _mm_blendv_epi8(code_units, two_byte_lanes, is_two_bytes_or_more);
+    encoded_lanes = _mm_blendv_epi8(encoded_lanes, three_byte_lanes, is_three_bytes);
+
+    const u32 mask_index = static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(is_two_bytes_or_more))) |
+                           static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(is_three_bytes))) << 4;
+    const __m128i shuffle_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8_encode_shuffle_table.shuffle_masks[mask_index]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_shuffle_epi8(encoded_lanes, shuffle_mask));
+    return s_utf8_encode_shuffle_table.byte_counts[mask_index];
+}
+
+// Encodes UTF-16 code units until a surrogate is encountered or until there are too few code units (or destination
+// bytes) left for a full block. The offsets are advanced past the encoded code units and the written bytes.
+AT_TARGET_SSE4_2 static void encode_utf16_bmp_blocks_sse(const u16* source, usize code_unit_count, usize& index, WriteonlyBytes destination,
+                                                         usize destination_capacity, usize& written_count)
+{
+    const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<i16>(0xFF80));
+    while (index + 8 <= code_unit_count && written_count + 32 <= destination_capacity) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+
+        if (_mm_testz_si128(block, non_ascii_bits)) {
+            if (index + 16 <= code_unit_count) {
+                const __m128i next_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index + 8));
+                if (_mm_testz_si128(next_block, non_ascii_bits)) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + written_count), _mm_packus_epi16(block, next_block));
+                    index += 16;
+                    written_count += 16;
+                    continue;
+                }
+            }
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + written_count), _mm_packus_epi16(block, block));
+            index += 8;
+            written_count += 8;
+            continue;
+        }
+
+        const __m128i surrogate_bits = _mm_and_si128(block, _mm_set1_epi16(static_cast<i16>(0xF800)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(surrogate_bits, _mm_set1_epi16(static_cast<i16>(0xD800)))) != 0) {
+            return;
+        }
+
+        written_count += encode_four_bmp_code_units_sse(_mm_unpacklo_epi16(block, _mm_setzero_si128()), destination + written_count);
+        written_count += encode_four_bmp_code_units_sse(_mm_unpackhi_epi16(block, _mm_setzero_si128()), destination + written_count);
+        index += 8;
+    }
+}
+
+// Same as encode_utf16_bmp_blocks_sse(), but stops at codepoints outside of the Basic Multilingual Plane as well.
+AT_TARGET_SSE4_2 static void encode_utf32_bmp_blocks_sse(const u32* source, usize code_unit_count, usize& index, WriteonlyBytes destination,
+                                                         usize destination_capacity, usize& written_count)
+{
+    while (index + 8 <= code_unit_count && written_count + 32 <= destination_capacity) {
+        const __m128i block_0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        const __m128i block_1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index + 4));
+        const __m128i combined_blocks = _mm_or_si128(block_0, block_1);
+
+        if (_mm_testz_si128(combined_blocks, _mm_set1_epi32(static_cast<i32>(0xFFFFFF80)))) {
+            const __m128i narrowed = _mm_packs_epi32(block_0, block_1);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + written_count), _mm_packus_epi16(narrowed, narrowed));
+            index += 8;
+            written_count += 8;
+            continue;
+        }
+
+        if (!_mm_testz_si128(combined_blocks, _mm_set1_epi32(static_cast<i32>(0xFFFF0000)))) {
+            return;
+        }
+        const __m128i surrogate_value = _mm_set1_epi32(0xD800);
+        const __m128i surrogate_mask = _mm_set1_epi32(0xF800);
+        const __m128i is_surrogate = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(block_0, surrogate_mask), surrogate_value),
+                                                  _mm_cmpeq_epi32(_mm_and_si128(block_1, surrogate_mask), surrogate_value));
+        if (_mm_movemask_epi8(is_surrogate) != 0) {
+            return;
+        }
+
+        written_count += encode_four_bmp_code_units_sse(block_0, destination + written_count);
+        written_count += encode_four_bmp_code_units_sse(block_1, destination + written_count);
+        index += 8;
+    }
+}
+
+// Decodes the one and two byte sequences that start in the first eight bytes of the block, and returns the number of
+// decoded codepoints (as 16-bit lanes). If the last of the eight bytes is a leading byte, its continuation byte (the
+// ninth byte of the block) is decoded as well. Returns false if the eight bytes contain longer sequences.
+NODISCARD AT_TARGET_SSE4_2 static ALWAYS_INLINE bool
+decode_one_or_two_byte_sequences_sse(__m128i block, __m128i& out_codepoints, usize& out_codepoint_count, usize& out_byte_count)
+{
+    // NOTE: Three and four byte sequences start with a byte that is bigger or equal to 0xE0.
+    const __m128i is_longer_sequence = _mm_cmpeq_epi8(_mm_subs_epu8(block, _mm_set1_epi8(static_cast<char>(0xDF))), _mm_setzero_si128());
+    if ((_mm_movemask_epi8(is_longer_sequence) & 0xFF) != 0xFF) {
+        return false;
+    }
+
+    const __m128i current_bytes = _mm_unpacklo_epi8(block, _mm_setzero_si128());
+    const __m128i next_bytes = _mm_unpacklo_epi8(_mm_srli_si128(block, 1), _mm_setzero_si128());
+    const __m128i two_byte_codepoints =
+        _mm_or_si128(_mm_slli_epi16(_mm_and_si128(current_bytes, _mm_set1_epi16(0x1F)), 6), _mm_and_si128(next_bytes, _mm_set1_epi16(0x3F)));
+    const __m128i is_ascii = _mm_cmplt_epi16(current_bytes, _mm_set1_epi16(0x80));
+    const __m128i codepoints = _mm_blendv_epi8(two_byte_codepoints, current_bytes, is_ascii);
+
+    const u32 continuation_mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmplt_epi8(block, _mm_set1_epi8(-64)))) & 0xFF;
+    const u32 keep_mask = continuation_mask ^ 0xFF;
+    const __m128i shuffle_mask = _mm_load_si128(reinterpret_cast<const __m128i*>(s_utf8_decode_shuffle_table.shuffle_masks[keep_mask]));
+
+    out_codepoints = _mm_shuffle_epi8(codepoints, shuffle_mask);
+    out_codepoint_count = s_utf8_decode_shuffle_table.lane_counts[keep_mask];
+    // The eighth byte is a leading byte if it is neither ASCII nor a continuation byte.
+    const bool last_byte_is_leading_byte = ((keep_mask >> 7) & 1) && static_cast<u8>(_mm_extract_epi8(block, 7)) >= 0x80;
+    out_byte_count = last_byte_is_leading_byte ? 9 : 8;
+    return true;
+}
+
+// Decodes UTF-8 until a three or four byte sequence is encountered or until there are too few bytes (or destination
+// code units) left for a full block. The offsets are advanced past the decoded bytes and the written code units.
+AT_TARGET_SSE4_2 static void decode_utf8_to_utf16_blocks_sse(ReadonlyBytes bytes, usize byte_count, usize& offset, u16* destination,
+                                                             usize destination_capacity, usize& written_count)
+{
+    while (offset + 16 <= byte_count && written_count + 16 <= destination_capacity) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+        if (_mm_movemask_epi8(block) == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + written_count), _mm_unpacklo_epi8(block, _mm_setzero_si128()));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + written_count + 8), _mm_unpackhi_epi8(block, _mm_setzero_si128()));
+            offset += 16;
+            written_count += 16;
+            continue;
+        }
+
+        __m128i codepoints;
+        usize codepoint_count;
+        usize decoded_byte_count;
+        if (!decode_one_or_two_byte_sequences_sse(block, codepoints, codepoint_count, decoded_byte_count)) {
+            return;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + written_count), codepoints);
+        offset += decoded_byte_count;
+        written_count += codepoint_count;
+    }
+}
+
+// Same as decode_utf8_to_utf16_blocks_sse(), but the codepoints are written as 32-bit code units.
+AT_TARGET_SSE4_2 static void decode_utf8_to_utf32_blocks_sse(ReadonlyBytes bytes, usize byte_count, usize& offset, u32* destination,
+                                                             usize destination_capacity, usize& written_count)
+{
+    while (offset + 16 <= byte_count && written_count + 16 <= destination_capacity) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+        __m128i* destination_blocks = reinterpret_cast<__m128i*>(destination + written_count);
+
+        if (_mm_movemask_epi8(block) == 0) {
+            _mm_storeu_si128(destination_blocks + 0, _mm_cvtepu8_epi32(block));
+            _mm_storeu_si128(destination_blocks + 1, _mm_cvtepu8_epi32(_mm_srli_si128(block, 4)));
+            _mm_storeu_si128(destination_blocks + 2, _mm_cvtepu8_epi32(_mm_srli_si128(block, 8)));
+            _mm_storeu_si128(destination_blocks + 3, _mm_cvtepu8_epi32(_mm_srli_si128(block, 12)));
+            offset += 16;
+            written_count += 16;
+            continue;
+        }
+
+        __m128i codepoints;
+        usize codepoint_count;
+        usize decoded_byte_count;
+        if (!decode_one_or_two_byte_sequences_sse(block, codepoints, codepoint_count, decoded_byte_count)) {
+            return;
+        }
+
+        _mm_storeu_si128(destination_blocks + 0, _mm_cvtepu16_epi32(codepoints));
+        _mm_storeu_si128(destination_blocks + 1, _mm_cvtepu16_epi32(_mm_srli_si128(codepoints, 8)));
+        offset += decoded_byte_count;
+        written_count += codepoint_count;
+    }
+}
+
+#endif // AT_ARCH_X86_64
+
+usize UTF8::to_utf16_length(ReadonlyByteSpan byte_span)
+{
+    // Codepoints outside of the Basic Multilingual Plane (encoded using four bytes) require a surrogate pair, so they
+    // count as two code units. The leading bytes of such sequences are the only bytes bigger or equal to 0xF0.
+    const ReadonlyBytes bytes = byte_span.elements();
+    const usize byte_count = byte_span.count();
+    usize continuation_byte_count = 0;
+    usize four_byte_sequence_count = 0;
+    usize offset = 0;
 
-    while (byte_offset < byte_span.count()) {
-        usize codepoint_width = bytes_to_codepoint_width(byte_span.slice(byte_offset));
+#if AT_ARCH_X86_64
+    while (offset + 16 <= byte_count) {
+        __m128i continuation_lane_counters = _mm_setzero_si128();
+        __m128i four_byte_lane_counters = _mm_setzero_si128();
+        for (usize iteration = 0; iteration < 255 && offset + 16 <= byte_count; ++iteration, offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+            const __m128i is_four_byte_sequence = _mm_cmpeq_epi8(_mm_max_epu8(block, _mm_set1_epi8(static_cast<char>(0xF0))), block);
+            continuation_lane_counters = _mm_sub_epi8(continuation_lane_counters, find_continuation_bytes(block));
+            four_byte_lane_counters = _mm_sub_epi8(four_byte_lane_counters, is_four_byte_sequence);
+        }
+        continuation_byte_count += horizontal_byte_sum(continuation_lane_counters);
+        four_byte_sequence_count += horizontal_byte_sum(four_byte_lane_counters);
+    }
+#endif // AT_ARCH_X86_64
+
+    for (; offset < byte_count; ++offset) {
+        continuation_byte_count += is_continuation_byte(bytes[offset]) ? 1 : 0;
+        four_byte_sequence_count += (bytes[offset] >= 0xF0) ? 1 : 0;
+    }
+
+    return byte_count - continuation_byte_count + four_byte_sequence_count;
+}
+
+usize UTF8::to_utf16(ReadonlyByteSpan byte_span, Span<u16> destination)
+{
+    const ReadonlyBytes bytes = byte_span.elements();
+    const usize byte_count = byte_span.count();
+    u16* destination_code_units = destination.elements();
+    const usize destination_capacity = destination.count();
+
+#if AT_ARCH_X86_64
+    const bool can_use_sse4_2 = cpu_features().has_sse4_2;
+#endif // AT_ARCH_X86_64
+
+    usize offset = 0;
+    usize written_count = 0;
+
+    while (offset < byte_count) {
+#if AT_ARCH_X86_64
+        if (can_use_sse4_2) {
+            decode_utf8_to_utf16_blocks_sse(bytes, byte_count, offset, destination_code_units, destination_capacity, written_count);
+            if (offset == byte_count) {
+                break;
+            }
+        }
+#endif // AT_ARCH_X86_64
+
+        // NOTE: The scalar loop continues as long as it encounters sequences that the vectorized path can't decode.
+        do {
+            const u32 codepoint = decode_valid_codepoint(bytes, offset);
+            if (codepoint < 0x10000) {
+                if (written_count + 1 > destination_capacity) {
+                    return invalid_size;
+                }
+                destination_code_units[written_count++] = static_cast<u16>(codepoint);
+            }
+            else {
+                if (written_count + 2 > destination_capacity) {
+                    return invalid_size;
+                }
+                destination_code_units[written_count++] = static_cast<u16>(0xD800 + ((codepoint - 0x10000) >> 10));
+                destination_code_units[written_count++] = static_cast<u16>(0xDC00 + ((codepoint - 0x10000) & 0x3FF));
+            }
+        } while (offset < byte_count && bytes[offset] >= 0xE0);
+    }
+
+    return written_count;
+}
+
+usize UTF8::to_utf32(ReadonlyByteSpan byte_span, Span<u32> destination)
+{
+    const ReadonlyBytes bytes = byte_span.elements();
+    const usize byte_count = byte_span.count();
+    u32* destination_code_units = destination.elements();
+    const usize destination_capacity = destination.count();
+
+#if AT_ARCH_X86_64
+    const bool can_use_sse4_2 = cpu_features().has_sse4_2;
+#endif // AT_ARCH_X86_64
+
+    usize offset = 0;
+    usize written_count = 0;
+
+    while (offset < byte_count) {
+#if AT_ARCH_X86_64
+        if (can_use_sse4_2) {
+            decode_utf8_to_utf32_blocks_sse(bytes, byte_count, offset, destination_code_units, destination_capacity, written_count);
+            if (offset == byte_count) {
+                break;
+            }
+        }
+#endif // AT_ARCH_X86_64
+
+        do {
+            if (written_count + 1 > destination_capacity) {
+                return invalid_size;
+            }
+            destination_code_units[written_count++] = decode_valid_codepoint(bytes, offset);
+        } while (offset < byte_count && bytes[offset] >= 0xE0);
+    }
+
+    return written_count;
+}
+
+usize UTF8::from_utf16_byte_count(Span<const u16> code_units)
+{
+    usize byte_count = 0;
+    for (usize index = 0; index < code_units.count(); ++index) {
+        const u32 code_unit = code_units.elements()[index];
+        if (is_high_surrogate(code_unit)) {
+            if (index + 1 >= code_units.count() || !is_low_surrogate(code_units.elements()[index + 1])) {
+                return invalid_size;
+            }
+            byte_count += 4;
+            ++index;
+            continue;
+        }
+        if (is_low_surrogate(code_unit)) {
+            return invalid_size;
+        }
+
+        byte_count += 1 + (code_unit >= 0x80) + (code_unit >= 0x800);
+    }
+
+    return byte_count;
+}
+
+usize UTF8::from_utf16(Span<const u16> code_units, WriteonlyByteSpan destination)
+{
+    const u16* source = code_units.elements();
+    const usize code_unit_count = code_units.count();
+    const WriteonlyBytes destination_bytes = destination.elements();
+    const usize destination_capacity = destination.count();
+
+#if AT_ARCH_X86_64
+    const bool can_use_sse4_2 = cpu_features().has_sse4_2;
+#endif // AT_ARCH_X86_64
+
+    usize index = 0;
+    usize written_count = 0;
+
+    while (index < code_unit_count) {
+#if AT_ARCH_X86_64
+        if (can_use_sse4_2) {
+            encode_utf16_bmp_blocks_sse(source, code_unit_count, index, destination_bytes, destination_capacity, written_count);
+            if (index == code_unit_count) {
+                break;
+            }
+        }
+#endif // AT_ARCH_X86_64
+
+        u32 codepoint = source[index++];
+        if (is_high_surrogate(codepoint)) {
+            if (index >= code_unit_count || !is_low_surrogate(source[index])) {
+                return invalid_size;
+            }
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (source[index++] - 0xDC00);
+        }
+        else if (is_low_surrogate(codepoint)) {
+            return invalid_size;
+        }
+
+        const usize codepoint_width = encode_valid_codepoint(codepoint, destination_bytes + written_count, destination_capacity - written_count);
         if (codepoint_width == 0) {
             return invalid_size;
         }
+        written_count += codepoint_width;
+    }
+
+    return written_count;
+}
+
+usize UTF8::from_utf32_byte_count(Span<const u32> code_units)
+{
+    usize byte_count = 0;
+    for (usize index = 0; index < code_units.count(); ++index) {
+        const u32 codepoint = code_units.elements()[index];
+        if (!is_valid_codepoint(codepoint)) {
+            return invalid_size;
+        }
+        byte_count += 1 + (codepoint >= 0x80) + (codepoint >= 0x800) + (codepoint >= 0x10000);
+    }
+
+    return byte_count;
+}
+
+usize UTF8::from_utf32(Span<const u32> code_units, WriteonlyByteSpan destination)
+{
+    const u32* source = code_units.elements();
+    const usize code_unit_count = code_units.count();
+    const WriteonlyBytes destination_bytes = destination.elements();
+    const usize destination_capacity = destination.count();
+
+#if AT_ARCH_X86_64
+    const bool can_use_sse4_2 = cpu_features().has_sse4_2;
+#endif // AT_ARCH_X86_64
+
+    usize index = 0;
+    usize written_count = 0;
+
+    while (index < code_unit_count) {
+#if AT_ARCH_X86_64
+        if (can_use_sse4_2) {
+            encode_utf32_bmp_blocks_sse(source, code_unit_count, index, destination_bytes, destination_capacity, written_count);
+            if (index == code_unit_count) {
+                break;
+            }
+        }
+#endif // AT_ARCH_X86_64
+
+        const u32 codepoint = source[index++];
+        if (!is_valid_codepoint(codepoint)) {
+            return invalid_size;
+        }
 
-        ++len;
-        byte_offset += codepoint_width;
+        const usize codepoint_width = encode_valid_codepoint(codepoint, destination_bytes + written_count, destination_capacity - written_count);
+        if (codepoint_width == 0) {
+            return invalid_size;
+        }
+        written_count += codepoint_width;
     }
 
-    return len;
+    return written_count;
 }
 
 usize UTF8::byte_count(ReadonlyBytes bytes)
@@ -189,7 +1204,9 @@ usize UTF8::byte_count(ReadonlyBytes bytes)
     }
 
     ReadonlyBytes base = bytes;
-    while (*bytes++) {};
+    while (*bytes) {
+        ++bytes;
+    }
 
     // Determining the number of bytes this way doesn't guarantee that the byte sequence
     // is valid UTF-8, so a validation must now be performed.
@@ -206,16 +1223,14 @@ usize UTF8::byte_count(ReadonlyBytes bytes)
 
 bool UTF8::check_validity(ReadonlyByteSpan byte_span)
 {
-    usize byte_offset = 0;
-    while (byte_offset < byte_span.count()) {
-        const usize codepoint_width = bytes_to_codepoint_width(byte_span.slice(byte_offset));
-        if (codepoint_width == 0) {
-            // A valid UTF-8 codepoint can't have a width of zero, so the string is not correctly encoded.
-            return false;
-        }
-        byte_offset += codepoint_width;
+    // NOTE: Short strings are validated faster by the scalar implementation, as the vectorized implementations always
+    //       process (at least) a full 64 byte chunk.
+    if (byte_span.count() < 64) {
+        return check_validity_scalar(byte_span.elements(), byte_span.count());
     }
-    return true;
+
+    static const CheckValidityFunction s_check_validity_function = select_check_validity_function();
+    return s_check_validity_function(byte_span.elements(), byte_span.count());
 }
 
 } // namespace AT
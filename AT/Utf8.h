@@ -38,6 +38,12 @@ public:
     //
     NODISCARD AT_API static usize codepoint_width(UnicodeCodepoint codepoint);
 
+    // Surrogates (U+D800 - U+DFFF) are reserved for UTF-16 and can't be encoded as UTF-8.
+    NODISCARD ALWAYS_INLINE static bool is_valid_codepoint(UnicodeCodepoint codepoint)
+    {
+        return codepoint <= 0x10FFFF && !(0xD800 <= codepoint && codepoint <= 0xDFFF);
+    }
+
 public:
     //
     // Computes the number of codepoints that the UTF-8 encoded byte sequence contains.
@@ -46,6 +52,19 @@ public:
     //
     NODISCARD AT_API static usize length(ReadonlyByteSpan byte_span);
 
+    //
+    // Computes the number of codepoints, exactly as length() does, but without validating the byte sequence, which
+    // makes it considerably faster. The byte sequence must be valid UTF-8 (for example, the bytes of a string view).
+    //
+    NODISCARD AT_API static usize count_codepoints(ReadonlyByteSpan byte_span);
+
+    //
+    // Determines the offset (in bytes) of the codepoint with the given index. If the index is equal to the number of
+    // codepoints, the byte count is returned. If the index is bigger than that, 'invalid_size' will be returned.
+    // The byte sequence must be valid UTF-8.
+    //
+    NODISCARD AT_API static usize byte_offset_of_codepoint(ReadonlyByteSpan byte_span, usize codepoint_index);
+
     //
     // Determines the number of bytes that a null-terminated UTF-8 string occupies.
     // If 'bytes' is nullptr, zero will be returned.
@@ -53,7 +72,37 @@ public:
     //
     NODISCARD AT_API static usize byte_count(ReadonlyBytes bytes);
 
+    //
+    // Checks that the byte sequence is well-formed UTF-8. Truncated sequences, invalid continuation bytes, overlong
+    // encodings, surrogates and codepoints above U+10FFFF are all rejected.
+    // The implementation is vectorized (SSE4.2 or AVX2, selected at runtime based on the CPU capabilities).
+    //
     NODISCARD AT_API static bool check_validity(ReadonlyByteSpan byte_span);
+
+public:
+    //
+    // Transcoding between UTF-8 and UTF-16/UTF-32 (in native byte order).
+    // The functions never allocate memory, the result being written to the caller-provided destination. The required
+    // destination size can be computed beforehand using the corresponding *_length() or *_byte_count() function.
+    // The number of written code units (or bytes) is returned. If the destination is not big enough, or the input is
+    // not correctly encoded, 'invalid_size' is returned and the contents of the destination are unspecified.
+    //
+
+    // The byte sequence must be valid UTF-8 (for example, the bytes of a string view).
+    NODISCARD AT_API static usize to_utf16_length(ReadonlyByteSpan byte_span);
+    NODISCARD AT_API static usize to_utf16(ReadonlyByteSpan byte_span, Span<u16> destination);
+
+    // The byte sequence must be valid UTF-8 (for example, the bytes of a string view).
+    NODISCARD ALWAYS_INLINE static usize to_utf32_length(ReadonlyByteSpan byte_span) { return count_codepoints(byte_span); }
+    NODISCARD AT_API static usize to_utf32(ReadonlyByteSpan byte_span, Span<u32> destination);
+
+    // Unpaired surrogates are considered invalid UTF-16.
+    NODISCARD AT_API static usize from_utf16_byte_count(Span<const u16> code_units);
+    NODISCARD AT_API static usize from_utf16(Span<const u16> code_units, WriteonlyByteSpan destination);
+
+    // Surrogates and values above U+10FFFF are considered invalid UTF-32.
+    NODISCARD AT_API static usize from_utf32_byte_count(Span<const u32> code_units);
+    NODISCARD AT_API static usize from_utf32(Span<const u32> code_units, WriteonlyByteSpan destination);
 };
 
 } // namespace AT
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/Algorithms.h>
+#include <AT/Utf8.h>
+#include <AT/Utf8Index.h>
+
+namespace AT {
+
+UTF8Index::UTF8Index(StringView string_view, usize checkpoint_interval)
+    : m_string_view(string_view)
+    , m_checkpoint_interval(checkpoint_interval)
+    , m_codepoint_count(0)
+{
+    AT_ASSERT(m_checkpoint_interval > 0);
+    const ReadonlyByteSpan byte_span = m_string_view.byte_span();
+
+    // The first checkpoint is always the start of the string. Each following checkpoint is found by skipping exactly
+    // one interval of codepoints, so the string is only traversed once.
+    usize checkpoint_offset = 0;
+    m_checkpoints.add(checkpoint_offset);
+
+    while (true) {
+        const usize relative_offset = UTF8::byte_offset_of_codepoint(byte_span.slice(checkpoint_offset), m_checkpoint_interval);
+        if (relative_offset == invalid_size || checkpoint_offset + relative_offset == byte_span.count()) {
+            break;
+        }
+
+        checkpoint_offset += relative_offset;
+        m_checkpoints.add(checkpoint_offset);
+    }
+
+    const usize last_interval_codepoint_count = UTF8::count_codepoints(byte_span.slice(m_checkpoints.last()));
+    m_codepoint_count = (m_checkpoints.count() - 1) * m_checkpoint_interval + last_interval_codepoint_count;
+}
+
+usize UTF8Index::byte_offset_of_codepoint(usize codepoint_index) const
+{
+    AT_ASSERT(codepoint_index <= m_codepoint_count);
+
+    const usize checkpoint_index = codepoint_index / m_checkpoint_interval;
+    if (checkpoint_index >= m_checkpoints.count()) {
+        // NOTE: Only possible when the index is the codepoint count and the last interval is full.
+        return m_string_view.byte_span().count();
+    }
+
+    const usize checkpoint_offset = m_checkpoints[checkpoint_index];
+    const usize remaining_codepoint_count = codepoint_index - checkpoint_index * m_checkpoint_interval;
+
+    const usize relative_offset = UTF8::byte_offset_of_codepoint(m_string_view.byte_span().slice(checkpoint_offset), remaining_codepoint_count);
+    AT_ASSERT(relative_offset != invalid_size);
+    return checkpoint_offset + relative_offset;
+}
+
+usize UTF8Index::codepoint_index_of_byte_offset(usize byte_offset) const
+{
+    const ReadonlyByteSpan byte_span = m_string_view.byte_span();
+    AT_ASSERT(byte_offset <= byte_span.count());
+
+    // The closest checkpoint that is not after the given offset. The first checkpoint is always zero, so one exists.
+    const usize checkpoint_index = upper_bound(m_checkpoints.span(), byte_offset) - 1;
+    const usize checkpoint_offset = m_checkpoints[checkpoint_index];
+
+    const usize codepoint_count = UTF8::count_codepoints(byte_span.slice(checkpoint_offset, byte_offset - checkpoint_offset));
+    return checkpoint_index * m_checkpoint_interval + codepoint_count;
+}
+
+StringView UTF8Index::codepoint_slice(usize codepoint_index, usize codepoint_count) const
+{
+    AT_ASSERT(codepoint_index + codepoint_count <= m_codepoint_count);
+
+    const usize begin_offset = byte_offset_of_codepoint(codepoint_index);
+    const usize end_offset = byte_offset_of_codepoint(codepoint_index + codepoint_count);
+    return m_string_view.slice(begin_offset, end_offset - begin_offset);
+}
+
+} // namespace AT
@@ -210,6 +210,27 @@ public:
         m_count += elements.count();
     }
 
+    // NOTE: All elements located at or after the given offset are shifted one position to the right.
+    template<typename... Args>
+    ALWAYS_INLINE T& emplace_at(usize offset, Args&&... args)
+    {
+        AT_ASSERT(offset <= m_count);
+        re_allocate_if_required(m_count + 1);
+
+        // Shift the elements located after the offset, starting from the last one.
+        for (usize index = m_count; index > offset; --index) {
+            new (m_elements + index) T(move(m_elements[index - 1]));
+            m_elements[index - 1].~T();
+        }
+
+        new (m_elements + offset) T(forward<Args>(args)...);
+        ++m_count;
+        return m_elements[offset];
+    }
+
+    ALWAYS_INLINE T& insert(usize offset, const T& element) { return emplace_at(offset, element); }
+    ALWAYS_INLINE T& insert(usize offset, T&& element) { return emplace_at(offset, move(element)); }
+
 public:
     ALWAYS_INLINE void remove_last()
     {
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/HashMap.h>
+#include <AT/Mutex.h>
+#include <AT/String.h>
+#include <MoonCore/EntityRegistry.h>
+
+namespace Core {
+
+//
+// The identifiers assigned so far, by type name. Only accessed the first time a module queries the identifier of a
+// component type, as the identifier is then cached by component_type_id<T>(), so the lock is never contended on the hot path.
+//
+struct ComponentTypeIDs {
+    Mutex mutex;
+    HashMap<String, ComponentTypeID> ids_by_name;
+    ComponentTypeID next_type_id { 0 };
+};
+
+static ComponentTypeIDs& component_type_ids()
+{
+    // NOTE: Created on first use, as component types can be queried during the static initialization, and never
+    //       destroyed, as component types can also be queried while the static variables are destroyed.
+    static ComponentTypeIDs* s_component_type_ids = new ComponentTypeIDs();
+    return *s_component_type_ids;
+}
+
+ComponentTypeID component_type_id_from_name(StringView type_name)
+{
+    ComponentTypeIDs& type_ids = component_type_ids();
+    MutexLocker locker(type_ids.mutex);
+
+    String type_name_string = String(type_name);
+    Optional<ComponentTypeID&> existing_type_id = type_ids.ids_by_name.get_if_exists(type_name_string);
+    if (existing_type_id.has_value()) {
+        return existing_type_id.value();
+    }
+
+    const ComponentTypeID type_id = type_ids.next_type_id++;
+    type_ids.ids_by_name.add(move(type_name_string), type_id);
+    return type_id;
+}
+
+Entity EntityRegistry::create_entity()
+{
+    u32 entity_index;
+    if (m_free_entity_indices.has_elements()) {
+        entity_index = m_free_entity_indices.last();
+        m_free_entity_indices.remove_last();
+    }
+    else {
+        AT_ASSERT(m_entity_generations.count() < static_cast<usize>(static_cast<u32>(-1)));
+        entity_index = static_cast<u32>(m_entity_generations.count());
+        m_entity_generations.add(0);
+    }
+
+    // The generation becomes odd, marking the entity as alive.
+    const u32 generation = ++m_entity_generations[entity_index];
+    return Entity(entity_index, generation);
+}
+
+void EntityRegistry::destroy_entity(Entity entity)
+{
+    AT_ASSERT(is_alive(entity));
+
+    for (OwnPtr<ComponentStorageBase>& storage : m_component_storages) {
+        if (storage.is_valid()) {
+            storage->remove_component_if_exists(entity.index());
+        }
+    }
+
+    // The generation becomes even, so all copies of the entity handle are now stale.
+    ++m_entity_generations[entity.index()];
+    m_free_entity_indices.add(entity.index());
+}
+
+} // namespace Core
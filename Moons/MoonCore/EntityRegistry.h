@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/OwnPtr.h>
+#include <AT/SlotMap.h>
+#include <AT/SparseSet.h>
+#include <AT/StringView.h>
+#include <AT/Vector.h>
+#include <MoonCore/Core.h>
+
+namespace Core {
+
+//
+// Identifier of an entity that lives in an EntityRegistry. It is a generational handle, so an entity that is destroyed
+// is detected even if its index is reused by a newer entity. Entities carry no data by themselves, all the state
+// associated with an entity is stored in components.
+//
+class Entity {
+public:
+    Entity() = default;
+
+    ALWAYS_INLINE Entity(u32 index, u32 generation)
+        : m_handle(index, generation)
+    {}
+
+public:
+    NODISCARD ALWAYS_INLINE SlotHandle handle() const { return m_handle; }
+    NODISCARD ALWAYS_INLINE u32 index() const { return m_handle.slot_index(); }
+    NODISCARD ALWAYS_INLINE u32 generation() const { return m_handle.generation(); }
+    NODISCARD ALWAYS_INLINE bool is_null() const { return m_handle.is_null(); }
+
+    NODISCARD ALWAYS_INLINE bool operator==(const Entity& other) const { return m_handle == other.m_handle; }
+    NODISCARD ALWAYS_INLINE bool operator!=(const Entity& other) const { return m_handle != other.m_handle; }
+
+private:
+    SlotHandle m_handle;
+};
+
+using ComponentTypeID = u32;
+
+// NOTE: Returns the identifier that is assigned to the type with the given name. Use component_type_id<T>() instead.
+CORE_API ComponentTypeID component_type_id_from_name(StringView type_name);
+
+//
+// Returns the identifier of the given component type, which is assigned the first time it is queried.
+// The identifiers are small, contiguous integers so they can be used to index the component storages directly.
+//
+// The identifiers are assigned by MoonCore, keyed by the name of the type, so a type has the same identifier in all
+// modules that query it (each of them caches it in its own copy of the static variable). Component types must thus
+// have unique names, which means they can't be declared in an anonymous namespace or inside a function.
+//
+template<typename T>
+NODISCARD ALWAYS_INLINE ComponentTypeID component_type_id()
+{
+    static const ComponentTypeID type_id = []() {
+        // NOTE: The signature of this function contains the fully qualified name of the component type.
+        return component_type_id_from_name(StringView::unsafe_create_from_utf8(AT_FUNCTION, sizeof(AT_FUNCTION) - 1));
+    }();
+    return type_id;
+}
+
+class ComponentStorageBase {
+    AT_MAKE_NONCOPYABLE(ComponentStorageBase);
+    AT_MAKE_NONMOVABLE(ComponentStorageBase);
+
+public:
+    ComponentStorageBase() = default;
+    virtual ~ComponentStorageBase() = default;
+
+    virtual void remove_component_if_exists(u32 entity_index) = 0;
+};
+
+template<typename T>
+class ComponentStorage final : public ComponentStorageBase {
+public:
+    ComponentStorage() = default;
+    virtual ~ComponentStorage() override = default;
+
+    virtual void remove_component_if_exists(u32 entity_index) override { m_components.remove_if_exists(entity_index); }
+
+    NODISCARD ALWAYS_INLINE SparseSet<T>& components() { return m_components; }
+
+private:
+    SparseSet<T> m_components;
+};
+
+template<typename... ComponentTypes>
+class EntityView;
+
+//
+// Owns the entities and the component storages. Each component type is stored in its own sparse set (indexed by the
+// entity index), so all components of the same type are densely packed and passes over them (such as layout, paint
+// or hit-testing) are linear scans instead of pointer chasing through an object hierarchy.
+//
+class EntityRegistry {
+    AT_MAKE_NONCOPYABLE(EntityRegistry);
+    AT_MAKE_NONMOVABLE(EntityRegistry);
+
+public:
+    EntityRegistry() = default;
+    ~EntityRegistry() = default;
+
+public:
+    NODISCARD ALWAYS_INLINE usize entity_count() const { return m_entity_generations.count() - m_free_entity_indices.count(); }
+
+    NODISCARD ALWAYS_INLINE bool is_alive(Entity entity) const
+    {
+        // NOTE: The generation of an alive entity is always odd, so a null entity is never alive.
+        if (entity.index() >= m_entity_generations.count() || !(entity.generation() & 1)) {
+            return false;
+        }
+        return m_entity_generations[entity.index()] == entity.generation();
+    }
+
+    CORE_API Entity create_entity();
+
+    // Destroys the entity and all of its components. Any copy of the entity handle becomes stale.
+    CORE_API void destroy_entity(Entity entity);
+
+    // Returns the entity that currently occupies the given index. The index must belong to an alive entity.
+    NODISCARD ALWAYS_INLINE Entity entity_at_index(u32 entity_index) const
+    {
+        const Entity entity = Entity(entity_index, m_entity_generations[entity_index]);
+        AT_ASSERT_DEBUG(is_alive(entity));
+        return entity;
+    }
+
+public:
+    template<typename T>
+    NODISCARD ALWAYS_INLINE SparseSet<T>& components()
+    {
+        const ComponentTypeID type_id = component_type_id<T>();
+        while (m_component_storages.count() <= type_id) {
+            m_component_storages.add({});
+        }
+
+        OwnPtr<ComponentStorageBase>& storage = m_component_storages[type_id];
+        if (!storage.is_valid()) {
+            storage = make_own<ComponentStorage<T>>().template as<ComponentStorageBase>();
+        }
+        return static_cast<ComponentStorage<T>&>(storage.get()).components();
+    }
+
+    template<typename T, typename... Args>
+    ALWAYS_INLINE T& add_component(Entity entity, Args&&... args)
+    {
+        AT_ASSERT(is_alive(entity));
+        return components<T>().emplace(entity.index(), forward<Args>(args)...);
+    }
+
+    template<typename T>
+    NODISCARD ALWAYS_INLINE bool has_component(Entity entity)
+    {
+        return is_alive(entity) && components<T>().contains(entity.index());
+    }
+
+    template<typename T>
+    NODISCARD ALWAYS_INLINE Optional<T&> get_component_if_exists(Entity entity)
+    {
+        if (!is_alive(entity)) {
+            return {};
+        }
+        return components<T>().get_if_exists(entity.index());
+    }
+
+    template<typename T>
+    NODISCARD ALWAYS_INLINE T& get_component(Entity entity)
+    {
+        AT_ASSERT(is_alive(entity));
+        return components<T>().at(entity.index());
+    }
+
+    template<typename T>
+    ALWAYS_INLINE void remove_component(Entity entity)
+    {
+        AT_ASSERT(is_alive(entity));
+        components<T>().remove(entity.index());
+    }
+
+    template<typename... ComponentTypes>
+    NODISCARD ALWAYS_INLINE EntityView<ComponentTypes...> view()
+    {
+        return EntityView<ComponentTypes...>(*this);
+    }
+
+private:
+    // NOTE: Indexed by the entity index. The generation is odd if the entity is alive and even if the index is free.
+    Vector<u32> m_entity_generations;
+    Vector<u32> m_free_entity_indices;
+    Vector<OwnPtr<ComponentStorageBase>> m_component_storages;
+};
+
+//
+// View over all entities that have every one of the given component types.
+// The iteration is driven by the smallest component set, which is walked linearly in its dense order, while the other
+// sets are only probed through their sparse arrays. No component is ever moved or copied by the view.
+// NOTE: Adding or removing components of the viewed types during the iteration is not allowed.
+//
+template<typename... ComponentTypes>
+class EntityView {
+    static_assert(sizeof...(ComponentTypes) > 0);
+
+public:
+    ALWAYS_INLINE explicit EntityView(EntityRegistry& registry)
+        : m_registry(registry)
+    {}
+
+    //
+    // Invokes the callback for each entity that has all the viewed components.
+    // The callback signature must be: void(Entity, ComponentTypes&...).
+    //
+    template<typename Callback>
+    ALWAYS_INLINE void for_each(Callback&& callback)
+    {
+        for_each_in_sets(callback, m_registry.components<ComponentTypes>()...);
+    }
+
+    // Returns the number of entities that have all the viewed components.
+    NODISCARD usize count()
+    {
+        usize entity_count = 0;
+        for_each([&entity_count](Entity, ComponentTypes&...) { ++entity_count; });
+        return entity_count;
+    }
+
+private:
+    template<typename Callback>
+    void for_each_in_sets(Callback& callback, SparseSet<ComponentTypes>&... component_sets)
+    {
+        const Span<const u32> key_sets[] = { component_sets.keys()... };
+        Span<const u32> smallest_key_set = key_sets[0];
+        for (const Span<const u32>& key_set : key_sets) {
+            if (key_set.count() < smallest_key_set.count()) {
+                smallest_key_set = key_set;
+            }
+        }
+
+        for (const u32 entity_index : smallest_key_set) {
+            if ((component_sets.contains(entity_index) && ...)) {
+                callback(m_registry.entity_at_index(entity_index), component_sets.values()[component_sets.dense_index_of(entity_index)]...);
+            }
+        }
+    }
+
+private:
+    EntityRegistry& m_registry;
+};
+
+} // namespace Core
+
+using Core::ComponentTypeID;
+using Core::Entity;
+using Core::EntityRegistry;
+using Core::EntityView;
@@ -3,8 +3,24 @@
  * SPDX-License-Identifier: BSD-3-Clause.
  */
 
+#include <AT/MemoryOperations.h>
 #include <MoonCore/Log.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#if AT_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <cerrno>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif // AT_PLATFORM_WINDOWS
 
 namespace Core {
 
@@ -12,9 +28,437 @@ static bool s_disable_debug_logs = false;
 static bool s_disable_warning_logs = false;
 static bool s_disable_error_logs = false;
 
+struct LogSegment {
+    const u8* bytes;
+    usize byte_count;
+};
+
+#if AT_PLATFORM_WINDOWS
+
+static void write_to_standard_output(const LogSegment* segments, usize segment_count)
+{
+    HANDLE output_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+    for (usize segment_index = 0; segment_index < segment_count; ++segment_index) {
+        DWORD written_byte_count = 0;
+        WriteFile(output_handle, segments[segment_index].bytes, static_cast<DWORD>(segments[segment_index].byte_count), &written_byte_count, nullptr);
+    }
+}
+
+#else
+
+static constexpr usize max_log_write_segment_count = 512;
+
+static void write_to_standard_output(const LogSegment* segments, usize segment_count)
+{
+    AT_ASSERT(segment_count <= max_log_write_segment_count);
+    iovec io_vectors[max_log_write_segment_count];
+    for (usize segment_index = 0; segment_index < segment_count; ++segment_index) {
+        io_vectors[segment_index].iov_base = const_cast<u8*>(segments[segment_index].bytes);
+        io_vectors[segment_index].iov_len = segments[segment_index].byte_count;
+    }
+
+    // NOTE: The kernel is allowed to write fewer bytes than requested, in which case the rest are written again.
+    iovec* remaining_io_vectors = io_vectors;
+    usize remaining_count = segment_count;
+    while (remaining_count > 0) {
+        const ssize written_byte_count = writev(STDOUT_FILENO, remaining_io_vectors, static_cast<int>(remaining_count));
+        if (written_byte_count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // NOTE: There is nowhere to report that the standard output can't be written to.
+            return;
+        }
+
+        usize skipped_byte_count = static_cast<usize>(written_byte_count);
+        while (remaining_count > 0 && skipped_byte_count >= remaining_io_vectors->iov_len) {
+            skipped_byte_count -= remaining_io_vectors->iov_len;
+            ++remaining_io_vectors;
+            --remaining_count;
+        }
+        if (remaining_count > 0) {
+            remaining_io_vectors->iov_base = static_cast<u8*>(remaining_io_vectors->iov_base) + skipped_byte_count;
+            remaining_io_vectors->iov_len -= skipped_byte_count;
+        }
+    }
+}
+
+#endif // AT_PLATFORM_WINDOWS
+
+//
+// The backend of the asynchronous logging mode. The threads that log copy their lines into a lock-free ring buffer
+// (with multiple producers and a single consumer), and the writer thread writes the queued lines in batches, using a
+// single system call per batch.
+//
+// Every line is stored as a record: an 8-byte header followed by the characters, padded to a multiple of 8 bytes. A
+// producer reserves its record by advancing the write position (with a compare-and-swap), copies its characters and
+// then publishes the record by storing its header. The writer consumes the published records in order, zeroes them and
+// then releases their space by advancing the read position. The characters of a record can wrap around the end of the
+// buffer, but the headers never do, as they are aligned.
+//
+class AsyncLogger {
+    AT_MAKE_NONCOPYABLE(AsyncLogger);
+    AT_MAKE_NONMOVABLE(AsyncLogger);
+
+public:
+    static constexpr usize record_header_size = sizeof(u64);
+    static constexpr usize min_buffer_byte_count = 4096;
+    static constexpr usize max_batch_record_count = 128;
+
+    // NOTE: After writing everything that is queued, the writer sleeps for this interval before checking again, so the
+    //       lines that are logged in the meantime are batched. Only when nothing was logged during the interval, the
+    //       writer waits until a thread wakes it up (which costs the thread that logs a system call).
+    static constexpr std::chrono::milliseconds writer_batch_interval { 1 };
+
+public:
+    AsyncLogger(usize buffer_byte_count, LogOverflowPolicy overflow_policy)
+        : m_buffer(new u64[buffer_byte_count / sizeof(u64)]())
+        , m_buffer_byte_count(buffer_byte_count)
+        , m_overflow_policy(overflow_policy)
+    {
+        m_writer_thread = std::thread([this] { writer_thread_main(); });
+    }
+
+    ~AsyncLogger()
+    {
+        m_stop_requested.store(true);
+        wake_writer();
+        m_writer_thread.join();
+        delete[] m_buffer;
+    }
+
+public:
+    void push(StringView header, StringView message);
+    void flush();
+
+    // NOTE: Only calls functions that are safe to be called from a signal handler.
+    void flush_after_crash();
+
+private:
+    NODISCARD ALWAYS_INLINE u8* buffer_bytes() { return reinterpret_cast<u8*>(m_buffer); }
+    NODISCARD ALWAYS_INLINE usize buffer_offset(u64 position) const { return static_cast<usize>(position & (m_buffer_byte_count - 1)); }
+
+    NODISCARD ALWAYS_INLINE std::atomic_ref<u64> record_header(u64 position)
+    {
+        return std::atomic_ref<u64>(m_buffer[buffer_offset(position) / sizeof(u64)]);
+    }
+
+    NODISCARD ALWAYS_INLINE static u64 record_byte_count(usize line_byte_count)
+    {
+        return (record_header_size + line_byte_count + sizeof(u64) - 1) & ~static_cast<u64>(sizeof(u64) - 1);
+    }
+
+    u64 copy_to_buffer(u64 position, ReadonlyByteSpan bytes);
+    void zero_buffer(u64 begin_position, u64 end_position);
+
+    void wake_writer();
+    void writer_thread_main();
+    usize write_published_records();
+
+private:
+    // NOTE: The positions are only ever incremented (they don't wrap around) and are accessed by different threads, so
+    //       they are kept in different cache lines.
+    alignas(cache_line_size) std::atomic<u64> m_write_position { 0 };
+    alignas(cache_line_size) std::atomic<u64> m_read_position { 0 };
+
+    alignas(cache_line_size) std::atomic<bool> m_writer_is_sleeping { false };
+    std::atomic<u32> m_writer_wake_counter { 0 };
+    std::atomic<bool> m_stop_requested { false };
+    std::atomic<bool> m_is_consuming { false };
+    std::atomic<u64> m_dropped_line_count { 0 };
+
+    u64* m_buffer;
+    usize m_buffer_byte_count;
+    LogOverflowPolicy m_overflow_policy;
+    std::thread m_writer_thread;
+};
+
+void AsyncLogger::push(StringView header, StringView message)
+{
+    const ReadonlyByteSpan header_bytes = header.byte_span();
+    ReadonlyByteSpan message_bytes = message.byte_span();
+
+    // NOTE: A line longer than the buffer could never be queued, so it is truncated instead.
+    const usize max_message_byte_count = m_buffer_byte_count - record_header_size - header_bytes.count() - 1;
+    if (message_bytes.count() > max_message_byte_count) {
+        message_bytes = message_bytes.slice(0, max_message_byte_count);
+    }
+
+    const usize line_byte_count = header_bytes.count() + message_bytes.count() + 1;
+    const u64 record_size = record_byte_count(line_byte_count);
+
+    u64 write_position = m_write_position.load(std::memory_order_relaxed);
+    while (true) {
+        const u64 read_position = m_read_position.load(std::memory_order_acquire);
+        if (write_position < read_position) {
+            // NOTE: The write position was loaded before the read position and other records were consumed since.
+            write_position = m_write_position.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (write_position + record_size - read_position > m_buffer_byte_count) {
+            wake_writer();
+            if (m_overflow_policy != LogOverflowPolicy::Block) {
+                if (m_overflow_policy == LogOverflowPolicy::Count) {
+                    m_dropped_line_count.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            }
+
+            std::this_thread::yield();
+            write_position = m_write_position.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (m_write_position.compare_exchange_weak(write_position, write_position + record_size, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    u64 character_position = write_position + record_header_size;
+    character_position = copy_to_buffer(character_position, header_bytes);
+    character_position = copy_to_buffer(character_position, message_bytes);
+    copy_to_buffer(character_position, "\n"sv.byte_span());
+
+    // NOTE: The header is never zero once it is published, as its lowest bit is always set.
+    record_header(write_position).store((static_cast<u64>(line_byte_count) << 1) | 1);
+
+    // NOTE: Both the store of the header above and the load of the flag in wake_writer() are sequentially consistent, as
+    //       are the store of the flag and the load of the header done by the writer before it sleeps. Thus, either the
+    //       writer sees the record or this thread sees that the writer sleeps, so a record is never left unwritten.
+    wake_writer();
+}
+
+void AsyncLogger::flush()
+{
+    const u64 flush_position = m_write_position.load(std::memory_order_acquire);
+    while (m_read_position.load(std::memory_order_acquire) < flush_position) {
+        wake_writer();
+        std::this_thread::yield();
+    }
+}
+
+void AsyncLogger::flush_after_crash()
+{
+    // NOTE: The writer thread might be in the middle of writing a batch, in which case the records can't be consumed
+    //       until it finishes. A thread that was interrupted by the crash while queuing its line never publishes it,
+    //       so the attempts are also limited, as the records after it can't be written.
+    constexpr usize max_attempt_count = 1 << 20;
+    for (usize attempt = 0; attempt < max_attempt_count; ++attempt) {
+        write_published_records();
+        if (m_read_position.load(std::memory_order_acquire) == m_write_position.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+u64 AsyncLogger::copy_to_buffer(u64 position, ReadonlyByteSpan bytes)
+{
+    const usize offset = buffer_offset(position);
+    const usize first_byte_count = (bytes.count() < m_buffer_byte_count - offset) ? bytes.count() : (m_buffer_byte_count - offset);
+    copy_memory(buffer_bytes() + offset, bytes.elements(), first_byte_count);
+    copy_memory(buffer_bytes(), bytes.elements() + first_byte_count, bytes.count() - first_byte_count);
+    return position + bytes.count();
+}
+
+void AsyncLogger::zero_buffer(u64 begin_position, u64 end_position)
+{
+    AT_ASSERT(end_position - begin_position <= m_buffer_byte_count);
+    const usize byte_count = static_cast<usize>(end_position - begin_position);
+    const usize offset = buffer_offset(begin_position);
+    const usize first_byte_count = (byte_count < m_buffer_byte_count - offset) ? byte_count : (m_buffer_byte_count - offset);
+    zero_memory(buffer_bytes() + offset, first_byte_count);
+    zero_memory(buffer_bytes(), byte_count - first_byte_count);
+}
+
+void AsyncLogger::wake_writer()
+{
+    // NOTE: Checked before exchanging the flag, so the threads that log don't contend for its cache line.
+    if (m_writer_is_sleeping.load() && m_writer_is_sleeping.exchange(false)) {
+        m_writer_wake_counter.fetch_add(1);
+        m_writer_wake_counter.notify_one();
+    }
+}
+
+void AsyncLogger::writer_thread_main()
+{
+    while (true) {
+        if (write_published_records() > 0) {
+            continue;
+        }
+
+        if (m_stop_requested.load()) {
+            if (m_read_position.load(std::memory_order_acquire) == m_write_position.load(std::memory_order_acquire)) {
+                return;
+            }
+            // NOTE: A record is reserved but not yet published.
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::this_thread::sleep_for(writer_batch_interval);
+        if (record_header(m_read_position.load(std::memory_order_relaxed)).load() != 0) {
+            continue;
+        }
+
+        const u32 wake_counter = m_writer_wake_counter.load();
+        m_writer_is_sleeping.store(true);
+        if (record_header(m_read_position.load(std::memory_order_relaxed)).load() != 0 || m_stop_requested.load()) {
+            m_writer_is_sleeping.store(false);
+            continue;
+        }
+        m_writer_wake_counter.wait(wake_counter);
+    }
+}
+
+usize AsyncLogger::write_published_records()
+{
+    // NOTE: The writer thread is the only consumer, except when the records are flushed after a crash.
+    if (m_is_consuming.exchange(true, std::memory_order_acquire)) {
+        return 0;
+    }
+
+    const u64 read_position = m_read_position.load(std::memory_order_relaxed);
+    u64 position = read_position;
+
+    // NOTE: Each record has at most two segments, as its characters can wrap around the end of the buffer. The last
+    //       segment is reserved for the report of the dropped lines.
+    LogSegment segments[2 * max_batch_record_count + 1];
+    usize segment_count = 0;
+    usize record_count = 0;
+
+    // NOTE: When the buffer is exactly full, the position after the last record wraps around to the header of the first
+    //       one (which is only zeroed after the batch is written), so the scan must stop after a full buffer.
+    while (record_count < max_batch_record_count && position - read_position < m_buffer_byte_count) {
+        const u64 header = record_header(position).load(std::memory_order_acquire);
+        if (header == 0) {
+            break;
+        }
+
+        const usize line_byte_count = static_cast<usize>(header >> 1);
+        const usize offset = buffer_offset(position + record_header_size);
+        const usize first_byte_count = (line_byte_count < m_buffer_byte_count - offset) ? line_byte_count : (m_buffer_byte_count - offset);
+        segments[segment_count++] = { buffer_bytes() + offset, first_byte_count };
+        if (first_byte_count < line_byte_count) {
+            segments[segment_count++] = { buffer_bytes(), line_byte_count - first_byte_count };
+        }
+
+        position += record_byte_count(line_byte_count);
+        ++record_count;
+    }
+
+    char dropped_report_buffer[128];
+    if (const u64 dropped_line_count = m_dropped_line_count.exchange(0, std::memory_order_relaxed)) {
+        const WriteonlyByteSpan dropped_report_span = { reinterpret_cast<WriteonlyBytes>(dropped_report_buffer), sizeof(dropped_report_buffer) };
+        auto result = format_to(dropped_report_span, "WARNING: {} log lines were dropped, as the log buffer was full.\n", dropped_line_count);
+        if (result.has_value() && !result.value().is_truncated()) {
+            segments[segment_count++] = { reinterpret_cast<const u8*>(dropped_report_buffer), result.value().byte_count };
+        }
+    }
+
+    if (segment_count > 0) {
+        write_to_standard_output(segments, segment_count);
+    }
+
+    if (record_count > 0) {
+        // NOTE: The space is zeroed before it is released, so the producers never see a stale header.
+        zero_buffer(read_position, position);
+        m_read_position.store(position, std::memory_order_release);
+    }
+
+    m_is_consuming.store(false, std::memory_order_release);
+    return record_count;
+}
+
+static AsyncLogger* s_async_logger = nullptr;
+
+// NOTE: The signal handlers that were installed before the crash handler, which are restored when a crash occurs.
+static constexpr int crash_signals[] = {
+    SIGABRT,
+    SIGFPE,
+    SIGILL,
+    SIGSEGV,
+#ifdef SIGBUS
+    SIGBUS,
+#endif // SIGBUS
+#ifdef SIGTRAP
+    SIGTRAP,
+#endif // SIGTRAP
+};
+static void (*s_previous_crash_signal_handlers[sizeof(crash_signals) / sizeof(crash_signals[0])])(int);
+
+static void crash_signal_handler(int signal_number)
+{
+    if (s_async_logger) {
+        s_async_logger->flush_after_crash();
+    }
+
+    // Let the previous signal handler (usually the default one, which terminates the program) handle the crash.
+    for (usize signal_index = 0; signal_index < sizeof(crash_signals) / sizeof(crash_signals[0]); ++signal_index) {
+        if (crash_signals[signal_index] == signal_number) {
+            std::signal(signal_number, s_previous_crash_signal_handlers[signal_index]);
+        }
+    }
+    std::raise(signal_number);
+}
+
+static void disable_async_logging_at_exit()
+{
+    disable_async_logging();
+}
+
+ErrorOr<void> enable_async_logging(const AsyncLogInfo& info)
+{
+    if (s_async_logger) {
+        return Error::AlreadyInitialized;
+    }
+
+    usize buffer_byte_count = AsyncLogger::min_buffer_byte_count;
+    while (buffer_byte_count < info.buffer_byte_count) {
+        buffer_byte_count <<= 1;
+    }
+
+    // NOTE: The lines that were already written using the standard library must not be written after the queued ones.
+    fflush(stdout);
+    s_async_logger = new AsyncLogger(buffer_byte_count, info.overflow_policy);
+
+    static bool s_are_exit_handlers_installed = false;
+    if (!s_are_exit_handlers_installed) {
+        s_are_exit_handlers_installed = true;
+        std::atexit(disable_async_logging_at_exit);
+        for (usize signal_index = 0; signal_index < sizeof(crash_signals) / sizeof(crash_signals[0]); ++signal_index) {
+            s_previous_crash_signal_handlers[signal_index] = std::signal(crash_signals[signal_index], crash_signal_handler);
+        }
+    }
+
+    return {};
+}
+
+void disable_async_logging()
+{
+    if (s_async_logger) {
+        // NOTE: Destroying the logger writes all the queued lines and waits for the writer thread to finish.
+        AsyncLogger* async_logger = s_async_logger;
+        s_async_logger = nullptr;
+        delete async_logger;
+    }
+}
+
+void flush_logs()
+{
+    if (s_async_logger) {
+        s_async_logger->flush();
+    }
+}
+
 void dbgln(StringView message)
 {
     if (!s_disable_debug_logs) {
+        if (s_async_logger) {
+            s_async_logger->push({}, message);
+            return;
+        }
+
         auto message_span = message.byte_span().as<const char>();
         printf("%.*s\n", static_cast<int>(message_span.count()), message_span.elements());
     }
@@ -23,6 +467,11 @@ void dbgln(StringView message)
 void warnln(StringView message)
 {
     if (!s_disable_warning_logs) {
+        if (s_async_logger) {
+            s_async_logger->push("WARNING: "sv, message);
+            return;
+        }
+
         auto message_span = message.byte_span().as<const char>();
         // TODO: Set the color of the 'WARNING' header to yellow.
         printf("WARNING: %.*s\n", static_cast<int>(message_span.count()), message_span.elements());
@@ -32,10 +481,46 @@ void warnln(StringView message)
 void errorln(StringView message)
 {
     if (!s_disable_error_logs) {
+        if (s_async_logger) {
+            s_async_logger->push("ERROR: "sv, message);
+            return;
+        }
+
         auto message_span = message.byte_span().as<const char>();
         // TODO: Set the color of the 'ERROR' header to red.
         printf("ERROR: %.*s\n", static_cast<int>(message_span.count()), message_span.elements());
     }
 }
 
+namespace Detail {
+
+// NOTE: Log messages are formatted into a buffer on the stack, so only messages longer than it allocate memory.
+static constexpr usize log_message_buffer_size = 512;
+
+void format_and_log(void (*log_function)(StringView), FormatStringView message, FormatArgs arguments)
+{
+    char message_buffer[log_message_buffer_size];
+    const WriteonlyByteSpan message_buffer_span = { reinterpret_cast<WriteonlyBytes>(message_buffer), sizeof(message_buffer) };
+    auto result_or_error = vformat_to(message_buffer_span, message, arguments);
+    if (!result_or_error.has_value()) {
+        // NOTE: Asserting for failing to format the message in a log would be very excessive.
+        return;
+    }
+
+    const FormatToResult& result = result_or_error.value();
+    if (!result.is_truncated()) {
+        log_function(StringView::unsafe_create_from_utf8(message_buffer, result.byte_count));
+        return;
+    }
+
+    // The message doesn't fit in the stack buffer, so it is formatted again, into a heap buffer of the exact size.
+    StringBuilder message_builder;
+    message_builder.ensure_capacity(result.byte_count);
+    if (vformat_to(message_builder, message, move(arguments)) != FormatErrorCode::Success)
+        return;
+    log_function(message_builder.view());
+}
+
+} // namespace Detail
+
 } // namespace Core
@@ -15,68 +15,88 @@ CORE_API void dbgln(StringView message);
 CORE_API void warnln(StringView message);
 CORE_API void errorln(StringView message);
 
+// What a thread that logs does when the asynchronous log buffer has no space left for its line.
+enum class LogOverflowPolicy : u8 {
+    // Wait until the writer thread frees enough space. No line is ever lost.
+    Block,
+    // Drop the line silently.
+    Drop,
+    // Drop the line, but count it. The writer thread reports how many lines were dropped once it catches up.
+    Count,
+};
+
+struct AsyncLogInfo {
+    // Rounded up to a power of two. Lines longer than the buffer are truncated.
+    usize buffer_byte_count { 1024 * 1024 };
+    LogOverflowPolicy overflow_policy { LogOverflowPolicy::Block };
+};
+
+//
+// Switches the logging functions to the asynchronous mode. Instead of writing to the standard output themselves, they
+// copy their line into a lock-free buffer, and a background thread writes the queued lines in batches. The lines that
+// are queued when the program crashes (or exits) are still written.
+//
+// Switching between the modes is not thread-safe, so it should only be done while no other thread logs (for example,
+// during the start-up or the shutdown of the application).
+//
+CORE_API ErrorOr<void> enable_async_logging(const AsyncLogInfo& info);
+
+// Writes all the queued lines, stops the writer thread and switches back to the synchronous mode.
+CORE_API void disable_async_logging();
+
+// Blocks until all the lines that were logged before the call are written. Has no effect in the synchronous mode.
+CORE_API void flush_logs();
+
+namespace Detail {
+
+// NOTE: Not a template, so all log calls share the same formatting code. See Log.cpp for how the message is formatted.
+CORE_API void format_and_log(void (*log_function)(StringView), FormatStringView message, FormatArgs arguments);
+
+} // namespace Detail
+
 template<typename... Args>
 ALWAYS_INLINE void dbgln(StringView message, Args&&... args)
 {
-    auto formatted_message_or_error = format(message, forward<Args>(args)...);
-    if (!formatted_message_or_error.has_value()) {
-        // NOTE: Asserting for failing to format the message in a log would be very excessive.
-        return;
-    }
-
-    String formatted_message = formatted_message_or_error.release_value();
-    dbgln(formatted_message.view());
+    Detail::format_and_log(dbgln, message, make_format_arguments(args...));
 }
 
 template<typename... Args>
-ALWAYS_INLINE void dbgln(const char* null_terminated_message, Args&&... args)
+ALWAYS_INLINE void dbgln(CheckedFormatString<Args...> message, Args&&... args)
 {
-    const StringView message = StringView::create_from_utf8(null_terminated_message);
-    dbgln(message, forward<Args>(args)...);
+    Detail::format_and_log(dbgln, message, make_format_arguments(args...));
 }
 
 template<typename... Args>
 ALWAYS_INLINE void warnln(StringView message, Args&&... args)
 {
-    auto formatted_message_or_error = format(message, forward<Args>(args)...);
-    if (!formatted_message_or_error.has_value()) {
-        // NOTE: Asserting for failing to format the message in a log would be very excessive.
-        return;
-    }
-
-    String formatted_message = formatted_message_or_error.release_value();
-    warnln(formatted_message.view());
+    Detail::format_and_log(warnln, message, make_format_arguments(args...));
 }
 
 template<typename... Args>
-ALWAYS_INLINE void warnln(const char* null_terminated_message, Args&&... args)
+ALWAYS_INLINE void warnln(CheckedFormatString<Args...> message, Args&&... args)
 {
-    const StringView message = StringView::create_from_utf8(null_terminated_message);
-    warnln(message, forward<Args>(args)...);
+    Detail::format_and_log(warnln, message, make_format_arguments(args...));
 }
 
 template<typename... Args>
 ALWAYS_INLINE void errorln(StringView message, Args&&... args)
 {
-    auto formatted_message_or_error = format(message, forward<Args>(args)...);
-    if (!formatted_message_or_error.has_value()) {
-        // NOTE: Asserting for failing to format the message in a log would be very excessive.
-        return;
-    }
-
-    String formatted_message = formatted_message_or_error.release_value();
-    errorln(formatted_message.view());
+    Detail::format_and_log(errorln, message, make_format_arguments(args...));
 }
 
 template<typename... Args>
-ALWAYS_INLINE void errorln(const char* null_terminated_message, Args&&... args)
+ALWAYS_INLINE void errorln(CheckedFormatString<Args...> message, Args&&... args)
 {
-    const StringView message = StringView::create_from_utf8(null_terminated_message);
-    errorln(message, forward<Args>(args)...);
+    Detail::format_and_log(errorln, message, make_format_arguments(args...));
 }
 
 } // namespace Core
 
+using Core::AsyncLogInfo;
 using Core::dbgln;
+using Core::disable_async_logging;
+using Core::enable_async_logging;
 using Core::errorln;
+using Core::flush_logs;
+using Core::LogOverflowPolicy;
 using Core::warnln;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/String.h>
+#include <AT/Utf8.h>
+#include <AT/Vector.h>
+#include <MoonCore/MappedFile.h>
+
+#if AT_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif // AT_PLATFORM_WINDOWS
+
+namespace Core {
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_bytes(other.m_bytes)
+    , m_byte_count(other.m_byte_count)
+{
+    other.m_bytes = nullptr;
+    other.m_byte_count = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    unmap();
+    m_bytes = other.m_bytes;
+    m_byte_count = other.m_byte_count;
+    other.m_bytes = nullptr;
+    other.m_byte_count = 0;
+    return *this;
+}
+
+#if AT_PLATFORM_WINDOWS
+
+ErrorOr<void> MappedFile::map(StringView file_path)
+{
+    unmap();
+
+    // The wide-char API expects the path as a null-terminated UTF-16 string.
+    const usize file_path_length = UTF8::to_utf16_length(file_path.byte_span());
+    auto wide_file_path = Vector<u16>::create_filled(file_path_length + 1);
+    if (UTF8::to_utf16(file_path.byte_span(), wide_file_path.slice(0, file_path_length)) == invalid_size) {
+        return Error::InvalidEncoding;
+    }
+
+    HANDLE file_handle = CreateFileW(reinterpret_cast<const wchar_t*>(wide_file_path.elements()),
+                                     GENERIC_READ,
+                                     FILE_SHARE_READ,
+                                     nullptr,
+                                     OPEN_EXISTING,
+                                     FILE_ATTRIBUTE_NORMAL,
+                                     nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        const DWORD error_code = GetLastError();
+        const bool not_found = (error_code == ERROR_FILE_NOT_FOUND || error_code == ERROR_PATH_NOT_FOUND);
+        return not_found ? Error::FileNotFound : Error::FileOperationFailed;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        CloseHandle(file_handle);
+        return Error::FileOperationFailed;
+    }
+
+    if (file_size.QuadPart == 0) {
+        CloseHandle(file_handle);
+        return {};
+    }
+
+    HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // NOTE: The view keeps the file mapping (and the file) alive, so the handles can be closed right away.
+    CloseHandle(file_handle);
+    if (!mapping_handle) {
+        return Error::FileOperationFailed;
+    }
+
+    void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping_handle);
+    if (!view) {
+        return Error::FileOperationFailed;
+    }
+
+    m_bytes = static_cast<ReadonlyBytes>(view);
+    m_byte_count = static_cast<usize>(file_size.QuadPart);
+    return {};
+}
+
+void MappedFile::unmap()
+{
+    if (m_bytes) {
+        UnmapViewOfFile(m_bytes);
+        m_bytes = nullptr;
+        m_byte_count = 0;
+    }
+}
+
+#else
+
+ErrorOr<void> MappedFile::map(StringView file_path)
+{
+    unmap();
+
+    // NOTE: The string is created only to obtain a null-terminated copy of the path.
+    const String null_terminated_file_path = String(file_path);
+    const int file_descriptor = open(null_terminated_file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) {
+        return (errno == ENOENT) ? Error::FileNotFound : Error::FileOperationFailed;
+    }
+
+    struct stat file_status = {};
+    if (fstat(file_descriptor, &file_status) != 0) {
+        close(file_descriptor);
+        return Error::FileOperationFailed;
+    }
+
+    if (file_status.st_size == 0) {
+        close(file_descriptor);
+        return {};
+    }
+
+    const usize file_size = static_cast<usize>(file_status.st_size);
+    void* view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    // NOTE: The mapping keeps a reference to the file, so the descriptor can be closed right away.
+    close(file_descriptor);
+    if (view == MAP_FAILED) {
+        return Error::FileOperationFailed;
+    }
+
+    m_bytes = static_cast<ReadonlyBytes>(view);
+    m_byte_count = file_size;
+    return {};
+}
+
+void MappedFile::unmap()
+{
+    if (m_bytes) {
+        munmap(const_cast<u8*>(m_bytes), m_byte_count);
+        m_bytes = nullptr;
+        m_byte_count = 0;
+    }
+}
+
+#endif // AT_PLATFORM_WINDOWS
+
+} // namespace Core
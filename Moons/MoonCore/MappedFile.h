@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Error.h>
+#include <AT/Span.h>
+#include <AT/StringView.h>
+#include <MoonCore/Core.h>
+
+namespace Core {
+
+//
+// Read-only view of the contents of a file, mapped into the address space of the process. Mapping a file doesn't
+// read it; the operating system loads the pages on demand, when they are first accessed, so even huge files are
+// mapped almost instantly. The bytes remain valid (and never move) until the file is unmapped.
+//
+class MappedFile {
+    AT_MAKE_NONCOPYABLE(MappedFile);
+
+public:
+    MappedFile() = default;
+    CORE_API ~MappedFile();
+
+    CORE_API MappedFile(MappedFile&& other) noexcept;
+    CORE_API MappedFile& operator=(MappedFile&& other) noexcept;
+
+public:
+    //
+    // Maps the file at the given path (UTF-8 encoded), unmapping the previously mapped file (if any).
+    // Returns 'FileNotFound' if the file doesn't exist and 'FileOperationFailed' if it can't be opened or mapped.
+    //
+    CORE_API ErrorOr<void> map(StringView file_path);
+    CORE_API void unmap();
+
+    NODISCARD ALWAYS_INLINE bool is_mapped() const { return (m_bytes != nullptr); }
+    NODISCARD ALWAYS_INLINE ReadonlyByteSpan byte_span() const { return ReadonlyByteSpan(m_bytes, m_byte_count); }
+
+private:
+    // NOTE: Empty files are never mapped, as zero-length mappings are not supported by all platforms.
+    ReadonlyBytes m_bytes { nullptr };
+    usize m_byte_count { 0 };
+};
+
+} // namespace Core
@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/MemoryOperations.h>
+#include <AT/StringBuilder.h>
+#include <MoonCore/TextBuffer.h>
+
+namespace Core {
+
+NODISCARD ALWAYS_INLINE static StringView piece_view(const TextPiece& piece)
+{
+    return StringView::unsafe_create_from_utf8(piece.characters, piece.byte_count);
+}
+
+NODISCARD ALWAYS_INLINE static bool is_codepoint_boundary(StringView text, usize offset)
+{
+    const ReadonlyByteSpan byte_span = text.byte_span();
+    return offset == byte_span.count() || (byte_span[offset] & 0xC0) != 0x80;
+}
+
+// Returns the offset (in the piece) of the line break with the given index. The piece must contain the line break.
+NODISCARD static usize find_line_break(StringView piece, usize line_break_index)
+{
+    usize offset = 0;
+    while (true) {
+        const usize line_break_offset = piece.slice(offset).find('\n');
+        AT_ASSERT(line_break_offset != StringView::invalid_position);
+        if (line_break_index == 0) {
+            return offset + line_break_offset;
+        }
+
+        --line_break_index;
+        offset += line_break_offset + 1;
+    }
+}
+
+TextBuffer::TextBuffer() = default;
+
+TextBuffer::TextBuffer(StringView text)
+{
+    Vector<TextPiece> pieces;
+    append_to_add_buffer(text, pieces);
+    insert_pieces(0, pieces, true);
+}
+
+TextBuffer::~TextBuffer()
+{
+    reset();
+}
+
+void TextBuffer::reset()
+{
+    destroy_subtree(m_root);
+    m_root = nullptr;
+
+    m_undo_records.clear_and_shrink();
+    m_redo_records.clear_and_shrink();
+
+    // NOTE: The history was cleared, so no piece references the add buffer anymore.
+    for (char* block : m_add_buffer_blocks) {
+        ::operator delete(block);
+    }
+    m_add_buffer_blocks.clear_and_shrink();
+    m_add_buffer_tail = nullptr;
+    m_add_buffer_remaining_byte_count = 0;
+
+    m_original_file.unmap();
+}
+
+ErrorOr<void> TextBuffer::load_from_file(StringView file_path)
+{
+    MappedFile file;
+    TRY(file.map(file_path));
+
+    reset();
+    m_original_file = move(file);
+
+    // NOTE: The pieces are cut at codepoint boundaries, so each piece is a valid view (if the file is valid UTF-8).
+    //       Finding the boundaries only reads a few bytes per piece, so the file is still loaded lazily.
+    const StringView text = StringView::unsafe_create_from_utf8(reinterpret_cast<const char*>(m_original_file.byte_span().elements()),
+                                                                m_original_file.byte_span().count());
+    usize offset = 0;
+    while (offset < text.byte_span().count()) {
+        usize piece_byte_count = text.byte_span().count() - offset;
+        if (piece_byte_count > max_piece_byte_count) {
+            piece_byte_count = max_piece_byte_count;
+            while (piece_byte_count > 1 && !is_codepoint_boundary(text, offset + piece_byte_count)) {
+                --piece_byte_count;
+            }
+        }
+
+        const TextPiece piece = { text.byte_span().as<const char>().elements() + offset, piece_byte_count };
+        m_root = merge(m_root, create_node(piece, invalid_size));
+        offset += piece_byte_count;
+    }
+
+    return {};
+}
+
+usize TextBuffer::subtree_line_break_count(Node* node)
+{
+    if (!node) {
+        return 0;
+    }
+
+    if (node->subtree_line_break_count == invalid_size) {
+        node->subtree_line_break_count =
+            subtree_line_break_count(node->left) + piece_line_break_count(node) + subtree_line_break_count(node->right);
+    }
+    return node->subtree_line_break_count;
+}
+
+usize TextBuffer::piece_line_break_count(Node* node)
+{
+    if (node->piece_line_break_count == invalid_size) {
+        node->piece_line_break_count = piece_view(node->piece).count('\n');
+    }
+    return node->piece_line_break_count;
+}
+
+void TextBuffer::update_node(Node* node)
+{
+    node->subtree_byte_count = subtree_byte_count(node->left) + node->piece.byte_count + subtree_byte_count(node->right);
+
+    const usize left_count = node->left ? node->left->subtree_line_break_count : 0;
+    const usize right_count = node->right ? node->right->subtree_line_break_count : 0;
+    const bool is_known = left_count != invalid_size && node->piece_line_break_count != invalid_size && right_count != invalid_size;
+    node->subtree_line_break_count = is_known ? (left_count + node->piece_line_break_count + right_count) : invalid_size;
+}
+
+TextBuffer::Node* TextBuffer::create_node(TextPiece piece, usize line_break_count)
+{
+    AT_ASSERT(piece.byte_count > 0);
+
+    // NOTE: The priorities are generated using xorshift64*, which is more than random enough for a treap.
+    m_priority_seed ^= m_priority_seed >> 12;
+    m_priority_seed ^= m_priority_seed << 25;
+    m_priority_seed ^= m_priority_seed >> 27;
+
+    Node* node = new Node();
+    node->piece = piece;
+    node->left = nullptr;
+    node->right = nullptr;
+    node->priority = m_priority_seed * 0x2545F4914F6CDD1D;
+    node->piece_line_break_count = line_break_count;
+    update_node(node);
+    return node;
+}
+
+void TextBuffer::destroy_subtree(Node* node)
+{
+    if (node) {
+        destroy_subtree(node->left);
+        destroy_subtree(node->right);
+        delete node;
+    }
+}
+
+//
+// The treap is a binary search tree (ordered by the position of the pieces in the document) that is also a heap with
+// respect to the random node priorities, which keeps its expected height logarithmic. Every edit is expressed using
+// two primitives, each running in O(log n):
+//   - merge(), which concatenates two treaps by interleaving their right and left spines according to the priorities.
+//   - split(), which divides a treap at a byte offset. If the offset falls inside a piece, the piece is split in two.
+//
+
+TextBuffer::Node* TextBuffer::merge(Node* left, Node* right)
+{
+    if (!left) {
+        return right;
+    }
+    if (!right) {
+        return left;
+    }
+
+    if (left->priority > right->priority) {
+        left->right = merge(left->right, right);
+        update_node(left);
+        return left;
+    }
+
+    right->left = merge(left, right->left);
+    update_node(right);
+    return right;
+}
+
+void TextBuffer::split(Node* node, usize offset, Node*& out_left, Node*& out_right)
+{
+    if (!node) {
+        out_left = nullptr;
+        out_right = nullptr;
+        return;
+    }
+
+    const usize left_byte_count = subtree_byte_count(node->left);
+    const usize piece_end_offset = left_byte_count + node->piece.byte_count;
+
+    if (offset <= left_byte_count) {
+        split(node->left, offset, out_left, node->left);
+        update_node(node);
+        out_right = node;
+        return;
+    }
+
+    if (offset >= piece_end_offset) {
+        split(node->right, offset - piece_end_offset, node->right, out_right);
+        update_node(node);
+        out_left = node;
+        return;
+    }
+
+    // The offset falls inside the piece of this node, so the piece is split. The node keeps the first part and its
+    // left subtree, while a new node is created for the second part, which is then merged with the right subtree.
+    const usize split_offset = offset - left_byte_count;
+    const TextPiece first_piece = { node->piece.characters, split_offset };
+    const TextPiece second_piece = { node->piece.characters + split_offset, node->piece.byte_count - split_offset };
+
+    usize first_line_break_count = invalid_size;
+    usize second_line_break_count = invalid_size;
+    if (node->piece_line_break_count != invalid_size) {
+        // NOTE: Only the smaller part has to be scanned, as the count of the other part can be derived from it.
+        if (first_piece.byte_count <= second_piece.byte_count) {
+            first_line_break_count = piece_view(first_piece).count('\n');
+            second_line_break_count = node->piece_line_break_count - first_line_break_count;
+        }
+        else {
+            second_line_break_count = piece_view(second_piece).count('\n');
+            first_line_break_count = node->piece_line_break_count - second_line_break_count;
+        }
+    }
+
+    Node* right_subtree = node->right;
+    node->piece = first_piece;
+    node->piece_line_break_count = first_line_break_count;
+    node->right = nullptr;
+    update_node(node);
+
+    out_left = node;
+    out_right = merge(create_node(second_piece, second_line_break_count), right_subtree);
+}
+
+void TextBuffer::append_to_add_buffer(StringView text, Vector<TextPiece>& out_pieces)
+{
+    const usize text_byte_count = text.byte_span().count();
+    if (text_byte_count == 0) {
+        return;
+    }
+
+    char* destination;
+    if (text_byte_count <= m_add_buffer_remaining_byte_count) {
+        destination = m_add_buffer_tail;
+        m_add_buffer_tail += text_byte_count;
+        m_add_buffer_remaining_byte_count -= text_byte_count;
+    }
+    else if (text_byte_count <= max_piece_byte_count) {
+        destination = static_cast<char*>(::operator new(max_piece_byte_count));
+        m_add_buffer_blocks.add(destination);
+        m_add_buffer_tail = destination + text_byte_count;
+        m_add_buffer_remaining_byte_count = max_piece_byte_count - text_byte_count;
+    }
+    else {
+        // NOTE: Big texts get a dedicated block, so the current block can still be filled by the following edits.
+        destination = static_cast<char*>(::operator new(text_byte_count));
+        m_add_buffer_blocks.add(destination);
+    }
+
+    copy_memory(destination, text.byte_span().elements(), text_byte_count);
+
+    usize offset = 0;
+    while (offset < text_byte_count) {
+        usize piece_byte_count = text_byte_count - offset;
+        if (piece_byte_count > max_piece_byte_count) {
+            piece_byte_count = max_piece_byte_count;
+            while (piece_byte_count > 1 && !is_codepoint_boundary(text, offset + piece_byte_count)) {
+                --piece_byte_count;
+            }
+        }
+
+        out_pieces.add({ destination + offset, piece_byte_count });
+        offset += piece_byte_count;
+    }
+}
+
+bool TextBuffer::try_extend_piece_ending_at(Node* node, usize offset, StringView text, usize line_break_count)
+{
+    if (!node) {
+        return false;
+    }
+
+    const usize left_byte_count = subtree_byte_count(node->left);
+    const usize piece_end_offset = left_byte_count + node->piece.byte_count;
+
+    bool was_extended = false;
+    if (offset <= left_byte_count) {
+        was_extended = try_extend_piece_ending_at(node->left, offset, text, line_break_count);
+    }
+    else if (offset > piece_end_offset) {
+        was_extended = try_extend_piece_ending_at(node->right, offset - piece_end_offset, text, line_break_count);
+    }
+    else if (offset == piece_end_offset) {
+        const usize text_byte_count = text.byte_span().count();
+        TextPiece& piece = node->piece;
+        if (piece.characters + piece.byte_count == m_add_buffer_tail && piece.byte_count + text_byte_count <= max_piece_byte_count &&
+            text_byte_count <= m_add_buffer_remaining_byte_count) {
+            piece.byte_count += text_byte_count;
+            if (node->piece_line_break_count != invalid_size) {
+                node->piece_line_break_count += line_break_count;
+            }
+            was_extended = true;
+        }
+    }
+
+    if (was_extended) {
+        // NOTE: The counts of the subtree are only updated if they are known, as the unknown counts are computed lazily.
+        node->subtree_byte_count += text.byte_span().count();
+        if (node->subtree_line_break_count != invalid_size) {
+            node->subtree_line_break_count += line_break_count;
+        }
+    }
+    return was_extended;
+}
+
+void TextBuffer::insert_pieces(usize offset, const Vector<TextPiece>& pieces, bool line_break_counts_are_known)
+{
+    Node* inserted_subtree = nullptr;
+    for (const TextPiece& piece : pieces) {
+        const usize line_break_count = line_break_counts_are_known ? piece_view(piece).count('\n') : invalid_size;
+        inserted_subtree = merge(inserted_subtree, create_node(piece, line_break_count));
+    }
+
+    Node* left;
+    Node* right;
+    split(m_root, offset, left, right);
+    m_root = merge(merge(left, inserted_subtree), right);
+}
+
+void TextBuffer::remove_range(usize offset, usize removed_byte_count, Vector<TextPiece>& out_removed_pieces)
+{
+    Node* left;
+    Node* remaining;
+    split(m_root, offset, left, remaining);
+
+    Node* removed;
+    Node* right;
+    split(remaining, removed_byte_count, removed, right);
+
+    for (StringView piece : PieceRange(removed)) {
+        out_removed_pieces.add({ piece.byte_span().as<const char>().elements(), piece.byte_span().count() });
+    }
+
+    destroy_subtree(removed);
+    m_root = merge(left, right);
+}
+
+usize TextBuffer::line_count() const
+{
+    return subtree_line_break_count(m_root) + 1;
+}
+
+usize TextBuffer::byte_offset_of_line(usize line_index) const
+{
+    AT_ASSERT(line_index < line_count());
+    if (line_index == 0) {
+        return 0;
+    }
+
+    // NOTE: The line starts after the line break with the index 'line_index - 1'.
+    usize line_break_index = line_index - 1;
+    usize base_offset = 0;
+    Node* node = m_root;
+    while (true) {
+        const usize left_line_break_count = subtree_line_break_count(node->left);
+        if (line_break_index < left_line_break_count) {
+            node = node->left;
+            continue;
+        }
+
+        line_break_index -= left_line_break_count;
+        const usize left_byte_count = subtree_byte_count(node->left);
+        const usize piece_line_breaks = piece_line_break_count(node);
+        if (line_break_index < piece_line_breaks) {
+            return base_offset + left_byte_count + find_line_break(piece_view(node->piece), line_break_index) + 1;
+        }
+
+        line_break_index -= piece_line_breaks;
+        base_offset += left_byte_count + node->piece.byte_count;
+        node = node->right;
+    }
+}
+
+usize TextBuffer::line_index_of_byte_offset(usize offset) const
+{
+    AT_ASSERT(offset <= byte_count());
+
+    usize line_index = 0;
+    Node* node = m_root;
+    while (node) {
+        const usize left_byte_count = subtree_byte_count(node->left);
+        if (offset < left_byte_count) {
+            node = node->left;
+            continue;
+        }
+
+        line_index += subtree_line_break_count(node->left);
+        offset -= left_byte_count;
+        if (offset < node->piece.byte_count) {
+            return line_index + piece_view(node->piece).slice(0, offset).count('\n');
+        }
+
+        line_index += piece_line_break_count(node);
+        offset -= node->piece.byte_count;
+        node = node->right;
+    }
+
+    return line_index;
+}
+
+char TextBuffer::byte_at(usize offset) const
+{
+    AT_ASSERT(offset < byte_count());
+
+    const Node* node = m_root;
+    while (true) {
+        const usize left_byte_count = subtree_byte_count(node->left);
+        if (offset < left_byte_count) {
+            node = node->left;
+            continue;
+        }
+
+        offset -= left_byte_count;
+        if (offset < node->piece.byte_count) {
+            return node->piece.characters[offset];
+        }
+
+        offset -= node->piece.byte_count;
+        node = node->right;
+    }
+}
+
+String TextBuffer::substring(usize offset, usize substring_byte_count) const
+{
+    AT_ASSERT(offset + substring_byte_count <= byte_count());
+
+    StringBuilder builder;
+    builder.ensure_capacity(substring_byte_count);
+
+    // NOTE: The pieces before the range are skipped by descending to the first piece of the range, remembering the
+    //       ancestors whose pieces come after it, exactly like the piece iterator does.
+    Vector<const Node*> stack;
+    const Node* node = m_root;
+    usize piece_offset = offset;
+    while (node) {
+        const usize left_byte_count = subtree_byte_count(node->left);
+        if (piece_offset < left_byte_count) {
+            stack.add(node);
+            node = node->left;
+            continue;
+        }
+
+        piece_offset -= left_byte_count;
+        if (piece_offset < node->piece.byte_count) {
+            stack.add(node);
+            break;
+        }
+
+        piece_offset -= node->piece.byte_count;
+        node = node->right;
+    }
+
+    usize remaining_byte_count = substring_byte_count;
+    while (remaining_byte_count > 0) {
+        AT_ASSERT(stack.has_elements());
+        const Node* current = stack.last();
+        stack.remove_last();
+
+        const usize available_byte_count = current->piece.byte_count - piece_offset;
+        const usize copied_byte_count = (available_byte_count < remaining_byte_count) ? available_byte_count : remaining_byte_count;
+        builder.append(piece_view(current->piece).slice(piece_offset, copied_byte_count));
+        remaining_byte_count -= copied_byte_count;
+        piece_offset = 0;
+
+        for (const Node* next = current->right; next; next = next->left) {
+            stack.add(next);
+        }
+    }
+
+    return builder.build();
+}
+
+void TextBuffer::insert(usize offset, StringView text)
+{
+    AT_ASSERT(offset <= byte_count());
+    if (text.is_empty()) {
+        return;
+    }
+
+    m_redo_records.clear();
+    EditRecord record = { offset, {}, {} };
+
+    // NOTE: When typing, each character is appended right after the previous one in the add buffer, so the piece that
+    //       ends at the insertion offset can usually be extended instead of creating a new piece.
+    const char* add_buffer_tail = m_add_buffer_tail;
+    if (try_extend_piece_ending_at(m_root, offset, text, text.count('\n'))) {
+        copy_memory(m_add_buffer_tail, text.byte_span().elements(), text.byte_span().count());
+        m_add_buffer_tail += text.byte_span().count();
+        m_add_buffer_remaining_byte_count -= text.byte_span().count();
+        record.inserted_pieces.add({ add_buffer_tail, text.byte_span().count() });
+    }
+    else {
+        append_to_add_buffer(text, record.inserted_pieces);
+        insert_pieces(offset, record.inserted_pieces, true);
+    }
+
+    m_undo_records.add(move(record));
+}
+
+void TextBuffer::erase(usize offset, usize erased_byte_count)
+{
+    AT_ASSERT(offset + erased_byte_count <= byte_count());
+    if (erased_byte_count == 0) {
+        return;
+    }
+
+    m_redo_records.clear();
+    EditRecord record = { offset, {}, {} };
+    remove_range(offset, erased_byte_count, record.removed_pieces);
+    m_undo_records.add(move(record));
+}
+
+NODISCARD static usize total_byte_count(const Vector<TextPiece>& pieces)
+{
+    usize byte_count = 0;
+    for (const TextPiece& piece : pieces) {
+        byte_count += piece.byte_count;
+    }
+    return byte_count;
+}
+
+void TextBuffer::undo()
+{
+    AT_ASSERT(can_undo());
+    EditRecord record = move(m_undo_records.last());
+    m_undo_records.remove_last();
+
+    // NOTE: The removed pieces are already stored in the record, so the pieces removed now are not needed.
+    Vector<TextPiece> inserted_pieces;
+    remove_range(record.offset, total_byte_count(record.inserted_pieces), inserted_pieces);
+    insert_pieces(record.offset, record.removed_pieces, false);
+
+    m_redo_records.add(move(record));
+}
+
+void TextBuffer::redo()
+{
+    AT_ASSERT(can_redo());
+    EditRecord record = move(m_redo_records.last());
+    m_redo_records.remove_last();
+
+    Vector<TextPiece> removed_pieces;
+    remove_range(record.offset, total_byte_count(record.removed_pieces), removed_pieces);
+    insert_pieces(record.offset, record.inserted_pieces, false);
+
+    m_undo_records.add(move(record));
+}
+
+TextBuffer::PieceIterator::PieceIterator(const Node* root)
+{
+    descend_to_leftmost_node(root);
+}
+
+TextBuffer::PieceIterator& TextBuffer::PieceIterator::operator++()
+{
+    AT_ASSERT(m_stack.has_elements());
+    const Node* node = m_stack.last();
+    m_stack.remove_last();
+    descend_to_leftmost_node(node->right);
+    return *this;
+}
+
+void TextBuffer::PieceIterator::descend_to_leftmost_node(const Node* node)
+{
+    for (; node; node = node->left) {
+        m_stack.add(node);
+    }
+}
+
+} // namespace Core
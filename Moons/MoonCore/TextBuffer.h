@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <AT/Error.h>
+#include <AT/String.h>
+#include <AT/StringView.h>
+#include <AT/Vector.h>
+#include <MoonCore/Core.h>
+#include <MoonCore/MappedFile.h>
+
+namespace Core {
+
+// A contiguous range of bytes that lives either in the original file or in the add buffer of a text buffer.
+struct TextPiece {
+    const char* characters;
+    usize byte_count;
+};
+
+//
+// Text buffer for documents that are edited interactively, implemented as a piece table. The text is never moved:
+// the original file is memory mapped and the inserted text is appended to an add buffer, which only grows. The
+// document is described by a sequence of pieces that reference these two buffers, stored in a balanced tree (a
+// treap) ordered by their position in the document. Every node caches the byte and line break counts of its subtree,
+// so both offset and line lookups are O(log n), and an edit only updates the nodes along its path.
+//
+// Loading a file doesn't read it. The line break counts are computed lazily, the first time a line lookup needs
+// them, and are then kept up to date by the edits. Each edit records the pieces it removed and inserted, so it can
+// be undone (and redone) without copying any text.
+//
+// All offsets are in bytes and, for UTF-8 text, should be codepoint boundaries. The file is not validated.
+//
+class TextBuffer {
+    AT_MAKE_NONCOPYABLE(TextBuffer);
+    AT_MAKE_NONMOVABLE(TextBuffer);
+
+public:
+    // NOTE: The original file is divided into pieces of at most this size, which bounds the cost of counting the line
+    //       breaks of a piece when it is split. It is also the size of the blocks of the add buffer.
+    static constexpr usize max_piece_byte_count = 1024 * 1024;
+
+public:
+    CORE_API TextBuffer();
+    CORE_API explicit TextBuffer(StringView text);
+    CORE_API ~TextBuffer();
+
+    //
+    // Replaces the contents of the buffer with the contents of the file at the given path. The undo history is
+    // cleared. If the file can't be mapped, the buffer is left unchanged.
+    //
+    CORE_API ErrorOr<void> load_from_file(StringView file_path);
+
+public:
+    NODISCARD ALWAYS_INLINE usize byte_count() const { return subtree_byte_count(m_root); }
+    NODISCARD ALWAYS_INLINE bool is_empty() const { return (m_root == nullptr); }
+
+    // NOTE: The number of lines is one greater than the number of line breaks ('\n'), so an empty buffer has one line.
+    NODISCARD CORE_API usize line_count() const;
+
+    // Returns the offset of the first byte of the line with the given index. The index must be less than the line count.
+    NODISCARD CORE_API usize byte_offset_of_line(usize line_index) const;
+
+    // Returns the index of the line that contains the given offset, which can be equal to the byte count.
+    NODISCARD CORE_API usize line_index_of_byte_offset(usize offset) const;
+
+    NODISCARD CORE_API char byte_at(usize offset) const;
+
+    // Copies the given range of the text into a string.
+    NODISCARD CORE_API String substring(usize offset, usize byte_count) const;
+
+public:
+    CORE_API void insert(usize offset, StringView text);
+    CORE_API void erase(usize offset, usize byte_count);
+
+    NODISCARD ALWAYS_INLINE bool can_undo() const { return m_undo_records.has_elements(); }
+    NODISCARD ALWAYS_INLINE bool can_redo() const { return m_redo_records.has_elements(); }
+
+    // Reverts the last edit (or the last undo). Any new edit clears the redo history.
+    CORE_API void undo();
+    CORE_API void redo();
+
+private:
+    struct Node {
+        TextPiece piece;
+        Node* left;
+        Node* right;
+        u64 priority;
+        usize subtree_byte_count;
+        // NOTE: Set to 'invalid_size' when the count is not known yet. A subtree count is only known if the counts
+        //       of the piece and of both children subtrees are known.
+        usize piece_line_break_count;
+        usize subtree_line_break_count;
+    };
+
+public:
+    //
+    // Iterates over the pieces of the document, in order. Each piece is a view into the original file or into the add
+    // buffer, which remains valid until the buffer is destroyed or another file is loaded (even if the piece is erased).
+    //
+    class PieceIterator {
+    public:
+        PieceIterator() = default;
+        CORE_API explicit PieceIterator(const Node* root);
+
+        NODISCARD ALWAYS_INLINE bool operator==(const PieceIterator& other) const
+        {
+            return (m_stack.is_empty() && other.m_stack.is_empty()) ||
+                   (m_stack.count() == other.m_stack.count() && m_stack.last() == other.m_stack.last());
+        }
+
+        NODISCARD ALWAYS_INLINE bool operator!=(const PieceIterator& other) const { return !(*this == other); }
+
+        NODISCARD ALWAYS_INLINE StringView operator*() const
+        {
+            const TextPiece& piece = m_stack.last()->piece;
+            return StringView::unsafe_create_from_utf8(piece.characters, piece.byte_count);
+        }
+
+        CORE_API PieceIterator& operator++();
+
+    private:
+        void descend_to_leftmost_node(const Node* node);
+
+    private:
+        // NOTE: The top of the stack is the current node, and all the other entries are the ancestors whose piece
+        //       wasn't visited yet.
+        Vector<const Node*> m_stack;
+    };
+
+    class PieceRange {
+    public:
+        ALWAYS_INLINE explicit PieceRange(const Node* root)
+            : m_root(root)
+        {}
+
+        NODISCARD ALWAYS_INLINE PieceIterator begin() const { return PieceIterator(m_root); }
+        NODISCARD ALWAYS_INLINE PieceIterator end() const { return PieceIterator(); }
+
+    private:
+        const Node* m_root;
+    };
+
+    NODISCARD ALWAYS_INLINE PieceRange pieces() const { return PieceRange(m_root); }
+
+private:
+    struct EditRecord {
+        usize offset;
+        Vector<TextPiece> removed_pieces;
+        Vector<TextPiece> inserted_pieces;
+    };
+
+    NODISCARD ALWAYS_INLINE static usize subtree_byte_count(const Node* node) { return node ? node->subtree_byte_count : 0; }
+    NODISCARD static usize subtree_line_break_count(Node* node);
+    NODISCARD static usize piece_line_break_count(Node* node);
+    static void update_node(Node* node);
+
+    NODISCARD Node* create_node(TextPiece piece, usize line_break_count);
+    static void destroy_subtree(Node* node);
+
+    NODISCARD static Node* merge(Node* left, Node* right);
+    void split(Node* node, usize offset, Node*& out_left, Node*& out_right);
+
+    void reset();
+    void append_to_add_buffer(StringView text, Vector<TextPiece>& out_pieces);
+    bool try_extend_piece_ending_at(Node* node, usize offset, StringView text, usize line_break_count);
+
+    void insert_pieces(usize offset, const Vector<TextPiece>& pieces, bool line_break_counts_are_known);
+    void remove_range(usize offset, usize byte_count, Vector<TextPiece>& out_removed_pieces);
+
+private:
+    Node* m_root { nullptr };
+    u64 m_priority_seed { 0x9E3779B97F4A7C15 };
+
+    MappedFile m_original_file;
+
+    // NOTE: The blocks are never reallocated, so the pieces that reference them remain valid.
+    Vector<char*> m_add_buffer_blocks;
+    char* m_add_buffer_tail { nullptr };
+    usize m_add_buffer_remaining_byte_count { 0 };
+
+    Vector<EditRecord> m_undo_records;
+    Vector<EditRecord> m_redo_records;
+};
+
+} // namespace Core
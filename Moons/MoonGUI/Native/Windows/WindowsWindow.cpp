@@ -3,22 +3,24 @@
  * SPDX-License-Identifier: BSD-3-Clause.
  */
 
+#include <AT/Utf8.h>
+#include <AT/Vector.h>
 #include <MoonCore/Log.h>
 #include <MoonGUI/Native/Windows/WindowsWindow.h>
 
 namespace GUI::Native {
 
-static constexpr const char* DEFAULT_WINDOW_CLASS_NAME = "MoonriseWindowClass";
+static constexpr const wchar_t* DEFAULT_WINDOW_CLASS_NAME = L"MoonriseWindowClass";
 static bool s_is_default_window_class_registered { false };
 
 static void win32_register_default_window_class()
 {
-    WNDCLASSA window_class = {};
+    WNDCLASSW window_class = {};
     window_class.lpszClassName = DEFAULT_WINDOW_CLASS_NAME;
     window_class.hInstance = GetModuleHandle(nullptr);
     window_class.lpfnWndProc = WindowsWindow::window_procedure;
 
-    RegisterClassA(&window_class);
+    RegisterClassW(&window_class);
 }
 
 WindowsWindow::WindowsWindow()
@@ -46,9 +48,17 @@ ErrorOr<void> WindowsWindow::initialize(const Info& info)
     if (info.start_maximized)
         window_style_flags |= WS_MAXIMIZE;
 
-    m_native_handle = CreateWindowA(
+    // The wide-char API expects the title as a null-terminated UTF-16 string.
+    const usize title_length = UTF8::to_utf16_length(info.title.byte_span());
+    auto title = Vector<u16>::create_filled(title_length + 1);
+    if (UTF8::to_utf16(info.title.byte_span(), title.slice(0, title_length)) == invalid_size) {
+        errorln("Failed to transcode the window title to UTF-16!");
+        return Error::InvalidEncoding;
+    }
+
+    m_native_handle = CreateWindowW(
         DEFAULT_WINDOW_CLASS_NAME,
-        "Well hello there",
+        reinterpret_cast<const wchar_t*>(title.elements()),
         window_style_flags,
         info.client_position_x,
         info.client_position_y,
@@ -83,7 +93,7 @@ LRESULT WindowsWindow::window_procedure(HWND window_handle, UINT message, WPARAM
 {
     // switch (message) {}
 
-    return DefWindowProcA(window_handle, message, w_param, l_param);
+    return DefWindowProcW(window_handle, message, w_param, l_param);
 }
 
 } // namespace GUI::Native
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/HashMap.h>
+#include <AT/String.h>
+#include <Tests/Test.h>
+#include <cstdio>
+
+using namespace AT;
+
+// NOTE: The keys are long enough to never fit in the inline buffer of a string, so each key owns a heap buffer.
+static String make_heap_sized_key(const char* prefix, u32 index)
+{
+    char buffer[128] = {};
+    const int byte_count = std::snprintf(buffer, sizeof(buffer), "%s::Component_%u<Moonrise::Transform, Moonrise::Sprite>", prefix, index);
+    return String::create_from_utf8(buffer, static_cast<usize>(byte_count));
+}
+
+static void test_growing_with_heap_sized_keys()
+{
+    // NOTE: Inserting far more keys than the initial slot count forces the table to be re-allocated multiple times,
+    //       so the keys (and their heap buffers) must survive being moved between buckets.
+    constexpr u32 key_count = 2048;
+
+    HashMap<String, u32> map;
+    for (u32 index = 0; index < key_count; ++index) {
+        String key = make_heap_sized_key("Moonrise", index);
+        EXPECT(!key.is_stored_inline());
+        map.add(move(key), index);
+    }
+
+    for (u32 index = 0; index < key_count; ++index) {
+        Optional<u32&> value = map.get_if_exists(make_heap_sized_key("Moonrise", index));
+        EXPECT(value.has_value() && *value == index);
+    }
+
+    EXPECT(!map.get_if_exists(make_heap_sized_key("Moonrise", key_count)).has_value());
+
+    // NOTE: Copying the map must duplicate the keys, not share their heap buffers with the original map.
+    HashMap<String, u32> copied_map = map;
+    map = HashMap<String, u32>();
+    for (u32 index = 0; index < key_count; ++index) {
+        Optional<u32&> value = copied_map.get_if_exists(make_heap_sized_key("Moonrise", index));
+        EXPECT(value.has_value() && *value == index);
+    }
+}
+
+static void test_growing_with_case_insensitive_heap_sized_keys()
+{
+    constexpr u32 key_count = 1024;
+
+    HashMap<String, u32, ASCIICaseInsensitiveTraits<String>> map;
+    for (u32 index = 0; index < key_count; ++index) {
+        String key = make_heap_sized_key("MoonRise::Entity", index);
+        EXPECT(!key.is_stored_inline());
+        map.add(move(key), index);
+    }
+
+    // NOTE: The lookups use keys that only differ in the case of the letters, so they must be hashed and compared
+    //       by the traits, even after the table has been re-allocated.
+    for (u32 index = 0; index < key_count; ++index) {
+        Optional<u32&> lowercase_value = map.get_if_exists(make_heap_sized_key("moonrise::entity", index));
+        EXPECT(lowercase_value.has_value() && *lowercase_value == index);
+
+        Optional<u32&> uppercase_value = map.get_if_exists(make_heap_sized_key("MOONRISE::ENTITY", index));
+        EXPECT(uppercase_value.has_value() && *uppercase_value == index);
+    }
+
+    EXPECT(!map.get_if_exists(make_heap_sized_key("MoonRise::Scene", 0)).has_value());
+}
+
+int main()
+{
+    test_growing_with_heap_sized_keys();
+    test_growing_with_case_insensitive_heap_sized_keys();
+    return Test::finish();
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#include <AT/StringBuilder.h>
+#include <Tests/Test.h>
+
+using namespace AT;
+
+static void append_repeated(StringBuilder& builder, char ascii_character, usize count)
+{
+    for (usize index = 0; index < count; ++index) {
+        builder.append(ascii_character);
+    }
+}
+
+static void test_build_adopts_mostly_used_buffer()
+{
+    StringBuilder builder;
+    builder.ensure_capacity(1024);
+    append_repeated(builder, 'a', 1000);
+
+    const String string = builder.build();
+    EXPECT(string.byte_span().count() == 1000);
+    EXPECT(string.capacity() == 1024);
+    EXPECT(builder.is_empty());
+}
+
+static void test_build_shrinks_mostly_unused_buffer()
+{
+    StringBuilder builder;
+    builder.ensure_capacity(4096);
+    append_repeated(builder, 'b', 1000);
+
+    // NOTE: Most of the heap buffer is unused, so the string must not keep it alive.
+    const String string = builder.build();
+    EXPECT(string.byte_span().count() == 1000);
+    EXPECT(string.capacity() < 2 * string.byte_span().count());
+    for (char character : string.view().byte_span().as<const char>()) {
+        EXPECT(character == 'b');
+    }
+
+    // The heap buffer is kept by the builder for reuse.
+    EXPECT(builder.is_empty());
+    EXPECT(builder.capacity() == 4096);
+}
+
+static void test_build_with_self_append()
+{
+    StringBuilder builder;
+    append_repeated(builder, 'c', StringBuilder::inline_capacity);
+    for (u32 iteration = 0; iteration < 4; ++iteration) {
+        builder.append(builder.view());
+    }
+
+    const String string = builder.build();
+    EXPECT(string.byte_span().count() == 16 * StringBuilder::inline_capacity);
+    for (char character : string.view().byte_span().as<const char>()) {
+        EXPECT(character == 'c');
+    }
+}
+
+int main()
+{
+    test_build_adopts_mostly_used_buffer();
+    test_build_shrinks_mostly_unused_buffer();
+    test_build_with_self_append();
+    return Test::finish();
+}
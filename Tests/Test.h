@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 Traian Avram. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace Test {
+
+inline int failed_check_count = 0;
+
+// Returns the exit code of the test executable, which is non-zero if any check has failed.
+inline int finish()
+{
+    if (failed_check_count > 0) {
+        std::fprintf(stderr, "%d check(s) failed.\n", failed_check_count);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace Test
+
+#define EXPECT(expression)                                                                   \
+    if (!(expression)) {                                                                     \
+        std::fprintf(stderr, "%s:%d: Check failed: %s\n", __FILE__, __LINE__, #expression); \
+        ++::Test::failed_check_count;                                                        \
+    }